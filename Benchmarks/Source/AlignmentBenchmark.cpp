@@ -42,3 +42,37 @@ static void CalculateAlignedPaddingWithHeader(benchmark::State& state)
     }
 }
 BENCHMARK(CalculateAlignedPaddingWithHeader);
+
+static void CalculateAlignedPaddingWithHeaderRuntime(benchmark::State& state)
+{
+    Memarena::UIntPtr baseAddress = 1000;
+    Memarena::Size    alignment   = 8;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(baseAddress);
+        benchmark::DoNotOptimize(alignment);
+
+        Memarena::Padding padding = Memarena::CalculateAlignedPaddingWithHeader(baseAddress, alignment, 12);
+
+        benchmark::DoNotOptimize(padding);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(CalculateAlignedPaddingWithHeaderRuntime);
+
+static void CalculateAlignedPaddingWithHeaderStatic(benchmark::State& state)
+{
+    Memarena::UIntPtr baseAddress = 1000;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(baseAddress);
+
+        Memarena::Padding padding = Memarena::CalculateAlignedPaddingWithHeader(baseAddress, Memarena::StaticAlignment<8>{}, 12);
+
+        benchmark::DoNotOptimize(padding);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(CalculateAlignedPaddingWithHeaderStatic);
@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+
+#include <Memarena/Memarena.hpp>
+
+#include "MemoryTestObjects.hpp"
+#include "Source/Allocators/PoolAllocator/PoolAllocator.hpp"
+#include "Source/Allocators/StackAllocator/StackAllocator.hpp"
+#include "Source/Policies/Policies.hpp"
+
+using namespace Memarena;
+
+// Compares tracking that is compiled out, compiled in, and switched on and off at runtime with the DynamicTracking policy
+
+constexpr StackAllocatorSettings stackUntracked = {.policy = StackAllocatorPolicy::Release};
+constexpr StackAllocatorSettings stackTracked   = {.policy = StackAllocatorPolicy::AllocationTracking | StackAllocatorPolicy::SizeTracking};
+constexpr StackAllocatorSettings stackDynamic   = {.policy = stackTracked.policy | StackAllocatorPolicy::DynamicTracking};
+
+constexpr PoolAllocatorSettings poolUntracked = {.policy = PoolAllocatorPolicy::Release};
+constexpr PoolAllocatorSettings poolTracked   = {.policy = PoolAllocatorPolicy::AllocationTracking | PoolAllocatorPolicy::SizeTracking};
+constexpr PoolAllocatorSettings poolDynamic   = {.policy = poolTracked.policy | PoolAllocatorPolicy::DynamicTracking};
+
+template <StackAllocatorSettings Settings, bool IsTrackingEnabled>
+static void StackAllocatorNewDeleteTracking(benchmark::State& state)
+{
+    StackAllocator<Settings> stackAllocator{sizeof(TestObject) * 2};
+    stackAllocator.SetTrackingEnabled(IsTrackingEnabled);
+
+    for (auto _ : state)
+    {
+        TestObject* object = stackAllocator.template NewRaw<TestObject>(1, 1.5F, 'x', false, 10.5F);
+        benchmark::DoNotOptimize(object);
+        stackAllocator.Delete(object);
+    }
+}
+
+BENCHMARK_TEMPLATE(StackAllocatorNewDeleteTracking, stackUntracked, false)->Name("StackAllocatorNewDeleteUntracked");
+BENCHMARK_TEMPLATE(StackAllocatorNewDeleteTracking, stackTracked, true)->Name("StackAllocatorNewDeleteTracked");
+BENCHMARK_TEMPLATE(StackAllocatorNewDeleteTracking, stackDynamic, false)->Name("StackAllocatorNewDeleteDynamicTrackingOff");
+BENCHMARK_TEMPLATE(StackAllocatorNewDeleteTracking, stackDynamic, true)->Name("StackAllocatorNewDeleteDynamicTrackingOn");
+
+template <PoolAllocatorSettings Settings, bool IsTrackingEnabled>
+static void PoolAllocatorAllocateDeallocateTracking(benchmark::State& state)
+{
+    PoolAllocator<Settings> poolAllocator{sizeof(TestObject), 16};
+    poolAllocator.SetTrackingEnabled(IsTrackingEnabled);
+
+    for (auto _ : state)
+    {
+        void* object = poolAllocator.Allocate();
+        benchmark::DoNotOptimize(object);
+        poolAllocator.Deallocate(object);
+    }
+}
+
+BENCHMARK_TEMPLATE(PoolAllocatorAllocateDeallocateTracking, poolUntracked, false)->Name("PoolAllocatorAllocateDeallocateUntracked");
+BENCHMARK_TEMPLATE(PoolAllocatorAllocateDeallocateTracking, poolTracked, true)->Name("PoolAllocatorAllocateDeallocateTracked");
+BENCHMARK_TEMPLATE(PoolAllocatorAllocateDeallocateTracking, poolDynamic, false)->Name("PoolAllocatorAllocateDeallocateDynamicTrackingOff");
+BENCHMARK_TEMPLATE(PoolAllocatorAllocateDeallocateTracking, poolDynamic, true)->Name("PoolAllocatorAllocateDeallocateDynamicTrackingOn");
@@ -0,0 +1,565 @@
+// Replays a trace recorded with the TraceRecorder against the allocator layouts below, and reports the throughput, peak
+// RSS and latency percentiles of each. Every recorded allocator is replayed into its own instance of the layout, in the
+// recorded order on a single thread, so runs are deterministic.
+//
+// With --advise it instead classifies the allocation sites of the trace by the lifetimes of their allocations, and
+// estimates the savings of the recommended allocator by replaying the operations of each site against it and against a
+// Mallocator.
+//
+// Usage: MemarenaReplay <trace> [--advise | mallocator|linear|pool|sizeclass...]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <windows.h>
+
+    #include <psapi.h>
+#elif defined(__linux__)
+    #include <fstream>
+#else
+    #include <sys/resource.h>
+#endif
+
+#include <Memarena/Memarena.hpp>
+
+#include "Source/LatencyTracking.hpp"
+#include "Source/LifetimeAdvisor.hpp"
+#include "Source/TraceRecorder.hpp"
+#include "Source/Utility/CycleClock.hpp"
+
+using namespace Memarena;
+using namespace Memarena::SizeLiterals;
+
+namespace
+{
+constexpr Size pageSize = 4_KiB;
+
+// The allocators of one recorded allocator, behind a common interface
+class ReplayTarget
+{
+  public:
+    ReplayTarget()                    = default;
+    ReplayTarget(const ReplayTarget&) = delete;
+    ReplayTarget(ReplayTarget&&)      = delete;
+    ReplayTarget& operator=(const ReplayTarget&) = delete;
+    ReplayTarget& operator=(ReplayTarget&&) = delete;
+    virtual ~ReplayTarget()                      = default;
+
+    virtual void* Allocate(Size size, Size alignment) = 0;
+    virtual void  Deallocate(void* ptr, Size size)    = 0;
+    // Moves the allocation to a block of the new size, copying what fits
+    virtual void* Reallocate(void* ptr, const Size oldSize, const Size newSize, const Size alignment)
+    {
+        void* newPtr = Allocate(newSize, alignment);
+        if (newPtr != nullptr && ptr != nullptr)
+        {
+            std::memcpy(newPtr, ptr, std::min(oldSize, newSize));
+            Deallocate(ptr, oldSize);
+        }
+        return newPtr;
+    }
+    // Returns true if the layout frees everything at once, rather than needing every live allocation deallocated
+    virtual bool Release() { return false; }
+};
+
+constexpr MallocatorSettings mallocatorSettings = {.policy = MallocatorPolicy::Release};
+
+class MallocatorTarget final : public ReplayTarget
+{
+  public:
+    void* Allocate(const Size size, const Size alignment) override { return m_Mallocator.Allocate(size, alignment); }
+    void  Deallocate(void* ptr, const Size /*size*/) override { m_Mallocator.Deallocate(ptr); }
+    void* Reallocate(void* ptr, const Size /*oldSize*/, const Size newSize, const Size alignment) override
+    {
+        return m_Mallocator.Reallocate(ptr, newSize, alignment);
+    }
+
+  private:
+    Mallocator<mallocatorSettings> m_Mallocator;
+};
+
+class LinearTarget final : public ReplayTarget
+{
+  public:
+    explicit LinearTarget(const Size blockSize) : m_LinearAllocator(blockSize) {}
+
+    void* Allocate(const Size size, const Size alignment) override { return m_LinearAllocator.Allocate(size, alignment); }
+    void  Deallocate(void* /*ptr*/, const Size /*size*/) override {}
+    bool  Release() override
+    {
+        m_LinearAllocator.Release();
+        return true;
+    }
+
+  private:
+    static constexpr LinearAllocatorSettings settings = {.policy = LinearAllocatorPolicy::Release | LinearAllocatorPolicy::Growable};
+
+    LinearAllocator<settings> m_LinearAllocator;
+};
+
+/**
+ * @brief Serves every size from pools. With size classes the sizes are rounded up to a power of 2, and sizes above the
+ * largest class go to a Mallocator. Without them there is a pool for every distinct size.
+ */
+class PoolTarget final : public ReplayTarget
+{
+  public:
+    // By default the pools get blocks of about 64 KiB
+    explicit PoolTarget(const bool useSizeClasses, const Size objectsPerBlock = 0)
+        : m_UseSizeClasses(useSizeClasses), m_ObjectsPerBlock(objectsPerBlock)
+    {
+    }
+
+    void* Allocate(const Size size, const Size alignment) override
+    {
+        if (m_UseSizeClasses && size > maxSizeClass)
+        {
+            return m_Mallocator.Allocate(size, alignment);
+        }
+        return GetPool(size).Allocate();
+    }
+    void Deallocate(void* ptr, const Size size) override
+    {
+        if (m_UseSizeClasses && size > maxSizeClass)
+        {
+            m_Mallocator.Deallocate(ptr);
+            return;
+        }
+        GetPool(size).Deallocate(ptr);
+    }
+
+  private:
+    static constexpr PoolAllocatorSettings settings      = {.policy = PoolAllocatorPolicy::Release | PoolAllocatorPolicy::Growable};
+    static constexpr Size                  maxSizeClass  = 32_KiB;
+    static constexpr Size                  poolBlockSize = 64_KiB;
+
+    using Pool = PoolAllocator<settings>;
+
+    Pool& GetPool(const Size size)
+    {
+        // Every chunk has to hold the pointer to the next free chunk
+        const Size objectSize = std::max<Size>(m_UseSizeClasses ? std::bit_ceil(size) : size, sizeof(void*));
+
+        std::unique_ptr<Pool>& pool = m_Pools[objectSize];
+        if (!pool)
+        {
+            const Size objectsPerBlock = m_ObjectsPerBlock != 0 ? m_ObjectsPerBlock : poolBlockSize / objectSize;
+            pool                       = std::make_unique<Pool>(objectSize, std::max<Size>(objectsPerBlock, 1));
+        }
+        return *pool;
+    }
+
+    bool                                            m_UseSizeClasses;
+    Size                                            m_ObjectsPerBlock;
+    std::unordered_map<Size, std::unique_ptr<Pool>> m_Pools;
+    Mallocator<mallocatorSettings>                  m_Mallocator;
+};
+
+// Only for traces whose frees are LIFO in every allocator
+class StackTarget final : public ReplayTarget
+{
+  public:
+    explicit StackTarget(const Size totalSize) : m_StackAllocator(totalSize) {}
+
+    void* Allocate(const Size size, const Size alignment) override { return m_StackAllocator.Allocate(size, alignment); }
+    void  Deallocate(void* ptr, const Size /*size*/) override { m_StackAllocator.Deallocate(ptr); }
+    bool  Release() override
+    {
+        m_StackAllocator.Release();
+        return true;
+    }
+
+  private:
+    static constexpr StackAllocatorSettings settings = {.policy = StackAllocatorPolicy::Release | StackAllocatorPolicy::LargeOffsets};
+
+    StackAllocator<settings> m_StackAllocator;
+};
+
+struct LiveAllocation
+{
+    void*  ptr         = nullptr;
+    Size   size        = 0;
+    UInt32 allocatorId = 0;
+};
+
+struct ReplayResult
+{
+    UInt64              operationCount = 0;
+    UInt64              elapsedCycles  = 0;
+    Size                peakRss        = 0;
+    Size                startRss       = 0;
+    std::vector<UInt64> allocateCounts;
+    std::vector<UInt64> deallocateCounts;
+};
+
+#if defined(__linux__)
+// Reads a field of /proc/self/status in bytes
+Size ReadProcessStatus(const std::string& field)
+{
+    std::ifstream status("/proc/self/status");
+    std::string   line;
+    while (std::getline(status, line))
+    {
+        if (line.starts_with(field + ":"))
+        {
+            return std::stoull(line.substr(field.size() + 1)) * 1_KiB;
+        }
+    }
+    return 0;
+}
+#endif
+
+// Starts a new peak, where the platform allows it
+void ResetPeakRss()
+{
+#if defined(__linux__)
+    std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+Size GetCurrentRss()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.WorkingSetSize;
+#elif defined(__linux__)
+    return ReadProcessStatus("VmRSS");
+#else
+    return 0;
+#endif
+}
+
+Size GetPeakRss()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.PeakWorkingSetSize;
+#elif defined(__linux__)
+    return ReadProcessStatus("VmHWM");
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    // Bytes on macOS, KiB elsewhere
+    #if defined(__APPLE__)
+    return static_cast<Size>(usage.ru_maxrss);
+    #else
+    return static_cast<Size>(usage.ru_maxrss) * 1_KiB;
+    #endif
+#endif
+}
+
+// Writes to every page, so the allocations count towards the RSS as they would in the recorded program
+void TouchPages(void* ptr, const Size size)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
+    auto* bytes = static_cast<volatile char*>(ptr);
+    for (Size offset = 0; offset < size; offset += pageSize)
+    {
+        bytes[offset] = 1;
+    }
+}
+
+// The layouts that can replay any trace
+const std::vector<std::string> layoutNames = {"mallocator", "linear", "pool", "sizeclass"};
+
+std::unique_ptr<ReplayTarget> CreateTarget(const std::string& layout, const Size largestSize)
+{
+    if (layout == "mallocator")
+    {
+        return std::make_unique<MallocatorTarget>();
+    }
+    if (layout == "linear")
+    {
+        // Leaves room for the alignment padding of the largest allocation
+        return std::make_unique<LinearTarget>(std::max<Size>(largestSize + pageSize, 1_MiB));
+    }
+    if (layout == "pool" || layout == "sizeclass")
+    {
+        return std::make_unique<PoolTarget>(layout == "sizeclass");
+    }
+    return nullptr;
+}
+
+using TargetFactory = std::function<std::unique_ptr<ReplayTarget>()>;
+
+ReplayResult Replay(const std::vector<TraceRecord>& records, const TargetFactory& createTarget)
+{
+    UInt32 lastPointerId = 0;
+    for (const TraceRecord& record : records)
+    {
+        lastPointerId = std::max(lastPointerId, record.pointerId);
+    }
+
+    ReplayResult     result;
+    LatencyHistogram allocateLatencies;
+    LatencyHistogram deallocateLatencies;
+
+    std::vector<LiveAllocation>                     allocations(lastPointerId + 1);
+    std::map<UInt32, std::unique_ptr<ReplayTarget>> targets;
+    std::unordered_map<UInt32, std::vector<UInt32>> pointerIdsByAllocator;
+
+    ResetPeakRss();
+    result.startRss = GetCurrentRss();
+
+    for (const TraceRecord& record : records)
+    {
+        std::unique_ptr<ReplayTarget>& target = targets[record.allocatorId];
+        if (!target)
+        {
+            target = createTarget();
+        }
+
+        LiveAllocation& allocation = allocations[record.pointerId];
+        const Size      alignment  = Size(1) << record.alignmentShift;
+
+        switch (record.operation)
+        {
+        case TraceOperation::Allocate:
+        {
+            const UInt64 startCycles = ReadCycleCounter();
+            void*        ptr         = target->Allocate(record.size, alignment);
+            const UInt64 cycles      = ReadCycleCounter() - startCycles;
+            allocateLatencies.Record(cycles);
+            result.elapsedCycles += cycles;
+
+            TouchPages(ptr, record.size);
+            allocation = {.ptr = ptr, .size = record.size, .allocatorId = record.allocatorId};
+            pointerIdsByAllocator[record.allocatorId].push_back(record.pointerId);
+            break;
+        }
+        case TraceOperation::Deallocate:
+        {
+            if (allocation.ptr == nullptr)
+            {
+                break;
+            }
+
+            const UInt64 startCycles = ReadCycleCounter();
+            target->Deallocate(allocation.ptr, allocation.size);
+            const UInt64 cycles = ReadCycleCounter() - startCycles;
+            deallocateLatencies.Record(cycles);
+            result.elapsedCycles += cycles;
+
+            allocation = {};
+            break;
+        }
+        case TraceOperation::Reallocate:
+        {
+            const UInt64 startCycles = ReadCycleCounter();
+            void*        ptr         = target->Reallocate(allocation.ptr, allocation.size, record.size, alignment);
+            result.elapsedCycles += ReadCycleCounter() - startCycles;
+
+            TouchPages(ptr, record.size);
+            allocation.ptr  = ptr;
+            allocation.size = record.size;
+            break;
+        }
+        case TraceOperation::Release:
+        {
+            std::vector<UInt32>& pointerIds  = pointerIdsByAllocator[record.allocatorId];
+            const UInt64         startCycles = ReadCycleCounter();
+            const bool           isReleased  = target->Release();
+            for (const UInt32 pointerId : pointerIds)
+            {
+                LiveAllocation& liveAllocation = allocations[pointerId];
+                if (liveAllocation.ptr != nullptr && !isReleased)
+                {
+                    target->Deallocate(liveAllocation.ptr, liveAllocation.size);
+                }
+                liveAllocation = {};
+            }
+            result.elapsedCycles += ReadCycleCounter() - startCycles;
+            pointerIds.clear();
+            break;
+        }
+        }
+
+        result.operationCount++;
+    }
+
+    result.peakRss          = GetPeakRss();
+    result.allocateCounts   = allocateLatencies.GetCounts();
+    result.deallocateCounts = deallocateLatencies.GetCounts();
+
+    // The live allocations are freed along with the targets
+    for (LiveAllocation& allocation : allocations)
+    {
+        if (allocation.ptr != nullptr)
+        {
+            targets[allocation.allocatorId]->Deallocate(allocation.ptr, allocation.size);
+        }
+    }
+
+    return result;
+}
+
+void PrintLatency(const char* name, const std::vector<UInt64>& counts)
+{
+    const LatencyPercentiles latency = CalculateLatencyPercentiles(counts);
+    printf("  %-10s p50 %6llu ns, p99 %6llu ns, p99.9 %6llu ns, max %8llu ns (%llu operations)\n", name,
+           static_cast<ULLInt>(latency.p50), static_cast<ULLInt>(latency.p99), static_cast<ULLInt>(latency.p999),
+           static_cast<ULLInt>(latency.max), static_cast<ULLInt>(latency.count));
+}
+
+// The operations on the allocations of one site, and the releases of its allocator
+std::vector<TraceRecord> GetSiteRecords(const std::vector<TraceRecord>& records, const AllocationSiteAdvice& advice)
+{
+    std::vector<bool>        isSitePointer;
+    std::vector<TraceRecord> siteRecords;
+    for (const TraceRecord& record : records)
+    {
+        if (record.allocatorId != advice.allocatorId)
+        {
+            continue;
+        }
+
+        if (record.operation == TraceOperation::Allocate && record.callSite == advice.callSite)
+        {
+            isSitePointer.resize(std::max<Size>(isSitePointer.size(), Size(record.pointerId) + 1));
+            isSitePointer[record.pointerId] = true;
+        }
+
+        if (record.operation == TraceOperation::Release || (record.pointerId < isSitePointer.size() && isSitePointer[record.pointerId]))
+        {
+            siteRecords.push_back(record);
+        }
+    }
+    return siteRecords;
+}
+
+std::unique_ptr<ReplayTarget> CreateRecommendedTarget(const AllocationSiteAdvice& advice)
+{
+    switch (advice.recommendedAllocator)
+    {
+    case AllocatorKind::Stack: return std::make_unique<StackTarget>(advice.totalSize);
+    case AllocatorKind::Pool: return std::make_unique<PoolTarget>(false, advice.objectsPerBlock);
+    case AllocatorKind::Linear: return std::make_unique<LinearTarget>(std::max<Size>(advice.totalSize, pageSize));
+    case AllocatorKind::Mallocator: return std::make_unique<MallocatorTarget>();
+    }
+    return nullptr;
+}
+
+double GetNanosecondsPerOperation(const ReplayResult& result)
+{
+    return static_cast<double>(CyclesToNanoseconds(result.elapsedCycles)) / static_cast<double>(std::max<UInt64>(result.operationCount, 1));
+}
+
+void PrintAdvice(const Trace& trace)
+{
+    const std::vector<AllocationSiteAdvice> advice = AnalyzeLifetimes(trace.records);
+    printf("%llu allocation sites\n", static_cast<ULLInt>(advice.size()));
+
+    for (const AllocationSiteAdvice& siteAdvice : advice)
+    {
+        const bool          hasCallSite = siteAdvice.callSite < trace.callSites.size();
+        const TraceCallSite callSite    = hasCallSite ? trace.callSites[siteAdvice.callSite] : TraceCallSite{};
+        printf("\n%s:%u (%s), allocator %u\n", callSite.fileName.empty() ? "<unknown>" : callSite.fileName.c_str(), callSite.line,
+               callSite.functionName.c_str(), siteAdvice.allocatorId);
+        printf("  %s: %llu allocations of %llu to %llu bytes, peak %llu live (%llu bytes), %llu live at the end\n",
+               GetLifetimePatternName(siteAdvice.pattern), static_cast<ULLInt>(siteAdvice.allocationCount),
+               static_cast<ULLInt>(siteAdvice.minSize), static_cast<ULLInt>(siteAdvice.maxSize),
+               static_cast<ULLInt>(siteAdvice.peakLiveCount), static_cast<ULLInt>(siteAdvice.peakLiveSize),
+               static_cast<ULLInt>(siteAdvice.liveCount));
+
+        switch (siteAdvice.recommendedAllocator)
+        {
+        case AllocatorKind::Stack:
+            printf("  Use a StackAllocator with a totalSize of %llu\n", static_cast<ULLInt>(siteAdvice.totalSize));
+            break;
+        case AllocatorKind::Pool:
+            printf("  Use a PoolAllocator with an objectSize of %llu and %llu objectsPerBlock\n",
+                   static_cast<ULLInt>(siteAdvice.objectSize), static_cast<ULLInt>(siteAdvice.objectsPerBlock));
+            break;
+        case AllocatorKind::Linear:
+            printf("  Use a LinearAllocator with a blockSize of %llu\n", static_cast<ULLInt>(siteAdvice.totalSize));
+            break;
+        case AllocatorKind::Mallocator: printf("  Keep a Mallocator\n"); break;
+        }
+
+        if (siteAdvice.recommendedAllocator == AllocatorKind::Mallocator)
+        {
+            continue;
+        }
+
+        const std::vector<TraceRecord> siteRecords = GetSiteRecords(trace.records, siteAdvice);
+        const ReplayResult             baseline    = Replay(siteRecords, [] { return std::make_unique<MallocatorTarget>(); });
+        const ReplayResult             recommended = Replay(siteRecords, [&] { return CreateRecommendedTarget(siteAdvice); });
+
+        const double baselineTime    = GetNanosecondsPerOperation(baseline);
+        const double recommendedTime = GetNanosecondsPerOperation(recommended);
+        printf("  Replayed at %.1f ns per operation, against %.1f ns with a Mallocator, saving %.0f%%\n", recommendedTime, baselineTime,
+               baselineTime > 0.0 ? (baselineTime - recommendedTime) / baselineTime * 100.0 : 0.0);
+    }
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <trace> [--advise | mallocator|linear|pool|sizeclass...]\n", argv[0]);
+        return 1;
+    }
+
+    Trace trace;
+    if (!TraceRecorder::ReadTrace(argv[1], trace))
+    {
+        fprintf(stderr, "Could not read the trace '%s'\n", argv[1]);
+        return 1;
+    }
+    const std::vector<TraceRecord>& records = trace.records;
+
+    printf("%s: %llu operations\n", argv[1], static_cast<ULLInt>(records.size()));
+
+    std::vector<std::string> layouts(argv + 2, argv + argc);
+    if (layouts.size() == 1 && layouts[0] == "--advise")
+    {
+        PrintAdvice(trace);
+        return 0;
+    }
+    if (layouts.empty())
+    {
+        layouts = layoutNames;
+    }
+
+    Size largestSize = 0;
+    for (const TraceRecord& record : records)
+    {
+        largestSize = std::max<Size>(largestSize, record.size);
+    }
+
+    for (const std::string& layout : layouts)
+    {
+        if (std::ranges::find(layoutNames, layout) == layoutNames.end())
+        {
+            fprintf(stderr, "Unknown layout '%s'\n", layout.c_str());
+            return 1;
+        }
+
+        const ReplayResult result  = Replay(records, [&] { return CreateTarget(layout, largestSize); });
+        const double       seconds = static_cast<double>(CyclesToNanoseconds(result.elapsedCycles)) / 1e9;
+
+        printf("%s\n", layout.c_str());
+        printf("  Throughput %.2f million operations per second\n", static_cast<double>(result.operationCount) / seconds / 1e6);
+        printf("  Peak RSS   %.2f MiB (%.2f MiB at the start)\n", static_cast<double>(result.peakRss) / static_cast<double>(1_MiB),
+               static_cast<double>(result.startRss) / static_cast<double>(1_MiB));
+        PrintLatency("Allocate", result.allocateCounts);
+        PrintLatency("Deallocate", result.deallocateCounts);
+    }
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+#include <Memarena/Memarena.hpp>
+
+#include "Source/Allocators/LinearAllocator/LinearAllocator.hpp"
+#include "Source/Policies/Policies.hpp"
+
+using namespace Memarena;
+using namespace Memarena::SizeLiterals;
+
+// Allocates from one LinearAllocator on several threads. Its used size only grows between releases, so nearly every
+// allocation raises the high water of the thread's statistics shard. With SizeTracking, that has to stay on the thread's own
+// shard for the tracked allocator to scale like the untracked one
+
+constexpr LinearAllocatorSettings linearUntracked = {.policy = LinearAllocatorPolicy::Multithreaded | LinearAllocatorPolicy::Growable};
+constexpr LinearAllocatorSettings linearTracked   = {.policy = linearUntracked.policy | LinearAllocatorPolicy::SizeTracking};
+
+constexpr Size allocationsPerRelease = 4096;
+
+template <LinearAllocatorSettings Settings>
+static void LinearAllocatorMultithreadedAllocate(benchmark::State& state)
+{
+    static std::unique_ptr<LinearAllocator<Settings>> linearAllocator;
+    if (state.thread_index() == 0)
+    {
+        linearAllocator = std::make_unique<LinearAllocator<Settings>>(64_KiB);
+    }
+
+    Size allocationCount = 0;
+    for (auto _ : state)
+    {
+        void* ptr = linearAllocator->Allocate(16);
+        benchmark::DoNotOptimize(ptr);
+
+        // Keeps the blocks from piling up. Releases are rare, so they do not show in the results
+        if (++allocationCount % allocationsPerRelease == 0)
+        {
+            linearAllocator->Release();
+        }
+    }
+
+    if (state.thread_index() == 0)
+    {
+        linearAllocator.reset();
+    }
+}
+
+BENCHMARK_TEMPLATE(LinearAllocatorMultithreadedAllocate, linearUntracked)
+    ->Name("LinearAllocatorMultithreadedAllocateUntracked")
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(LinearAllocatorMultithreadedAllocate, linearTracked)
+    ->Name("LinearAllocatorMultithreadedAllocateTracked")
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
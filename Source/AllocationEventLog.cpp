@@ -0,0 +1,70 @@
+#include "PCH.hpp"
+
+#include "AllocationEventLog.hpp"
+
+#include <bit>
+#include <new>
+
+namespace Memarena
+{
+
+AllocationEventLog::AllocationEventLog(const Size capacity) : m_Mask(std::bit_ceil(std::max<Size>(capacity, 1)) - 1) {}
+
+AllocationEventLog::~AllocationEventLog() { delete[] m_Slots.load(std::memory_order_relaxed); }
+
+AllocationEventLog::Slot* AllocationEventLog::CreateSlots()
+{
+    Slot* newSlots = new (std::nothrow) Slot[GetCapacity()]();
+    RETURN_VAL_IF_NULLPTR(newSlots, nullptr);
+
+    // Another thread may have created the ring in the meantime, in which case we use theirs
+    Slot* expected = nullptr;
+    if (!m_Slots.compare_exchange_strong(expected, newSlots, std::memory_order_acq_rel))
+    {
+        delete[] newSlots;
+        return expected;
+    }
+
+    return newSlots;
+}
+
+std::vector<AllocationEvent> AllocationEventLog::GetEvents() const
+{
+    const Slot* slots = m_Slots.load(std::memory_order_acquire);
+    if (slots == nullptr)
+    {
+        return {};
+    }
+
+    const UInt64 head  = m_Head.load(std::memory_order_acquire);
+    const UInt64 count = std::min<UInt64>(head, GetCapacity());
+
+    std::vector<AllocationEvent> events;
+    events.reserve(count);
+    for (UInt64 index = head - count; index < head; index++)
+    {
+        const Slot& slot = slots[index & m_Mask];
+
+        // The event is only whole if the slot held it both before and after the words were read
+        const UInt64 sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != index + 1)
+        {
+            continue;
+        }
+
+        UInt64 words[2];
+        words[0] = slot.words[0].load(std::memory_order_relaxed);
+        words[1] = slot.words[1].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+        {
+            continue;
+        }
+
+        std::memcpy(&events.emplace_back(), words, sizeof(AllocationEvent));
+    }
+
+    return events;
+}
+
+} // namespace Memarena
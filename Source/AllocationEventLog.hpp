@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "Source/Aliases.hpp"
+#include "Source/CallSite.hpp"
+#include "Source/Category.hpp"
+#include "Source/Macros.hpp"
+
+namespace Memarena
+{
+
+constexpr Size maxAllocationEventSize = (Size(1) << 31) - 1;
+
+struct AllocationEvent
+{
+    UInt64     timestamp          = 0; // Steady clock time in nanoseconds
+    UInt32     size           : 31 = 0; // Saturates at maxAllocationEventSize
+    UInt32     isDeallocation : 1  = 0; // Deallocations have no call site or category
+    CallSiteId callSite;
+    CategoryId category;
+};
+static_assert(sizeof(AllocationEvent) == 16, "AllocationEvent must stay 16 bytes");
+
+constexpr Size defaultAllocationEventLogCapacity = 4096;
+
+/**
+ * @brief A fixed-capacity ring of the most recent allocation events. Recording is lock-free and never allocates, apart
+ * from creating the ring on the first event. Once the ring is full the oldest events are overwritten.
+ *
+ * Each slot holds a sequence word next to its event. A writer marks the slot busy, writes the event, then stores the
+ * event's sequence number, so readers can tell a whole event from one that is torn or not written yet.
+ */
+class AllocationEventLog
+{
+  public:
+    AllocationEventLog() : AllocationEventLog(defaultAllocationEventLogCapacity) {}
+    /**
+     * @param capacity The number of events kept. Rounded up to a power of 2
+     */
+    explicit AllocationEventLog(Size capacity);
+    ~AllocationEventLog();
+
+    AllocationEventLog(const AllocationEventLog&) = delete;
+    AllocationEventLog(AllocationEventLog&&)      = delete;
+    AllocationEventLog& operator=(const AllocationEventLog&) = delete;
+    AllocationEventLog& operator=(AllocationEventLog&&) = delete;
+
+    inline void Record(const Size size, const CallSiteId callSite, const CategoryId category,
+                       const bool isDeallocation = false) noexcept
+    {
+        const auto            now       = std::chrono::steady_clock::now().time_since_epoch();
+        const auto            timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+        const AllocationEvent event     = {.timestamp      = static_cast<UInt64>(timestamp),
+                                           .size           = static_cast<UInt32>(std::min(size, maxAllocationEventSize)),
+                                           .isDeallocation = isDeallocation,
+                                           .callSite       = callSite,
+                                           .category       = category};
+
+        Slot* slots = m_Slots.load(std::memory_order_acquire);
+        if (slots == nullptr)
+        {
+            slots = CreateSlots();
+            RETURN_VAL_IF_NULLPTR(slots, void());
+        }
+
+        UInt64 words[2];
+        std::memcpy(words, &event, sizeof(event));
+
+        const UInt64 index = m_Head.fetch_add(1, std::memory_order_relaxed);
+        Slot&        slot  = slots[index & m_Mask];
+
+        // The event is dropped if a newer one already took the slot, or if another thread is still writing to it after
+        // the ring wrapped around
+        UInt64 sequence = slot.sequence.load(std::memory_order_relaxed);
+        do
+        {
+            if (sequence == busySequence || sequence > index)
+            {
+                return;
+            }
+        } while (!slot.sequence.compare_exchange_weak(sequence, busySequence, std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.words[0].store(words[0], std::memory_order_relaxed);
+        slot.words[1].store(words[1], std::memory_order_relaxed);
+        slot.sequence.store(index + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copies the retained events, oldest first. Events recorded while the copy is made may be missing, and the
+     * slots that are being written or have been overwritten in the meantime are skipped, so every copied event is whole.
+     */
+    [[nodiscard]] std::vector<AllocationEvent> GetEvents() const;
+
+    // The number of events recorded so far, including the ones that were overwritten
+    [[nodiscard]] inline UInt64 GetRecordedCount() const { return m_Head.load(std::memory_order_relaxed); }
+    [[nodiscard]] inline Size   GetCapacity() const { return m_Mask + 1; }
+
+  private:
+    // Marks a slot whose event is being written. Otherwise the sequence is the index of the event plus 1, or 0 if the slot
+    // was never written
+    static constexpr UInt64 busySequence = std::numeric_limits<UInt64>::max();
+
+    struct Slot
+    {
+        std::atomic<UInt64> sequence;
+        std::atomic<UInt64> words[2];
+    };
+
+    Slot* CreateSlots();
+
+    std::atomic<Slot*>  m_Slots{nullptr};
+    std::atomic<UInt64> m_Head{0};
+    Size                m_Mask;
+};
+
+} // namespace Memarena
@@ -7,45 +7,126 @@
 #include "Source/MemoryTracker.hpp"
 
 #include "Source/Assert.hpp"
+#include <atomic>
 #include <memory>
 
 namespace Memarena
 {
-Allocator::Allocator(Size totalSize, const std::string& debugName, bool isBaseAllocator)
+Allocator::Allocator(Size totalSize, const std::string& debugName, bool isBaseAllocator, bool isTracked, AllocatorId parentId)
+    : m_DebugName(debugName)
 {
-    MEMARENA_DEFAULT_ASSERT(totalSize <= std::numeric_limits<Offset>::max(),
-                            "Error: Max size of allocator cannot be more than %u! Value passed was %u.\n",
-                            std::numeric_limits<Offset>::max(), totalSize);
-
     MEMARENA_DEFAULT_ASSERT(totalSize >= 0, "Error: Max size of allocator must be >= 0! Value passed was %d", totalSize);
 
-    m_Data =
-        std::make_shared<AllocatorData>(AllocatorData{.debugName = debugName, .totalSize = totalSize, .isBaseAllocator = isBaseAllocator});
+    if (!isTracked)
+    {
+        m_Data               = GetUntrackedData();
+        m_UntrackedTotalSize = totalSize;
+        return;
+    }
+
+    static std::atomic<UInt32> nextId = 1;
+
+    m_TrackedData                  = std::make_shared<AllocatorData>();
+    m_TrackedData->debugName       = debugName;
+    m_TrackedData->id              = {nextId.fetch_add(1, std::memory_order_relaxed)};
+    m_TrackedData->parentId        = parentId;
+    m_TrackedData->isBaseAllocator = isBaseAllocator;
+    m_Data                         = m_TrackedData.get();
+
+    m_Data->statistics.IncreaseTotalSize(totalSize);
+
+    MemoryTracker::RegisterAllocator(m_TrackedData);
+    // After registering, so that a global switch made in between is not missed
+    m_Data->isTrackingEnabled.store(MemoryTracker::IsTrackingEnabled());
+}
+
+Allocator::~Allocator()
+{
+    if (m_TrackedData)
+    {
+        if (m_TrackedData->liveAllocations.GetLiveCount() > 0)
+        {
+            PrintLeakReport(m_TrackedData->debugName, m_TrackedData->liveAllocations.GetLeakReport());
+        }
 
-    MemoryTracker::RegisterAllocator(m_Data);
+        MemoryTracker::UnRegisterAllocator(m_TrackedData);
+    }
 }
 
-Allocator::~Allocator() { MemoryTracker::UnRegisterAllocator(m_Data); }
+void Allocator::SetTrackingEnabled(const bool isEnabled)
+{
+    if (m_TrackedData)
+    {
+        if (isEnabled)
+        {
+            m_TrackedData->isUsedSizeStale.store(true, std::memory_order_relaxed);
+        }
+        m_TrackedData->isTrackingEnabled.store(isEnabled, std::memory_order_relaxed);
+    }
+}
 
-void Allocator::SetUsedSize(Size size)
+AllocatorData* Allocator::GetUntrackedData()
 {
-    m_Data->usedSize  = size;
-    m_Data->peakUsage = std::max(m_Data->peakUsage, m_Data->usedSize);
+    static AllocatorData untrackedData;
+    return &untrackedData;
 }
 
 void Allocator::SetTotalSize(Size size)
 {
-    m_Data->totalSize = size;
-    MemoryTracker::InvalidateTotalAllocatedSizeCache();
+    const Size totalSize = m_Data->statistics.GetTotalSize();
+    size >= totalSize ? IncreaseTotalSize(size - totalSize) : DecreaseTotalSize(totalSize - size);
+}
+
+void Allocator::IncreaseTotalSize(Size size)
+{
+    m_Data->statistics.IncreaseTotalSize(size);
+    if (CountsTowardsTotalAllocatedSize())
+    {
+        MemoryTracker::IncreaseTotalAllocatedSize(size);
+    }
+}
+
+void Allocator::DecreaseTotalSize(Size size)
+{
+    m_Data->statistics.DecreaseTotalSize(size);
+    if (CountsTowardsTotalAllocatedSize())
+    {
+        MemoryTracker::DecreaseTotalAllocatedSize(size);
+    }
+}
+
+void Allocator::AddAllocation(const Size size, CategoryId category, const SourceLocation& sourceLocation)
+{
+    m_Data->allocationEvents.Record(size, CallSiteRegistry::Register(sourceLocation), category);
+    m_Data->statistics.AddAllocation();
+}
+
+void Allocator::AddDeallocation(const Size size)
+{
+    m_Data->allocationEvents.Record(size, unknownCallSite, noCategory, true);
+    m_Data->statistics.AddDeallocation();
+}
+
+std::vector<AllocationEvent> Allocator::GetAllocations() const
+{
+    std::vector<AllocationEvent> events = m_Data->allocationEvents.GetEvents();
+    std::erase_if(events, [](const AllocationEvent& event) { return event.isDeallocation; });
+    return events;
+}
+
+void Allocator::AddLiveAllocation(const void* ptr, const Size size, CategoryId category, const SourceLocation& sourceLocation)
+{
+    m_Data->liveAllocations.Insert(ptr, size, CallSiteRegistry::Register(sourceLocation), category);
 }
 
-void Allocator::AddAllocation(const Size size, const std::string& category, const SourceLocation& sourceLocation)
+void Allocator::RecordHeapSample(const void* ptr, const Size size)
 {
-    m_Data->allocations.push_back({sourceLocation, category, size});
-    m_Data->allocationCount++;
+    // Leaves out this function, so the trace starts in the allocator
+    m_Data->heapSamples.Insert(ptr, size, CaptureStackTrace(1));
 }
 
-constexpr MallocatorSettings defaultAllocatorSettings = {.policy = MallocatorPolicy::Default};
+constexpr MallocatorSettings defaultAllocatorSettings = {
+    .policy = MallocSizeIsAvailable ? MallocatorPolicy::Default | MallocatorPolicy::HeaderFree : MallocatorPolicy::Default};
 
 const std::shared_ptr<Allocator> Allocator::m_DefaultAllocator =
     std::make_shared<Mallocator<defaultAllocatorSettings>>("DefaultMallocator");
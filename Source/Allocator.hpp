@@ -2,13 +2,19 @@
 
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
+#include <type_traits>
 
 #include "Pointer.hpp"
 #include "Source/AllocatorData.hpp"
 #include "Source/Assert.hpp"
+#include "Source/Category.hpp"
 #include "Source/MemoryTracker.hpp"
+#include "Source/Probes.hpp"
 #include "Source/Policies/MultithreadedPolicy.hpp"
+#include "Source/TraceRecorder.hpp"
+#include "Source/Traits.hpp"
 #include "Source/TypeAliases.hpp"
 #include "Utility/Alignment/Alignment.hpp"
 
@@ -28,35 +34,258 @@ class Allocator
 
     ~Allocator();
 
-    [[nodiscard]] inline Size        GetUsedSize() const { return m_Data->usedSize; }
-    [[nodiscard]] inline Size        GetTotalSize() const { return m_Data->totalSize; }
-    [[nodiscard]] inline Size        GetPeakUsedSize() const { return m_Data->peakUsage; }
-    [[nodiscard]] inline UInt32      GetAllocationCount() const { return m_Data->allocationCount; }
-    [[nodiscard]] inline UInt32      GetDeallocationCount() const { return m_Data->deallocationCount; }
-    [[nodiscard]] inline std::string GetDebugName() const { return m_Data->debugName; }
+    [[nodiscard]] inline Size GetUsedSize() const { return m_Data->statistics.GetUsedSize(); }
+    // Untracked allocators report the size they were created with
+    [[nodiscard]] inline Size GetTotalSize() const
+    {
+        return m_TrackedData ? m_Data->statistics.GetTotalSize() : m_UntrackedTotalSize;
+    }
+    [[nodiscard]] inline Size        GetPeakUsedSize() const { return m_Data->statistics.GetPeakUsedSize(); }
+    // The bytes that malloc rounded header-free allocations up by, summed over all of them. Unlike the used size it does not
+    // drop when memory is freed, as header-free allocations do not keep their requested size
+    [[nodiscard]] inline Size        GetSlackSize() const { return m_Data->statistics.GetSlackSize(); }
+    [[nodiscard]] inline UInt32      GetAllocationCount() const { return m_Data->statistics.GetAllocationCount(); }
+    [[nodiscard]] inline UInt32      GetDeallocationCount() const { return m_Data->statistics.GetDeallocationCount(); }
+    // Zero unless the WasteTracking policy is enabled
+    [[nodiscard]] inline WasteMetrics GetWasteMetrics() const { return m_Data->statistics.GetWasteMetrics(); }
+    [[nodiscard]] inline std::string GetDebugName() const { return m_DebugName; }
+    [[nodiscard]] inline AllocatorId GetId() const { return m_Data->id; }
+    [[nodiscard]] inline AllocatorId GetParentId() const { return m_Data->parentId; }
 
-    [[nodiscard]] inline const std::vector<AllocationData>& GetAllocations() const { return m_Data->allocations; }
+    /**
+     * @brief Switches the AllocationTracking and SizeTracking hooks of an allocator with the DynamicTracking policy. The
+     * counts only follow the operations made while tracking is on. The used size is left as it was while tracking is off,
+     * and is recounted from the allocator's own state on its first update after tracking is switched back on. Does nothing
+     * for untracked allocators.
+     */
+    void                      SetTrackingEnabled(bool isEnabled);
+    [[nodiscard]] inline bool IsTrackingEnabled() const { return m_Data->isTrackingEnabled.load(std::memory_order_relaxed); }
+
+    // The most recent allocations, oldest first. Older events are dropped once the event log is full
+    [[nodiscard]] std::vector<AllocationEvent> GetAllocations() const;
+    // The requested sizes, counted by size class. Empty unless the SizeHistogram policy is enabled
+    [[nodiscard]] inline std::vector<HistogramBucket> GetSizeHistogram() const { return m_Data->sizeHistogram.GetBuckets(); }
+    // The live allocations by call site and category. Empty unless the LeakDetection policy is enabled
+    [[nodiscard]] inline std::vector<LeakReportEntry> GetLeakReport() const { return m_Data->liveAllocations.GetLeakReport(); }
+    // The sampled allocations by stack. Empty unless the HeapSampling policy is enabled
+    [[nodiscard]] inline std::vector<HeapProfileEntry> GetHeapProfile() const { return m_Data->heapSamples.GetHeapProfile(); }
+    // Empty unless the LatencyTracking policy is enabled
+    [[nodiscard]] inline LatencyPercentiles GetLatencyPercentiles(LatencyOperation operation) const
+    {
+        return CalculateLatencyPercentiles(m_Data->latencyHistograms[static_cast<Size>(operation)].GetCounts());
+    }
 
     [[nodiscard]] static std::shared_ptr<Allocator> GetDefaultAllocator() { return m_DefaultAllocator; }
 
-    NO_DISCARD virtual void* AllocateBase(Size /*size*/) { return nullptr; }
+    NO_DISCARD virtual void* AllocateBase(Size /*size*/, const Alignment& /*alignment*/ = defaultAlignment) { return nullptr; }
     virtual void             DeallocateBase(void* ptr) {}
 
   protected:
-    Allocator(Size totalSize, const std::string& debugName, bool isBaseAllocator = false);
+    /**
+     * @brief When `isTracked` is false the allocator does not allocate any AllocatorData and is not registered with the
+     * MemoryTracker. The tracking setters must not be called in that case, and the getters return zero.
+     *
+     * @param parentId The allocator that this one gets its blocks from
+     */
+    Allocator(Size totalSize, const std::string& debugName, bool isBaseAllocator = false, bool isTracked = true,
+              AllocatorId parentId = noAllocator);
+
+    // Null for untracked allocators
+    [[nodiscard]] inline const std::shared_ptr<AllocatorData>& GetTrackedData() const { return m_TrackedData; }
+
+    // Whether to run the hooks of a tracking policy. Only the allocators with the DynamicTracking policy pay for the load
+    template <bool Enabled, bool Dynamic>
+    [[nodiscard]] inline bool ShouldTrack() const noexcept
+    {
+        if constexpr (Enabled && Dynamic)
+        {
+            return m_Data->isTrackingEnabled.load(std::memory_order_relaxed);
+        }
+        else
+        {
+            return Enabled;
+        }
+    }
+
+    // True once after tracking is switched back on, as the used size missed the updates made while it was off
+    template <bool Dynamic>
+    [[nodiscard]] inline bool ShouldResyncUsedSize() noexcept
+    {
+        if constexpr (Dynamic)
+        {
+            std::atomic<bool>& isUsedSizeStale = m_Data->isUsedSizeStale;
+            return isUsedSizeStale.load(std::memory_order_relaxed) && isUsedSizeStale.exchange(false, std::memory_order_relaxed);
+        }
+        else
+        {
+            return false;
+        }
+    }
 
-    void        SetUsedSize(Size size);
-    inline void IncreaseUsedSize(Size size) { SetUsedSize(m_Data->usedSize + size); }
-    inline void DecreaseUsedSize(Size size) { m_Data->usedSize -= size; }
+    // Reads every statistics shard, so prefer the relative setters on the allocation path
+    inline void SetUsedSize(Size size) { m_Data->statistics.SetUsedSize(size); }
+    inline void IncreaseUsedSize(Size size) { m_Data->statistics.IncreaseUsedSize(size); }
+    inline void DecreaseUsedSize(Size size) { m_Data->statistics.DecreaseUsedSize(size); }
+    // Applies the change from `oldSize` to `newSize` without reading the current used size
+    inline void ChangeUsedSize(Size oldSize, Size newSize)
+    {
+        newSize >= oldSize ? IncreaseUsedSize(newSize - oldSize) : DecreaseUsedSize(oldSize - newSize);
+    }
     void        SetTotalSize(Size size);
-    inline void IncreaseTotalSize(Size size) { SetTotalSize(m_Data->totalSize + size); }
-    inline void DecreaseTotalSize(Size size) { SetTotalSize(m_Data->totalSize - size); }
-    void        AddAllocation(Size size, const std::string& category, const SourceLocation& sourceLocation = SourceLocation::current());
-    inline void AddDeallocation() { m_Data->deallocationCount++; }
+    void        IncreaseTotalSize(Size size);
+    void        DecreaseTotalSize(Size size);
+    void        AddAllocation(Size size, CategoryId category, const SourceLocation& sourceLocation = SourceLocation::current());
+    void        AddDeallocation(Size size);
+    inline void RecordAllocationSize(Size size) { m_Data->sizeHistogram.Record(size); }
+    void        AddLiveAllocation(const void* ptr, Size size, CategoryId category, const SourceLocation& sourceLocation);
+    inline void RemoveLiveAllocation(const void* ptr) { m_Data->liveAllocations.Erase(ptr); }
+    [[nodiscard]] inline std::optional<LiveAllocationTable::LiveAllocation> ExtractLiveAllocation(const void* ptr)
+    {
+        return m_Data->liveAllocations.Extract(ptr);
+    }
+    inline void RestoreLiveAllocation(const void* ptr, const LiveAllocationTable::LiveAllocation& liveAllocation)
+    {
+        m_Data->liveAllocations.Insert(ptr, liveAllocation.size, liveAllocation.callSite, liveAllocation.category);
+    }
+    inline void ClearLiveAllocations() { m_Data->liveAllocations.Clear(); }
+    // Records the stack of the allocation if the HeapSampler picks it
+    inline void SampleAllocation(const void* ptr, const Size size)
+    {
+        if (HeapSampler::ShouldSample(size)) [[unlikely]]
+        {
+            RecordHeapSample(ptr, size);
+        }
+    }
+    inline void RemoveHeapSample(const void* ptr) { m_Data->heapSamples.Erase(ptr); }
+    [[nodiscard]] inline std::optional<HeapSampleTable::Sample> ExtractHeapSample(const void* ptr)
+    {
+        return m_Data->heapSamples.Extract(ptr);
+    }
+    inline void RestoreHeapSample(const void* ptr, const HeapSampleTable::Sample& sample)
+    {
+        m_Data->heapSamples.Insert(ptr, sample.size, sample.stackTrace);
+    }
+    inline void FreeHeapSample(const HeapSampleTable::Sample& sample) { m_Data->heapSamples.AddFreed(sample); }
+    inline void ClearHeapSamples() { m_Data->heapSamples.Clear(); }
+    // The trace hooks do nothing unless the TraceRecorder is recording
+    inline void RecordTraceAllocation(const void* ptr, const Size size, const Size alignment, const SourceLocation& sourceLocation)
+    {
+        if (TraceRecorder::IsRecording()) [[unlikely]]
+        {
+            TraceRecorder::RecordAllocation(m_Data->id.value, ptr, size, alignment, CallSiteRegistry::Register(sourceLocation));
+        }
+    }
+    inline void RecordTraceDeallocation(const void* ptr)
+    {
+        if (TraceRecorder::IsRecording()) [[unlikely]]
+        {
+            TraceRecorder::RecordDeallocation(m_Data->id.value, ptr);
+        }
+    }
+    inline void RecordTraceReallocation(const void* oldPtr, const void* newPtr, const Size newSize)
+    {
+        if (TraceRecorder::IsRecording()) [[unlikely]]
+        {
+            TraceRecorder::RecordReallocation(m_Data->id.value, oldPtr, newPtr, newSize);
+        }
+    }
+    inline void RecordTraceRelease()
+    {
+        if (TraceRecorder::IsRecording()) [[unlikely]]
+        {
+            TraceRecorder::RecordRelease(m_Data->id.value);
+        }
+    }
+
+    // The name that the USDT probes report, which untracked allocators keep too
+    [[nodiscard]] inline const char* GetProbeName() const { return m_DebugName.c_str(); }
+
+    // Times the enclosing scope. Does nothing unless `Enabled` is true
+    template <bool Enabled>
+    inline Internal::ScopedLatencyTimer<Enabled> TimeLatency(LatencyOperation operation)
+    {
+        return Internal::ScopedLatencyTimer<Enabled>(m_Data->latencyHistograms[static_cast<Size>(operation)]);
+    }
+    inline void IncreaseSlackSize(Size size) { m_Data->statistics.IncreaseSlackSize(size); }
+    inline void IncreasePaddingSize(Size size) { m_Data->statistics.IncreasePaddingSize(size); }
+    inline void DecreasePaddingSize(Size size) { m_Data->statistics.DecreasePaddingSize(size); }
+    inline void IncreaseHeaderSize(Size size) { m_Data->statistics.IncreaseHeaderSize(size); }
+    inline void DecreaseHeaderSize(Size size) { m_Data->statistics.DecreaseHeaderSize(size); }
+    inline void IncreaseTailWasteSize(Size size) { m_Data->statistics.IncreaseTailWasteSize(size); }
+    inline void DecreaseTailWasteSize(Size size) { m_Data->statistics.DecreaseTailWasteSize(size); }
+    inline void ResetWasteSizes() { m_Data->statistics.ResetWasteSizes(); }
+    inline void SetFreeSize(Size freeSize, Size largestFreeSize) { m_Data->statistics.SetFreeSize(freeSize, largestFreeSize); }
 
   private:
-    std::shared_ptr<AllocatorData>          m_Data;
+    static AllocatorData* GetUntrackedData();
+
+    void RecordHeapSample(const void* ptr, Size size);
+
+    inline bool CountsTowardsTotalAllocatedSize() const
+    {
+        return m_Data->isBaseAllocator && m_Data->isRegistered.load(std::memory_order_relaxed);
+    }
+
+    // Points to m_TrackedData, or to a shared empty AllocatorData for untracked allocators
+    AllocatorData*                          m_Data;
+    std::shared_ptr<AllocatorData>          m_TrackedData;
+    std::string                             m_DebugName;
+    Size                                    m_UntrackedTotalSize = 0; // The size given at construction, which only tracking changes
     static const std::shared_ptr<Allocator> m_DefaultAllocator;
 };
 
+namespace Internal
+{
+/**
+ * @brief Holds the allocator that another allocator gets its blocks from. A concrete upstream type is referenced directly,
+ * so block refills call its `AllocateBase`/`DeallocateBase` without virtual dispatch or reference counting. The upstream
+ * must outlive the allocator using it. The type-erased `Allocator` upstream is shared, and is called through the vtable.
+ */
+template <BaseAllocatable BaseAllocator>
+class BaseAllocatorHolder
+{
+  public:
+    using Argument = BaseAllocator&;
+
+    explicit BaseAllocatorHolder(BaseAllocator& baseAllocator) : m_BaseAllocator(&baseAllocator) {}
+
+    // Upstreams that are not Allocators are not tracked, so they have no id
+    static AllocatorId GetAllocatorId(const BaseAllocator& baseAllocator)
+    {
+        if constexpr (std::is_base_of_v<Allocator, BaseAllocator>)
+        {
+            return baseAllocator.GetId();
+        }
+        else
+        {
+            return noAllocator;
+        }
+    }
+
+    inline BaseAllocator* operator->() const { return m_BaseAllocator; }
+
+  private:
+    BaseAllocator* m_BaseAllocator;
+};
+
+template <>
+class BaseAllocatorHolder<Allocator>
+{
+  public:
+    using Argument = std::shared_ptr<Allocator>;
+
+    explicit BaseAllocatorHolder(std::shared_ptr<Allocator> baseAllocator) : m_BaseAllocator(std::move(baseAllocator)) {}
+
+    static AllocatorId GetAllocatorId(const std::shared_ptr<Allocator>& baseAllocator)
+    {
+        return baseAllocator ? baseAllocator->GetId() : noAllocator;
+    }
+
+    inline Allocator* operator->() const { return m_BaseAllocator.get(); }
+
+  private:
+    std::shared_ptr<Allocator> m_BaseAllocator;
+};
+} // namespace Internal
+
 } // namespace Memarena
\ No newline at end of file
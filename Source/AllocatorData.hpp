@@ -1,30 +1,51 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "AllocationEventLog.hpp"
+#include "AllocatorStatistics.hpp"
+#include "HeapProfiler.hpp"
+#include "Histogram.hpp"
+#include "LatencyTracking.hpp"
+#include "LeakDetection.hpp"
 #include "TypeAliases.hpp"
 
 namespace Memarena
 {
-struct AllocationData
+// Identifies a tracked allocator. Id 0 stands for no allocator, which is what untracked allocators report
+struct AllocatorId
 {
-    SourceLocation sourceLocation;
-    std::string    category;
-    Size           size = 0;
+    UInt32 value = 0;
+
+    friend constexpr bool operator==(AllocatorId, AllocatorId) = default;
 };
 
+constexpr AllocatorId noAllocator{};
+
 struct AllocatorData
 {
-    std::vector<AllocationData> allocations;
-    std::string                 debugName;
-    UInt32                      allocationCount   = 0;
-    UInt32                      deallocationCount = 0;
-    Size                        totalSize         = 0;
-    Size                        usedSize          = 0;
-    Size                        peakUsage         = 0;
-    bool                        isBaseAllocator   = false;
+    // The slack size counts bytes handed out by the upstream beyond what was requested. The waste metrics are only kept by
+    // allocators with the WasteTracking policy
+    AllocatorStatistics statistics;
+    AllocationEventLog  allocationEvents;
+    SizeHistogram       sizeHistogram; // Only filled by allocators with the SizeHistogram policy
+    // Indexed by LatencyOperation. Only filled by allocators with the LatencyTracking policy
+    std::array<LatencyHistogram, latencyOperationCount> latencyHistograms;
+    LiveAllocationTable liveAllocations; // Only filled by allocators with the LeakDetection policy
+    HeapSampleTable     heapSamples;     // Only filled by allocators with the HeapSampling policy
+    std::string         debugName;
+    AllocatorId         id;
+    AllocatorId         parentId; // The upstream the allocator gets its blocks from, if that is a tracked allocator
+    bool                isBaseAllocator = false;
+    std::atomic<bool>   isRegistered    = false; // Set while the MemoryTracker lists the allocator
+    // Read by allocators with the DynamicTracking policy before their AllocationTracking and SizeTracking hooks
+    std::atomic<bool> isTrackingEnabled = true;
+    // Set when tracking is switched on, so that the next update recounts the used size from the allocator's own state
+    std::atomic<bool> isUsedSizeStale = false;
 };
 
 } // namespace Memarena
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstddef>
+
 #include "Policies/Policies.hpp"
+#include "Source/Aliases.hpp"
 
 namespace Memarena
 {
@@ -22,12 +25,72 @@ constexpr auto GetDefaultFailureLoggingSetting() -> bool
 #endif
 }
 
+/**
+ * @brief Functions that an allocator calls on every allocation, deallocation, and block it takes from or gives back to its
+ * upstream, for telemetry of your own. The calls are resolved at compile time and can be inlined, and a hook that is not set
+ * is not compiled in at all. Allocations report the pointer handed to the client and the requested size. Deallocations
+ * report the size the allocator knows the allocation by, so the sizes of one allocation match as long as no rounding is
+ * involved.
+ */
+struct AllocatorHooks
+{
+    void (*onAllocate)(void* ptr, Size size, Size alignment) = nullptr;
+    void (*onDeallocate)(void* ptr, Size size)               = nullptr;
+    void (*onBlockAcquire)(void* blockPtr, Size size)        = nullptr;
+    void (*onBlockRelease)(void* blockPtr, Size size)        = nullptr;
+};
+
+// The hooks of allocators that are not given any
+inline constexpr AllocatorHooks noHooks = {};
+
+template <typename Hooks>
+constexpr AllocatorHooks CollectHooks()
+{
+    AllocatorHooks hooks;
+    if constexpr (requires { &Hooks::OnAllocate; })
+    {
+        hooks.onAllocate = &Hooks::OnAllocate;
+    }
+    if constexpr (requires { &Hooks::OnDeallocate; })
+    {
+        hooks.onDeallocate = &Hooks::OnDeallocate;
+    }
+    if constexpr (requires { &Hooks::OnBlockAcquire; })
+    {
+        hooks.onBlockAcquire = &Hooks::OnBlockAcquire;
+    }
+    if constexpr (requires { &Hooks::OnBlockRelease; })
+    {
+        hooks.onBlockRelease = &Hooks::OnBlockRelease;
+    }
+    return hooks;
+}
+
+template <typename Hooks>
+inline constexpr AllocatorHooks collectedHooks = CollectHooks<Hooks>();
+
+/**
+ * @brief Collects the static `OnAllocate`, `OnDeallocate`, `OnBlockAcquire` and `OnBlockRelease` functions of `Hooks` into
+ * AllocatorHooks. The functions `Hooks` does not declare are left unset. The settings refer to the hooks instead of holding
+ * them, as function pointers in a template argument have to point into an object with static storage.
+ */
+template <typename Hooks>
+constexpr const AllocatorHooks* MakeHooks()
+{
+    return &collectedHooks<Hooks>;
+}
+
 template <AllocatorPolicy Policy>
 struct AllocatorSettings
 {
     Policy policy                  = GetDefaultPolicy<Policy>();
     bool   breakOnFailureIsEnabled = GetDefaultBreakOnFailureSetting();
     bool   failureLoggingIsEnabled = GetDefaultFailureLoggingSetting();
+    // Alignment of the blocks requested from the base allocator. Raising it to the largest alignment the allocator serves
+    // (e.g. the page size) lets those allocations start at the beginning of a block without any padding
+    Size blockAlignment = alignof(std::max_align_t);
+    // Set with MakeHooks. None are called by default
+    const AllocatorHooks* hooks = &noHooks;
 
     // constexpr AllocatorSettings() = default;
     // constexpr AllocatorSettings(const Policy policy = GetDefaultPolicy<Policy>(), const bool breakOnFailureIsEnabled = true,
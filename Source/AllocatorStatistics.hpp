@@ -0,0 +1,220 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+
+#include "Source/Aliases.hpp"
+
+namespace Memarena
+{
+
+constexpr Size cacheLineSize        = 64;
+constexpr Size statisticsShardCount = 16;
+
+namespace Internal
+{
+// Threads are handed shards round robin in the order they first update any statistics
+inline Size GetThreadShardIndex() noexcept
+{
+    static std::atomic<Size> nextShardIndex = 0;
+    thread_local const Size  shardIndex     = nextShardIndex.fetch_add(1, std::memory_order_relaxed) % statisticsShardCount;
+    return shardIndex;
+}
+} // namespace Internal
+
+// The bytes an allocator holds that clients cannot use, and how scattered its free memory is
+struct WasteMetrics
+{
+    Size paddingSize     = 0; // Bytes skipped to align allocations, or to round them up to whole objects
+    Size headerSize      = 0; // Bytes taken by allocation headers and bound guards
+    Size tailWasteSize   = 0; // Bytes left unused at the end of retired blocks and page rounded mappings
+    Size freeSize        = 0; // Bytes still available for allocations
+    Size largestFreeSize = 0; // The largest run of contiguous free bytes
+
+    // The largest free run over the total free size. 1 while the free memory is one run, towards 0 as it gets scattered
+    [[nodiscard]] double GetFragmentationScore() const
+    {
+        return freeSize == 0 ? 1.0 : static_cast<double>(largestFreeSize) / static_cast<double>(freeSize);
+    }
+};
+
+/**
+ * @brief The usage counters of an allocator, split into cache line sized shards. A thread only writes to the shard it was
+ * assigned, so concurrent allocations do not contend on a shared atomic. The totals are summed when they are read.
+ *
+ * Each shard only keeps its own high and low water, so the allocation path never reads the other shards. The peak used size
+ * is derived from them when it is read and when the used size is set at block refills and releases. It is exact while an
+ * allocator is used from a single thread. With several threads it is a lower bound.
+ */
+class AllocatorStatistics
+{
+  public:
+    inline void IncreaseUsedSize(const Size size) noexcept
+    {
+        Shard&      shard    = GetShard();
+        const Int64 usedSize = shard.usedSize.fetch_add(static_cast<Int64>(size), std::memory_order_relaxed) + static_cast<Int64>(size);
+        UpdateWaterMark(shard.usedSizeHighWater, usedSize, std::greater<>{});
+    }
+    inline void DecreaseUsedSize(const Size size) noexcept
+    {
+        Shard&      shard    = GetShard();
+        const Int64 usedSize = shard.usedSize.fetch_sub(static_cast<Int64>(size), std::memory_order_relaxed) - static_cast<Int64>(size);
+        UpdateWaterMark(shard.usedSizeLowWater, usedSize, std::less<>{});
+    }
+    inline void IncreaseTotalSize(const Size size) noexcept
+    {
+        GetShard().totalSize.fetch_add(static_cast<Int64>(size), std::memory_order_relaxed);
+    }
+    inline void DecreaseTotalSize(const Size size) noexcept
+    {
+        GetShard().totalSize.fetch_sub(static_cast<Int64>(size), std::memory_order_relaxed);
+    }
+    inline void IncreaseSlackSize(const Size size) noexcept
+    {
+        GetShard().slackSize.fetch_add(static_cast<Int64>(size), std::memory_order_relaxed);
+    }
+    inline void IncreasePaddingSize(const Size size) noexcept { Add(&Shard::paddingSize, static_cast<Int64>(size)); }
+    inline void DecreasePaddingSize(const Size size) noexcept { Add(&Shard::paddingSize, -static_cast<Int64>(size)); }
+    inline void IncreaseHeaderSize(const Size size) noexcept { Add(&Shard::headerSize, static_cast<Int64>(size)); }
+    inline void DecreaseHeaderSize(const Size size) noexcept { Add(&Shard::headerSize, -static_cast<Int64>(size)); }
+    inline void IncreaseTailWasteSize(const Size size) noexcept { Add(&Shard::tailWasteSize, static_cast<Int64>(size)); }
+    inline void DecreaseTailWasteSize(const Size size) noexcept { Add(&Shard::tailWasteSize, -static_cast<Int64>(size)); }
+    inline void AddAllocation() noexcept { GetShard().allocationCount.fetch_add(1, std::memory_order_relaxed); }
+    inline void AddDeallocation() noexcept { GetShard().deallocationCount.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief Sets the used size to an absolute value. Reads every shard, so it is meant for block refills rather than for
+     * every allocation. Must not race with other updates of the used size.
+     */
+    inline void SetUsedSize(const Size size) noexcept
+    {
+        const Size usedSize = GetUsedSize();
+        size >= usedSize ? IncreaseUsedSize(size - usedSize) : DecreaseUsedSize(usedSize - size);
+        // The shards are summed anyway, and a release may be about to drop the peak
+        UpdatePeakUsedSize(std::max(usedSize, size));
+    }
+    // Same as SetUsedSize, for the total size
+    inline void SetTotalSize(const Size size) noexcept
+    {
+        const Size totalSize = GetTotalSize();
+        size >= totalSize ? IncreaseTotalSize(size - totalSize) : DecreaseTotalSize(totalSize - size);
+    }
+    // Zeroes the padding, header and tail waste sizes, for when every allocation is released at once
+    inline void ResetWasteSizes() noexcept
+    {
+        for (std::atomic<Int64> Shard::*counter : {&Shard::paddingSize, &Shard::headerSize, &Shard::tailWasteSize})
+        {
+            Add(counter, -Sum(counter));
+        }
+    }
+    // Only written by the allocator when it measures its free memory, so it is not sharded
+    inline void SetFreeSize(const Size freeSize, const Size largestFreeSize) noexcept
+    {
+        m_FreeSize.store(freeSize, std::memory_order_relaxed);
+        m_LargestFreeSize.store(largestFreeSize, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] inline Size   GetUsedSize() const noexcept { return ClampToSize(Sum(&Shard::usedSize)); }
+    [[nodiscard]] inline Size   GetTotalSize() const noexcept { return ClampToSize(Sum(&Shard::totalSize)); }
+    [[nodiscard]] inline Size   GetSlackSize() const noexcept { return ClampToSize(Sum(&Shard::slackSize)); }
+    [[nodiscard]] inline UInt32 GetAllocationCount() const noexcept { return static_cast<UInt32>(Sum(&Shard::allocationCount)); }
+    [[nodiscard]] inline UInt32 GetDeallocationCount() const noexcept { return static_cast<UInt32>(Sum(&Shard::deallocationCount)); }
+    [[nodiscard]] inline Size   GetPeakUsedSize() const noexcept
+    {
+        UpdatePeakUsedSize(std::max(GetUsedSize(), GetShardPeakUsedSize()));
+        return m_PeakUsedSize.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] inline WasteMetrics GetWasteMetrics() const noexcept
+    {
+        return {.paddingSize     = ClampToSize(Sum(&Shard::paddingSize)),
+                .headerSize      = ClampToSize(Sum(&Shard::headerSize)),
+                .tailWasteSize   = ClampToSize(Sum(&Shard::tailWasteSize)),
+                .freeSize        = m_FreeSize.load(std::memory_order_relaxed),
+                .largestFreeSize = m_LargestFreeSize.load(std::memory_order_relaxed)};
+    }
+
+  private:
+    // A decrease can land in a different shard than the matching increase, so a single shard may go negative
+    struct alignas(cacheLineSize) Shard
+    {
+        std::atomic<Int64> usedSize          = 0;
+        std::atomic<Int64> usedSizeHighWater = 0;
+        std::atomic<Int64> usedSizeLowWater  = 0;
+        std::atomic<Int64> totalSize         = 0;
+        std::atomic<Int64> slackSize         = 0;
+        std::atomic<Int64> allocationCount   = 0;
+        std::atomic<Int64> deallocationCount = 0;
+        std::atomic<Int64> paddingSize       = 0;
+        std::atomic<Int64> headerSize        = 0;
+        std::atomic<Int64> tailWasteSize     = 0;
+    };
+
+    inline Shard& GetShard() noexcept { return m_Shards[Internal::GetThreadShardIndex()]; }
+
+    inline void Add(std::atomic<Int64> Shard::*counter, const Int64 value) noexcept
+    {
+        (GetShard().*counter).fetch_add(value, std::memory_order_relaxed);
+    }
+
+    inline Int64 Sum(std::atomic<Int64> Shard::*counter) const noexcept
+    {
+        Int64 sum = 0;
+        for (const Shard& shard : m_Shards)
+        {
+            sum += (shard.*counter).load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+    // Shards are read one after another, so a decrease may be seen before the increase it undoes
+    static inline Size ClampToSize(const Int64 value) noexcept { return static_cast<Size>(std::max<Int64>(value, 0)); }
+
+    // Several threads may share a shard, so a high or low that is not kept would be lost
+    template <typename Compare>
+    static inline void UpdateWaterMark(std::atomic<Int64>& waterMark, const Int64 usedSize, const Compare compare) noexcept
+    {
+        Int64 current = waterMark.load(std::memory_order_relaxed);
+        while (compare(usedSize, current) && !waterMark.compare_exchange_weak(current, usedSize, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // While a shard was at its high water, every other shard was at or above its low water, so the allocator as a whole
+    // used at least their sum at that moment
+    inline Size GetShardPeakUsedSize() const noexcept
+    {
+        std::array<Int64, statisticsShardCount> lowWaters{};
+        Int64                                   lowWaterSum = 0;
+        for (Size i = 0; i < statisticsShardCount; i++)
+        {
+            lowWaters[i] = m_Shards[i].usedSizeLowWater.load(std::memory_order_relaxed);
+            lowWaterSum += lowWaters[i];
+        }
+
+        Int64 peakUsedSize = 0;
+        for (Size i = 0; i < statisticsShardCount; i++)
+        {
+            const Int64 highWater = m_Shards[i].usedSizeHighWater.load(std::memory_order_relaxed);
+            peakUsedSize          = std::max(peakUsedSize, highWater + lowWaterSum - lowWaters[i]);
+        }
+        return ClampToSize(peakUsedSize);
+    }
+
+    inline void UpdatePeakUsedSize(const Size usedSize) const noexcept
+    {
+        Size peakUsedSize = m_PeakUsedSize.load(std::memory_order_relaxed);
+        while (usedSize > peakUsedSize && !m_PeakUsedSize.compare_exchange_weak(peakUsedSize, usedSize, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    std::array<Shard, statisticsShardCount> m_Shards;
+    alignas(cacheLineSize) mutable std::atomic<Size> m_PeakUsedSize = 0;
+
+    std::atomic<Size> m_FreeSize        = 0;
+    std::atomic<Size> m_LargestFreeSize = 0;
+};
+
+} // namespace Memarena
@@ -7,10 +7,16 @@
 
 namespace Memarena::Internal
 {
-Offset GetArrayEndOffset(UIntPtr ptrAddress, UIntPtr startAddress, Offset objectCount, Size objectSize, Size footerSize = 0);
+template <typename OffsetType = Offset>
+inline OffsetType GetArrayEndOffset(const UIntPtr ptrAddress, const UIntPtr startAddress, const OffsetType objectCount,
+                                    const Size objectSize, const Size footerSize = 0)
+{
+    const OffsetType addressOffset = ptrAddress - startAddress;
+    return addressOffset + (objectCount * objectSize) + footerSize;
+}
 
 template <typename Object, typename... Args>
-Object* ConstructArray(void* voidPtr, const Offset objectCount, Args&&... argList)
+Object* ConstructArray(void* voidPtr, const Size objectCount, Args&&... argList)
 {
     // Call the placement new operator, which constructs the Object
     Object* firstPtr = new (voidPtr) Object(std::forward<Args>(argList)...);
@@ -26,7 +32,7 @@ Object* ConstructArray(void* voidPtr, const Offset objectCount, Args&&... argLis
     return firstPtr;
 }
 template <typename Object>
-void DestructArray(Object* ptr, const Offset objectCount)
+void DestructArray(Object* ptr, const Size objectCount)
 {
     for (Size i = objectCount - 1; i-- > 0;)
     {
@@ -117,6 +117,7 @@ class FallbackAllocator : public Allocator
         Object* ptr = m_PrimaryAllocator->template NewRaw<Object>(std::forward<Args>(argList)...);
         if (ptr == nullptr)
         {
+            MEMARENA_PROBE(fallback_spill, this, GetProbeName());
             ptr = m_FallbackAllocator->template NewRaw<Object>(std::forward<Args>(argList)...);
         }
 
@@ -182,12 +183,13 @@ class FallbackAllocator : public Allocator
     //     std::destroy_n(ptr, objectCount);
     // }
 
-    NO_DISCARD void* Allocate(const Size size, const Alignment& alignment = defaultAlignment, const std::string& category = "",
+    NO_DISCARD void* Allocate(const Size size, const Alignment& alignment = defaultAlignment, CategoryId category = {},
                               const SourceLocation& sourceLocation = SourceLocation::current())
     {
         void* ptr = m_PrimaryAllocator->Allocate(size, alignment, category, sourceLocation);
-        if (ptr != nullptr)
+        if (ptr == nullptr)
         {
+            MEMARENA_PROBE(fallback_spill, this, GetProbeName());
             ptr = m_FallbackAllocator->Allocate(size, alignment, category, sourceLocation);
         }
 
@@ -195,20 +197,20 @@ class FallbackAllocator : public Allocator
     }
 
     template <typename Object>
-    NO_DISCARD void* Allocate(const std::string& category = "", const SourceLocation& sourceLocation = SourceLocation::current())
+    NO_DISCARD void* Allocate(CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
         return Allocate(sizeof(Object), alignof(Object), category, sourceLocation);
     }
 
     NO_DISCARD void* AllocateArray(const Size objectCount, const Size objectSize, const Alignment& alignment,
-                                   const std::string& category = "", const SourceLocation& sourceLocation = SourceLocation::current())
+                                   CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
         const Size allocationSize = objectCount * objectSize;
         return Allocate(allocationSize, alignment, category, sourceLocation);
     }
 
     template <typename Object>
-    NO_DISCARD void* AllocateArray(const Size objectCount, const std::string& category = "",
+    NO_DISCARD void* AllocateArray(const Size objectCount, CategoryId category = {},
                                    const SourceLocation& sourceLocation = SourceLocation::current())
     {
         return AllocateArray(objectCount, sizeof(Object), alignof(Object), category, sourceLocation);
@@ -13,6 +13,7 @@
 #include "Source/Macros.hpp"
 #include "Source/Policies/MultithreadedPolicy.hpp"
 #include "Source/Policies/Policies.hpp"
+#include "Source/PresizeProfile.hpp"
 #include "Source/Traits.hpp"
 #include "Source/Utility/Alignment/Alignment.hpp"
 
@@ -26,9 +27,10 @@ constexpr LinearAllocatorSettings linearAllocatorDefaultSettings{};
  * @brief A custom memory allocator that cannot deallocate individual allocations. To free allocations, you must
  *       free the entire arena by calling `Release`.
  *
- * @tparam policy
+ * @tparam Settings
+ * @tparam BaseAllocator The allocator that blocks are allocated from. `Allocator` selects the upstream at runtime
  */
-template <LinearAllocatorSettings Settings = linearAllocatorDefaultSettings>
+template <LinearAllocatorSettings Settings = linearAllocatorDefaultSettings, BaseAllocatable BaseAllocator = Allocator>
 class LinearAllocator : public Allocator
 {
   private:
@@ -38,7 +40,22 @@ class LinearAllocator : public Allocator
     static constexpr bool IsGrowable                  = PolicyContains(Policy, LinearAllocatorPolicy::Growable);
     static constexpr bool UsageTrackingIsEnabled      = PolicyContains(Policy, LinearAllocatorPolicy::SizeTracking);
     static constexpr bool AllocationTrackingIsEnabled = PolicyContains(Policy, LinearAllocatorPolicy::AllocationTracking);
+    static constexpr bool DynamicTrackingIsEnabled    = PolicyContains(Policy, LinearAllocatorPolicy::DynamicTracking);
     static constexpr bool IsMultithreaded             = PolicyContains(Policy, LinearAllocatorPolicy::Multithreaded);
+    static constexpr bool LatencyTrackingIsEnabled    = PolicyContains(Policy, LinearAllocatorPolicy::LatencyTracking);
+    static constexpr bool SizeHistogramIsEnabled      = PolicyContains(Policy, LinearAllocatorPolicy::SizeHistogram);
+    static constexpr bool WasteTrackingIsEnabled      = PolicyContains(Policy, LinearAllocatorPolicy::WasteTracking);
+    static constexpr bool HeapSamplingIsEnabled       = PolicyContains(Policy, LinearAllocatorPolicy::HeapSampling);
+    static constexpr bool TraceRecordingIsEnabled     = PolicyContains(Policy, LinearAllocatorPolicy::TraceRecording);
+    static constexpr bool IsPresized                  = PolicyContains(Policy, LinearAllocatorPolicy::Presized); // Needs the statistics
+    static constexpr bool IsTracked                   = UsageTrackingIsEnabled || AllocationTrackingIsEnabled || SizeHistogramIsEnabled ||
+                                                        LatencyTrackingIsEnabled || WasteTrackingIsEnabled || HeapSamplingIsEnabled ||
+                                                        TraceRecordingIsEnabled || IsPresized;
+    static constexpr bool HasLargeOffsets             = PolicyContains(Policy, LinearAllocatorPolicy::LargeOffsets);
+
+    static_assert(!IsPresized || UsageTrackingIsEnabled, "Error: Presized requires SizeTracking to measure the peak used size!");
+
+    using OffsetType = std::conditional_t<HasLargeOffsets, LargeOffset, Offset>;
 
     using ThreadPolicy = MultithreadedPolicy<IsMultithreaded, IsGrowable>;
 
@@ -46,6 +63,8 @@ class LinearAllocator : public Allocator
     using LockGuard = typename ThreadPolicy::template LockGuard<SyncPrimitive>;
     using Mutex     = typename ThreadPolicy::Mutex;
 
+    using BaseAllocatorHolder = Internal::BaseAllocatorHolder<BaseAllocator>;
+
   public:
     // Prohibit default construction, moving and assignment
     LinearAllocator()                       = delete;
@@ -56,17 +75,41 @@ class LinearAllocator : public Allocator
     LinearAllocator& operator=(LinearAllocator&&) = delete;
 
     explicit LinearAllocator(const Size blockSize, const std::string& debugName = "LinearAllocator",
-                             std::shared_ptr<Allocator> baseAllocator = Allocator::GetDefaultAllocator())
-        : Allocator(blockSize, debugName), m_BlockSize(blockSize), m_BaseAllocator(std::move(baseAllocator))
+                             typename BaseAllocatorHolder::Argument baseAllocator = Allocator::GetDefaultAllocator())
+        : Allocator(blockSize, debugName, false, IsTracked, BaseAllocatorHolder::GetAllocatorId(baseAllocator)),
+          m_BlockSize(blockSize), m_BaseAllocator(std::forward<typename BaseAllocatorHolder::Argument>(baseAllocator))
     {
-        AllocateBlock();
+        MEMARENA_ASSERT(blockSize <= std::numeric_limits<OffsetType>::max(),
+                        "Error: Max block size of allocator '%s' cannot be more than %llu! Value passed was %llu. Enable the LargeOffsets "
+                        "policy for larger blocks.\n",
+                        debugName.c_str(), static_cast<ULLInt>(std::numeric_limits<OffsetType>::max()), static_cast<ULLInt>(blockSize));
+
+        if constexpr (IsPresized)
+        {
+            // A block as large as the peak of the profiled run holds everything without growing
+            const PresizeProfile::Entry entry        = PresizeProfile::Acquire(GetTrackedData());
+            const Size                  peakUsedSize = std::min<Size>(entry.peakUsedSize, std::numeric_limits<OffsetType>::max());
+            m_PresizeSlot                            = entry.slot;
+            m_BlockSize                              = std::max(m_BlockSize, peakUsedSize);
+        }
+        if (!AllocateBlock())
+        {
+            // Without a block, the next allocation has to acquire one first
+            m_CurrentOffset = m_BlockSize;
+        }
     }
 
     ~LinearAllocator()
     {
-        for (auto& blockPtr : m_BlockPtrs)
+        if constexpr (IsPresized)
+        {
+            PresizeProfile::Release(GetTrackedData(), m_PresizeSlot);
+        }
+
+        // Newest first, so that an upstream StackAllocator gets its blocks back in the order it requires
+        while (!m_BlockPtrs.empty())
         {
-            m_BaseAllocator->DeallocateBase(blockPtr);
+            FreeLastBlock();
         }
     };
 
@@ -89,72 +132,30 @@ class LinearAllocator : public Allocator
         return Internal::ConstructArray<Object>(voidPtr, objectCount, std::forward<Args>(argList)...);
     }
 
-    NO_DISCARD void* Allocate(const Size size, const Alignment& alignment = defaultAlignment, const std::string& category = "",
+    NO_DISCARD void* Allocate(const Size size, const Alignment& alignment = defaultAlignment, CategoryId category = {},
                               const SourceLocation& sourceLocation = SourceLocation::current())
     {
-        if constexpr (SizeCheckIsEnabled)
-        {
-            MEMARENA_ASSERT_RETURN(size <= m_BlockSize, nullptr,
-                                   "Error: Allocation size (%u) must be <= to block size (%u) for allocator '%s'!\n", size, m_BlockSize,
-                                   GetDebugName().c_str());
-        }
-
-        UIntPtr alignedAddress = 0;
-
-        {
-            // Scope to release the lock after the allocation
-            LockGuard<Mutex> guard(m_MultithreadedPolicy.m_Mutex);
-
-            const UIntPtr baseAddress = m_CurrentStartAddress + m_CurrentOffset;
-            alignedAddress            = CalculateAlignedAddress(baseAddress, alignment);
-            const Padding padding     = alignedAddress - baseAddress;
-
-            Size totalSizeAfterAllocation = m_CurrentOffset + padding + size;
-            SetCurrentOffset(totalSizeAfterAllocation);
-
-            if constexpr (IsGrowable)
-            {
-                // TODO(Ahsan): Check if allocation will be more than max possible size
-                if (totalSizeAfterAllocation > m_BlockSize)
-                {
-                    AllocateBlock();
-                    guard.unlock();
-                    return Allocate(size, alignment, category, sourceLocation);
-                }
-            }
-            else
-            {
-                MEMARENA_ASSERT_RETURN(totalSizeAfterAllocation <= m_BlockSize, nullptr, "Error: The allocator '%s' is out of memory!\n",
-                                       GetDebugName().c_str());
-            }
-        }
-
-        if constexpr (AllocationTrackingIsEnabled)
-        {
-            AddAllocation(size, category, sourceLocation);
-        }
-
-        return std::bit_cast<void*>(alignedAddress);
+        return AllocateInternal(size, alignment, category, sourceLocation);
     }
 
     template <typename Object>
-    NO_DISCARD void* Allocate(const std::string& category = "", const SourceLocation& sourceLocation = SourceLocation::current())
+    NO_DISCARD void* Allocate(CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
-        return Allocate(sizeof(Object), alignof(Object), category, sourceLocation);
+        return AllocateInternal(sizeof(Object), StaticAlignment<alignof(Object)>{}, category, sourceLocation);
     }
 
     NO_DISCARD void* AllocateArray(const Size objectCount, const Size objectSize, const Alignment& alignment,
-                                   const std::string& category = "", const SourceLocation& sourceLocation = SourceLocation::current())
+                                   CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
         const Size allocationSize = objectCount * objectSize;
-        return Allocate(allocationSize, alignment, category, sourceLocation);
+        return AllocateInternal(allocationSize, alignment, category, sourceLocation);
     }
 
     template <typename Object>
-    NO_DISCARD void* AllocateArray(const Size objectCount, const std::string& category = "",
+    NO_DISCARD void* AllocateArray(const Size objectCount, CategoryId category = {},
                                    const SourceLocation& sourceLocation = SourceLocation::current())
     {
-        return AllocateArray(objectCount, sizeof(Object), alignof(Object), category, sourceLocation);
+        return AllocateInternal(objectCount * sizeof(Object), StaticAlignment<alignof(Object)>{}, category, sourceLocation);
     }
 
     /**
@@ -165,6 +166,7 @@ class LinearAllocator : public Allocator
     inline void Release()
     {
         LockGuard<Mutex> guard(m_MultithreadedPolicy.m_Mutex);
+        MEMARENA_PROBE(release, this, GetProbeName());
         DeallocateBlocks();
     };
 
@@ -183,32 +185,166 @@ class LinearAllocator : public Allocator
         return Owns(ptr.GetPtr());
     }
 
-    // NO_DISCARD BaseAllocatorPtr<void> AllocateBase(const Size size) final { return Allocate(size); }
+    NO_DISCARD void* AllocateBase(const Size size, const Alignment& alignment = defaultAlignment) final
+    {
+        return Allocate(size, alignment);
+    }
+    // Individual allocations cannot be freed, the memory is reclaimed when the allocator is released
+    void DeallocateBase(void* /*ptr*/) final {}
 
   private:
-    void SetCurrentOffset(const Offset offset)
+    template <typename AlignmentType>
+    void* AllocateInternal(const Size size, const AlignmentType& alignment, CategoryId category, const SourceLocation& sourceLocation)
+    {
+        [[maybe_unused]] const auto timer = TimeLatency<LatencyTrackingIsEnabled>(LatencyOperation::Allocate);
+        return AllocateFromCurrentBlock(size, alignment, category, sourceLocation);
+    }
+
+    // Retries in a new block when the current one is full
+    template <typename AlignmentType>
+    void* AllocateFromCurrentBlock(const Size size, const AlignmentType& alignment, CategoryId category,
+                                   const SourceLocation& sourceLocation)
     {
+        if constexpr (SizeCheckIsEnabled)
+        {
+            MEMARENA_ASSERT_RETURN(size <= m_BlockSize, nullptr,
+                                   "Error: Allocation size (%u) must be <= to block size (%u) for allocator '%s'!\n", size, m_BlockSize,
+                                   GetDebugName().c_str());
+        }
+
+        UIntPtr alignedAddress = 0;
+
+        {
+            // Scope to release the lock after the allocation
+            LockGuard<Mutex> guard(m_MultithreadedPolicy.m_Mutex);
+
+            const OffsetType startOffset = m_CurrentOffset;
+            const UIntPtr    baseAddress = m_CurrentStartAddress + m_CurrentOffset;
+            alignedAddress               = CalculateAlignedAddress(baseAddress, alignment);
+            const Padding padding        = alignedAddress - baseAddress;
+
+            Size totalSizeAfterAllocation = m_CurrentOffset + padding + size;
+            SetCurrentOffset(totalSizeAfterAllocation);
+
+            if constexpr (IsGrowable)
+            {
+                // TODO(Ahsan): Check if allocation will be more than max possible size
+                if (totalSizeAfterAllocation > m_BlockSize)
+                {
+                    if (!AllocateBlock())
+                    {
+                        // The current block stays in use, as the allocation did not fit into it
+                        SetCurrentOffset(startOffset);
+                        MEMARENA_PROBE(out_of_memory, this, GetProbeName(), size);
+                        MEMARENA_ERROR("Error: The allocator '%s' is out of memory!\n", GetDebugName().c_str());
+                        return nullptr;
+                    }
+                    if constexpr (WasteTrackingIsEnabled)
+                    {
+                        // The rest of the old block is never handed out
+                        IncreaseTailWasteSize(m_BlockSize - startOffset);
+                    }
+                    guard.unlock();
+                    return AllocateFromCurrentBlock(size, alignment, category, sourceLocation);
+                }
+            }
+            else
+            {
+                if (totalSizeAfterAllocation > m_BlockSize)
+                {
+                    MEMARENA_PROBE(out_of_memory, this, GetProbeName(), size);
+                }
+                MEMARENA_ASSERT_RETURN(totalSizeAfterAllocation <= m_BlockSize, nullptr, "Error: The allocator '%s' is out of memory!\n",
+                                       GetDebugName().c_str());
+            }
+
+            if constexpr (WasteTrackingIsEnabled)
+            {
+                IncreasePaddingSize(padding);
+            }
+        }
+
+        if (ShouldTrack<AllocationTrackingIsEnabled, DynamicTrackingIsEnabled>())
+        {
+            AddAllocation(size, category, sourceLocation);
+        }
+        if constexpr (SizeHistogramIsEnabled)
+        {
+            RecordAllocationSize(size);
+        }
+        if constexpr (HeapSamplingIsEnabled)
+        {
+            SampleAllocation(std::bit_cast<void*>(alignedAddress), size);
+        }
+        if constexpr (TraceRecordingIsEnabled)
+        {
+            RecordTraceAllocation(std::bit_cast<void*>(alignedAddress), size, Alignment(alignment), sourceLocation);
+        }
+        if constexpr (Settings.hooks->onAllocate != nullptr)
+        {
+            Settings.hooks->onAllocate(std::bit_cast<void*>(alignedAddress), size, Alignment(alignment));
+        }
+
+        return std::bit_cast<void*>(alignedAddress);
+    }
+
+    // Only moves the offset within the current block
+    void SetCurrentOffset(const OffsetType offset)
+    {
+        if (ShouldTrack<UsageTrackingIsEnabled, DynamicTrackingIsEnabled>())
+        {
+            // The retired blocks count as full
+            if (ShouldResyncUsedSize<DynamicTrackingIsEnabled>()) [[unlikely]]
+            {
+                SetUsedSize((m_BlockPtrs.size() - 1) * m_BlockSize + offset);
+            }
+            else
+            {
+                ChangeUsedSize(m_CurrentOffset, offset);
+            }
+        }
+
         m_CurrentOffset = offset;
+        UpdateFreeSize();
+    }
 
-        if constexpr (UsageTrackingIsEnabled)
+    // Only the rest of the current block can still be allocated from, as the other blocks have been retired
+    inline void UpdateFreeSize()
+    {
+        if constexpr (WasteTrackingIsEnabled)
         {
-            SetUsedSize((m_BlockPtrs.size() - 1) * m_BlockSize + offset);
+            const Size freeSize = m_BlockSize - std::min<Size>(m_CurrentOffset, m_BlockSize);
+            SetFreeSize(freeSize, freeSize);
         }
     }
 
-    inline void AllocateBlock()
+    // Returns false and keeps the current block if the base allocator is out of memory
+    inline bool AllocateBlock()
     {
+        [[maybe_unused]] const auto timer = TimeLatency<LatencyTrackingIsEnabled>(LatencyOperation::BlockRefill);
 
-        void* newBlockPtr = m_BaseAllocator->AllocateBase(m_BlockSize);
+        void* newBlockPtr = m_BaseAllocator->AllocateBase(m_BlockSize, Settings.blockAlignment);
+        if (newBlockPtr == nullptr)
+        {
+            return false;
+        }
         m_BlockPtrs.push_back(newBlockPtr);
         m_CurrentStartAddress = std::bit_cast<UIntPtr>(m_BlockPtrs.back());
         m_CurrentOffset       = 0;
 
-        if constexpr (UsageTrackingIsEnabled)
+        MEMARENA_PROBE(block_acquire, this, GetProbeName(), newBlockPtr, m_BlockSize);
+        if constexpr (Settings.hooks->onBlockAcquire != nullptr)
+        {
+            Settings.hooks->onBlockAcquire(newBlockPtr, m_BlockSize);
+        }
+
+        if (ShouldTrack<UsageTrackingIsEnabled, DynamicTrackingIsEnabled>())
         {
             SetUsedSize((m_BlockPtrs.size() - 1) * m_BlockSize);
         }
         UpdateTotalSize();
+        UpdateFreeSize();
+        return true;
     }
 
     // Deallocates all but the first block
@@ -223,17 +359,46 @@ class LinearAllocator : public Allocator
             UpdateTotalSize();
         }
 
-        m_CurrentStartAddress = std::bit_cast<UIntPtr>(m_BlockPtrs[0]);
+        // Without a block, the next allocation has to acquire one first
+        m_CurrentStartAddress = m_BlockPtrs.empty() ? 0 : std::bit_cast<UIntPtr>(m_BlockPtrs[0]);
+        m_CurrentOffset       = m_BlockPtrs.empty() ? m_BlockSize : 0;
 
-        SetCurrentOffset(0);
+        if (ShouldTrack<UsageTrackingIsEnabled, DynamicTrackingIsEnabled>())
+        {
+            SetUsedSize(0);
+        }
+        if constexpr (WasteTrackingIsEnabled)
+        {
+            ResetWasteSizes();
+        }
+        if constexpr (HeapSamplingIsEnabled)
+        {
+            // Every allocation is freed along with the blocks
+            ClearHeapSamples();
+        }
+        if constexpr (TraceRecordingIsEnabled)
+        {
+            RecordTraceRelease();
+        }
+        UpdateFreeSize();
     }
 
     inline void FreeLastBlock()
     {
-        m_BaseAllocator->DeallocateBase(m_BlockPtrs.back());
+        ReturnBlock(m_BlockPtrs.back());
         m_BlockPtrs.pop_back();
     }
 
+    inline void ReturnBlock(void* blockPtr)
+    {
+        MEMARENA_PROBE(block_release, this, GetProbeName(), blockPtr, m_BlockSize);
+        if constexpr (Settings.hooks->onBlockRelease != nullptr)
+        {
+            Settings.hooks->onBlockRelease(blockPtr, m_BlockSize);
+        }
+        m_BaseAllocator->DeallocateBase(blockPtr);
+    }
+
     inline void UpdateTotalSize()
     {
         if constexpr (UsageTrackingIsEnabled)
@@ -249,9 +414,10 @@ class LinearAllocator : public Allocator
     UIntPtr            m_CurrentStartAddress = 0;
     // ---------------------------------------
 
-    Size   m_BlockSize;
-    Offset m_CurrentOffset = 0;
+    Size       m_BlockSize;
+    OffsetType m_CurrentOffset = 0;
+    Size       m_PresizeSlot   = 0; // Only used by the Presized policy
 
-    std::shared_ptr<Allocator> m_BaseAllocator;
+    BaseAllocatorHolder m_BaseAllocator;
 };
 } // namespace Memarena
\ No newline at end of file
@@ -35,24 +35,24 @@ class LinearAllocatorTemplated
         return m_LinearAllocator.template NewArrayRaw<Object>(objectCount, std::forward<Args>(argList)...);
     }
 
-    NO_DISCARD void* Allocate(const Size size, const Alignment& alignment, const std::string& category = "",
+    NO_DISCARD void* Allocate(const Size size, const Alignment& alignment, CategoryId category = {},
                               const SourceLocation& sourceLocation = SourceLocation::current())
     {
         return m_LinearAllocator.Allocate(size, alignment, category, sourceLocation);
     }
 
-    NO_DISCARD void* Allocate(const std::string& category = "", const SourceLocation& sourceLocation = SourceLocation::current())
+    NO_DISCARD void* Allocate(CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
         return m_LinearAllocator.Allocate(sizeof(Object), alignof(Object), category, sourceLocation);
     }
 
     NO_DISCARD void* AllocateArray(const Size objectCount, const Size objectSize, const Alignment& alignment,
-                                   const std::string& category = "", const SourceLocation& sourceLocation = SourceLocation::current())
+                                   CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
         return m_LinearAllocator.AllocateArray(objectCount, objectSize, alignment, category, sourceLocation);
     }
 
-    NO_DISCARD void* AllocateArray(const Size objectCount, const std::string& category = "",
+    NO_DISCARD void* AllocateArray(const Size objectCount, CategoryId category = {},
                                    const SourceLocation& sourceLocation = SourceLocation::current())
     {
         return AllocateArray(objectCount, sizeof(Object), alignof(Object), category, sourceLocation);
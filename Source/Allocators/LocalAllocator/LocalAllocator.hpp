@@ -49,7 +49,7 @@ class LocalAllocator : public Allocator
 
     ~LocalAllocator() = default;
 
-    NO_DISCARD void* AllocateBase(const Size size) final { return m_Memory[0]; }
+    NO_DISCARD void* AllocateBase(const Size size, const Alignment& /*alignment*/ = defaultAlignment) final { return m_Memory[0]; }
     void             DeallocateBase(void* ptr) final {}
 
   private:
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bit>
+#include <cstring>
 #include <vector>
 
 #include "Source/Allocator.hpp"
@@ -12,21 +13,25 @@
 #include "Source/Policies/MultithreadedPolicy.hpp"
 #include "Source/Policies/Policies.hpp"
 #include "Source/Traits.hpp"
+#include "Source/Utility/AlignedMalloc.hpp"
 #include "Source/Utility/Alignment/Alignment.hpp"
+#include "Source/Utility/MallocSize.hpp"
+#include "Source/Utility/VirtualMemory.hpp"
 
 namespace Memarena
 {
 
 struct MallocHeader
 {
-    Size size;
+    Size    size;
+    Padding padding; // Distance from the start of the block, which is more than the header size for over-aligned allocations
 };
 
 template <typename T>
 class MallocPtr : public Ptr<T>
 {
   public:
-    inline MallocPtr(T* ptr, Size size) : Ptr<T>(ptr), m_Header({size}) {}
+    inline MallocPtr(T* ptr, Size size) : Ptr<T>(ptr), m_Header({.size = size, .padding = 0}) {}
     [[nodiscard]] Size GetSize() const { return m_Header.size; }
 
   private:
@@ -37,7 +42,7 @@ template <typename T>
 class MallocArrayPtr : public ArrayPtr<T>
 {
   public:
-    inline MallocArrayPtr(T* ptr, Size size, Size count) : ArrayPtr<T>(ptr, count), m_Header({size}) {}
+    inline MallocArrayPtr(T* ptr, Size size, Size count) : ArrayPtr<T>(ptr, count), m_Header({.size = size, .padding = 0}) {}
     [[nodiscard]] Size GetSize() const { return m_Header.size; }
 
   private:
@@ -47,6 +52,9 @@ class MallocArrayPtr : public ArrayPtr<T>
 using MallocatorSettings = AllocatorSettings<MallocatorPolicy>;
 constexpr MallocatorSettings mallocatorDefaultSettings{};
 
+// Allocations of at least this size are mapped directly when MallocatorPolicy::DirectMap is enabled
+constexpr Size defaultDirectMapThreshold = 32 * 1024 * 1024;
+
 template <MallocatorSettings Settings = mallocatorDefaultSettings>
 class Mallocator : public Allocator
 {
@@ -58,9 +66,28 @@ class Mallocator : public Allocator
         PolicyContains(Policy, MallocatorPolicy::NullDeallocCheck) || DoubleFreePreventionIsEnabled;
     static constexpr bool NullAllocCheckIsEnabled     = PolicyContains(Policy, MallocatorPolicy::NullAllocCheck);
     static constexpr bool AllocationTrackingIsEnabled = PolicyContains(Policy, MallocatorPolicy::AllocationTracking);
+    static constexpr bool DynamicTrackingIsEnabled    = PolicyContains(Policy, MallocatorPolicy::DynamicTracking);
     static constexpr bool SizeTrackingIsEnabled       = PolicyContains(Policy, MallocatorPolicy::SizeTracking);
     static constexpr bool NeedsMultithreading         = AllocationTrackingIsEnabled || SizeTrackingIsEnabled;
+    static constexpr bool LatencyTrackingIsEnabled    = PolicyContains(Policy, MallocatorPolicy::LatencyTracking);
+    static constexpr bool SizeHistogramIsEnabled      = PolicyContains(Policy, MallocatorPolicy::SizeHistogram);
+    static constexpr bool WasteTrackingIsEnabled      = PolicyContains(Policy, MallocatorPolicy::WasteTracking);
+    static constexpr bool LeakDetectionIsEnabled      = PolicyContains(Policy, MallocatorPolicy::LeakDetection);
+    static constexpr bool HeapSamplingIsEnabled       = PolicyContains(Policy, MallocatorPolicy::HeapSampling);
+    static constexpr bool TraceRecordingIsEnabled     = PolicyContains(Policy, MallocatorPolicy::TraceRecording);
+    static constexpr bool IsTracked                   = AllocationTrackingIsEnabled || SizeTrackingIsEnabled || SizeHistogramIsEnabled ||
+                                                        LatencyTrackingIsEnabled || WasteTrackingIsEnabled || LeakDetectionIsEnabled ||
+                                                        HeapSamplingIsEnabled || TraceRecordingIsEnabled;
     static constexpr bool IsMultithreaded             = PolicyContains(Policy, MallocatorPolicy::Multithreaded) && NeedsMultithreading;
+    static constexpr bool IsHeaderFree                = PolicyContains(Policy, MallocatorPolicy::HeaderFree);
+    static constexpr bool DirectMapIsEnabled          = PolicyContains(Policy, MallocatorPolicy::DirectMap);
+    static constexpr bool PopulateDirectMapIsEnabled  = PolicyContains(Policy, MallocatorPolicy::PopulateDirectMap);
+    static constexpr bool HugePageDirectMapIsEnabled  = PolicyContains(Policy, MallocatorPolicy::HugePageDirectMap);
+
+    static_assert(!IsHeaderFree || MallocSizeIsAvailable,
+                  "Error: HeaderFree requires a platform that can query the size of a malloc block!");
+    // Without a header there is no way to tell a mapped block from a malloc block when deallocating
+    static_assert(!(IsHeaderFree && DirectMapIsEnabled), "Error: HeaderFree and DirectMap cannot be used together!");
 
     using ThreadPolicy = MultithreadedPolicy<IsMultithreaded>;
 
@@ -68,6 +95,9 @@ class Mallocator : public Allocator
     using LockGuard = typename ThreadPolicy::template LockGuard<SyncPrimitive>;
     using Mutex     = typename ThreadPolicy::Mutex;
 
+    // Padding of an allocation that only needs the alignment malloc already provides
+    static constexpr Padding DefaultHeaderPadding = ExtendPaddingForHeader(0, StaticAlignment<mallocAlignment>{}, sizeof(MallocHeader));
+
   public:
     // Prohibit default construction, moving and assignment
     // Mallocator()                  = delete;
@@ -77,15 +107,18 @@ class Mallocator : public Allocator
     Mallocator& operator=(const Mallocator&) = delete;
     Mallocator& operator=(Mallocator&&) = delete;
 
-    Mallocator() : Allocator(0, "Mallocator", true) {}
-    explicit Mallocator(const std::string& debugName) : Allocator(0, debugName, true) {}
+    Mallocator() : Allocator(0, "Mallocator", true, IsTracked) {}
+    explicit Mallocator(const std::string& debugName, const Size directMapThreshold = defaultDirectMapThreshold)
+        : Allocator(0, debugName, true, IsTracked), m_DirectMapThreshold(directMapThreshold)
+    {
+    }
 
     ~Mallocator() = default;
 
     template <Allocatable Object, typename... Args>
     NO_DISCARD MallocPtr<Object> New(Args&&... argList)
     {
-        void* voidPtr = AllocateInternal(sizeof(Object));
+        void* voidPtr = AllocateInternal(sizeof(Object), alignof(Object));
         RETURN_VAL_IF_NULLPTR(voidPtr, MallocPtr<Object>(nullptr, 0));
         Object* objectPtr = new (voidPtr) Object(std::forward<Args>(argList)...);
         return MallocPtr<Object>(objectPtr, sizeof(Object));
@@ -94,7 +127,7 @@ class Mallocator : public Allocator
     template <Allocatable Object, typename... Args>
     NO_DISCARD Object* NewRaw(Args&&... argList)
     {
-        void* voidPtr = Allocate(sizeof(Object));
+        void* voidPtr = Allocate<Object>();
         RETURN_VAL_IF_NULLPTR(voidPtr, nullptr);
         Object* objectPtr = new (voidPtr) Object(std::forward<Args>(argList)...);
         return objectPtr;
@@ -103,7 +136,7 @@ class Mallocator : public Allocator
     template <Allocatable Object, typename... Args>
     NO_DISCARD MallocArrayPtr<Object> NewArray(const Size objectCount, Args&&... argList)
     {
-        void* voidPtr = AllocateInternal(sizeof(Object) * objectCount);
+        void* voidPtr = AllocateInternal(sizeof(Object) * objectCount, alignof(Object));
         RETURN_VAL_IF_NULLPTR(voidPtr, MallocArrayPtr<Object>(nullptr, 0, 0));
         Object* objectPtr = Internal::ConstructArray<Object>(voidPtr, objectCount, std::forward<Args>(argList)...);
         return MallocArrayPtr<Object>(objectPtr, objectCount * sizeof(Object), objectCount);
@@ -112,7 +145,7 @@ class Mallocator : public Allocator
     template <Allocatable Object, typename... Args>
     NO_DISCARD Object* NewArrayRaw(const Size objectCount, Args&&... argList)
     {
-        void* voidPtr = AllocateArray(objectCount, sizeof(Object));
+        void* voidPtr = AllocateArray<Object>(objectCount);
         RETURN_VAL_IF_NULLPTR(voidPtr, nullptr);
         Object* objectPtr = Internal::ConstructArray<Object>(voidPtr, objectCount, std::forward<Args>(argList)...);
         return objectPtr;
@@ -142,79 +175,228 @@ class Mallocator : public Allocator
     template <Allocatable Object>
     void DeleteArray(Object*& ptr)
     {
+        // Without a header the usable size may include slack, so the object count cannot be recovered
+        static_assert(!IsHeaderFree || std::is_trivially_destructible_v<Object>,
+                      "Error: DeleteArray on a raw pointer requires trivially destructible objects when HeaderFree is enabled!");
         const Size size = DeallocateInternalWithHeader(ptr);
         std::destroy_n(ptr, size / sizeof(Object));
     }
 
-    NO_DISCARD void* Allocate(const Size size, const std::string& category = "",
+    /**
+     * @brief Alignments above what malloc guarantees are served from posix_memalign (or an aligned mapping when the
+     * allocation is direct mapped), rather than by over-allocating every block.
+     */
+    NO_DISCARD void* Allocate(const Size size, const Alignment& alignment = defaultAlignment, CategoryId category = {},
                               const SourceLocation& sourceLocation = SourceLocation::current())
     {
-        return AllocateInternalWithHeader(size, category, sourceLocation);
+        return AllocateInternalWithHeader(size, alignment, category, sourceLocation);
     }
 
     template <typename Object>
-    NO_DISCARD void* Allocate(const std::string& category = "", const SourceLocation& sourceLocation = SourceLocation::current())
+    NO_DISCARD void* Allocate(CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
-        return AllocateInternalWithHeader(sizeof(Object), category, sourceLocation);
+        return AllocateInternalWithHeader(sizeof(Object), alignof(Object), category, sourceLocation);
     }
 
-    NO_DISCARD void* AllocateArray(const Size objectCount, const Size objectSize, const std::string& category = "",
-                                   const SourceLocation& sourceLocation = SourceLocation::current())
+    NO_DISCARD void* AllocateArray(const Size objectCount, const Size objectSize, const Alignment& alignment = defaultAlignment,
+                                   CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
-        return AllocateInternalWithHeader(objectCount * objectSize, category, sourceLocation);
+        return AllocateInternalWithHeader(objectCount * objectSize, alignment, category, sourceLocation);
     }
 
     template <typename Object>
-    NO_DISCARD void* AllocateArray(const Size objectCount, const std::string& category = "",
+    NO_DISCARD void* AllocateArray(const Size objectCount, CategoryId category = {},
                                    const SourceLocation& sourceLocation = SourceLocation::current())
     {
-        return AllocateArray(objectCount, sizeof(Object), category, sourceLocation);
+        return AllocateArray(objectCount, sizeof(Object), alignof(Object), category, sourceLocation);
+    }
+
+    /**
+     * @brief Resizes an allocation made with Allocate or AllocateArray, preserving its contents. Direct mapped allocations
+     * are grown with mremap where available, so their pages are moved instead of copied.
+     *
+     * @param alignment The alignment the allocation was made with. Allocations with a header remember their alignment, so
+     * it is only needed when HeaderFree is enabled, or when `ptr` is nullptr
+     * @return The new pointer, or nullptr if the allocation could not be resized. The old pointer stays valid in that case.
+     */
+    NO_DISCARD void* Reallocate(void* ptr, const Size newSize, const Alignment& alignment = defaultAlignment,
+                                CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
+    {
+        if (ptr == nullptr)
+        {
+            return AllocateInternalWithHeader(newSize, alignment, category, sourceLocation);
+        }
+
+        if constexpr (IsHeaderFree)
+        {
+            const Size             oldUsableSize    = GetMallocSize(ptr);
+            const LiveReallocation liveReallocation = BeginLiveReallocation(ptr);
+            void*                  newPtr           = ReallocateBlock(ptr, oldUsableSize, newSize, 0, alignment);
+            if (newPtr == nullptr)
+            {
+                MEMARENA_PROBE(out_of_memory, this, GetProbeName(), newSize);
+                CancelLiveReallocation(ptr, liveReallocation);
+            }
+
+            if constexpr (NullAllocCheckIsEnabled)
+            {
+                MEMARENA_ASSERT_RETURN(newPtr != nullptr, nullptr, "Error: The allocator '%s' couldn't reallocate the memory!\n",
+                                       GetDebugName().c_str());
+            }
+            RETURN_VAL_IF_NULLPTR(newPtr, nullptr);
+
+            const Size newUsableSize = GetMallocSize(newPtr);
+            TrackReallocation(oldUsableSize, newUsableSize, newUsableSize - std::min(newUsableSize, newSize));
+            TrackLiveReallocation(liveReallocation, ptr, newPtr, newSize, category, sourceLocation);
+            CallReallocationHooks(ptr, oldUsableSize, newPtr, newSize, alignment);
+            return newPtr;
+        }
+        else
+        {
+            const UIntPtr address        = std::bit_cast<UIntPtr>(ptr);
+            auto [header, headerAddress] = Internal::GetHeaderFromAddress<MallocHeader>(address);
+
+            void*                  blockPtr         = std::bit_cast<void*>(address - header.padding);
+            const LiveReallocation liveReallocation = BeginLiveReallocation(blockPtr);
+
+            void* newBlockPtr = ReallocateBlock(blockPtr, header.size, newSize, header.padding, GetBlockAlignment(header.padding));
+            if (newBlockPtr == nullptr)
+            {
+                MEMARENA_PROBE(out_of_memory, this, GetProbeName(), newSize);
+                CancelLiveReallocation(blockPtr, liveReallocation);
+            }
+
+            if constexpr (NullAllocCheckIsEnabled)
+            {
+                MEMARENA_ASSERT_RETURN(newBlockPtr != nullptr, nullptr, "Error: The allocator '%s' couldn't reallocate the memory!\n",
+                                       GetDebugName().c_str());
+            }
+            RETURN_VAL_IF_NULLPTR(newBlockPtr, nullptr);
+
+            void* newPtr = std::bit_cast<void*>(std::bit_cast<UIntPtr>(newBlockPtr) + header.padding);
+            Internal::AllocateHeader<MallocHeader>(newPtr, newSize, header.padding);
+            TrackReallocation(header.size, newSize);
+
+            if constexpr (WasteTrackingIsEnabled)
+            {
+                DecreaseTailWasteSize(GetTailWasteSize(header.size, header.padding));
+                IncreaseTailWasteSize(GetTailWasteSize(newSize, header.padding));
+            }
+            TrackLiveReallocation(liveReallocation, blockPtr, newBlockPtr, newSize, category, sourceLocation);
+            CallReallocationHooks(ptr, header.size, newPtr, newSize, GetBlockAlignment(header.padding));
+            return newPtr;
+        }
     }
 
     void Deallocate(void*& ptr) { DeallocateInternalWithHeader(ptr); }
     Size DeallocateArray(void*& ptr) { return DeallocateInternalWithHeader(ptr); }
 
-    NO_DISCARD void* AllocateBase(const Size size) final { return Allocate(size); }
-    void             DeallocateBase(void* ptr) final { Deallocate(ptr); }
+    NO_DISCARD void* AllocateBase(const Size size, const Alignment& alignment = defaultAlignment) final
+    {
+        return Allocate(size, alignment);
+    }
+    void DeallocateBase(void* ptr) final { Deallocate(ptr); }
 
   private:
-    NO_DISCARD void* AllocateInternal(const Size size, const std::string& category = "",
+    NO_DISCARD void* AllocateInternal(const Size size, const Size alignment, CategoryId category = {},
                                       const SourceLocation& sourceLocation = SourceLocation::current(), Padding padding = 0)
     {
-        void* ptr = malloc(padding + size);
+        [[maybe_unused]] const auto timer = TimeLatency<LatencyTrackingIsEnabled>(LatencyOperation::Allocate);
+
+        if constexpr (IsHeaderFree && !AlignedMallocIsFreeCompatible)
+        {
+            // Without a header, deallocation cannot tell which blocks need the aligned free
+            MEMARENA_ASSERT_RETURN(alignment <= mallocAlignment, nullptr,
+                                   "Error: The allocator '%s' cannot serve alignments above %llu when HeaderFree is enabled!\n",
+                                   GetDebugName().c_str(), static_cast<ULLInt>(mallocAlignment));
+        }
+
+        void* ptr = AllocateBlock(size, padding, alignment);
+        if (ptr == nullptr)
+        {
+            MEMARENA_PROBE(out_of_memory, this, GetProbeName(), size);
+        }
 
         if constexpr (NullAllocCheckIsEnabled)
         {
             MEMARENA_ASSERT_RETURN(ptr != nullptr, nullptr, "Error: The allocator '%s' couldn't allocate any memory!\n",
                                    GetDebugName().c_str());
         }
+        RETURN_VAL_IF_NULLPTR(ptr, nullptr);
 
         {
             LockGuard<Mutex> guard(m_MultithreadedPolicy.m_Mutex);
 
-            if constexpr (AllocationTrackingIsEnabled)
+            if (ShouldTrack<AllocationTrackingIsEnabled, DynamicTrackingIsEnabled>())
             {
                 AddAllocation(size, category, sourceLocation);
             }
+            if constexpr (SizeHistogramIsEnabled)
+            {
+                RecordAllocationSize(size);
+            }
+            // Unlike the other allocators, the Mallocator keeps no state to recount its sizes from after tracking was off, so
+            // its SizeTracking hooks always run. Only its AllocationTracking hooks follow the DynamicTracking switch
             if constexpr (SizeTrackingIsEnabled)
             {
-                IncreaseTotalSize(size);
-                IncreaseUsedSize(size);
+                if constexpr (IsHeaderFree)
+                {
+                    // Track what malloc actually handed out, so that deallocation can query the same size
+                    const Size usableSize = GetMallocSize(ptr);
+                    IncreaseTotalSize(usableSize);
+                    IncreaseUsedSize(usableSize);
+                    IncreaseSlackSize(usableSize - std::min(usableSize, size));
+                }
+                else
+                {
+                    IncreaseTotalSize(size);
+                    IncreaseUsedSize(size);
+                }
+            }
+            if constexpr (WasteTrackingIsEnabled)
+            {
+                TrackWaste(size, padding, true);
+            }
+            if constexpr (LeakDetectionIsEnabled)
+            {
+                // Keyed by the block, which is what deallocation receives
+                AddLiveAllocation(ptr, size, category, sourceLocation);
+            }
+            if constexpr (HeapSamplingIsEnabled)
+            {
+                SampleAllocation(ptr, size);
+            }
+            if constexpr (TraceRecordingIsEnabled)
+            {
+                RecordTraceAllocation(ptr, size, alignment, sourceLocation);
             }
         }
 
         UIntPtr address       = std::bit_cast<UIntPtr>(ptr);
         void*   allocationPtr = std::bit_cast<void*>(address + padding);
 
+        if constexpr (Settings.hooks->onAllocate != nullptr)
+        {
+            Settings.hooks->onAllocate(allocationPtr, size, alignment);
+        }
+
         return allocationPtr;
     }
 
-    void* AllocateInternalWithHeader(const Size size, const std::string& category = "",
+    void* AllocateInternalWithHeader(const Size size, const Alignment& alignment, CategoryId category = {},
                                      const SourceLocation& sourceLocation = SourceLocation::current())
     {
-        const Padding padding = ExtendPaddingForHeader(0, alignof(size), sizeof(MallocHeader));
-        void*         ptr     = AllocateInternal(size, category, sourceLocation, padding);
-        Internal::AllocateHeader<MallocHeader>(ptr, size);
+        if constexpr (IsHeaderFree)
+        {
+            return AllocateInternal(size, alignment, category, sourceLocation);
+        }
+
+        // The block is aligned as well, so the padding for an over-aligned allocation is exactly its alignment
+        const Padding padding =
+            alignment <= mallocAlignment ? DefaultHeaderPadding : ExtendPaddingForHeader(0, alignment, sizeof(MallocHeader));
+        void*         ptr     = AllocateInternal(size, alignment, category, sourceLocation, padding);
+        RETURN_VAL_IF_NULLPTR(ptr, nullptr);
+        Internal::AllocateHeader<MallocHeader>(ptr, size, padding);
         return ptr;
     }
 
@@ -226,7 +408,7 @@ class Mallocator : public Allocator
             MEMARENA_ASSERT_RETURN(ptr, void(), "Error: Cannot deallocate nullptr in allocator '%s'!\n", GetDebugName().c_str());
         }
 
-        DeallocateInternal(ptr.GetPtr(), size);
+        DeallocateInternal(ptr.GetPtr(), size, 0, alignof(Object));
 
         if constexpr (DoubleFreePreventionIsEnabled)
         {
@@ -242,15 +424,27 @@ class Mallocator : public Allocator
             MEMARENA_ASSERT_RETURN(ptr, 0, "Error: Cannot deallocate nullptr in allocator '%s'!\n", GetDebugName().c_str());
         }
 
+        if constexpr (IsHeaderFree)
+        {
+            const Size size = GetMallocSize(ptr);
+            DeallocateInternal(static_cast<void*>(ptr), size);
+
+            if constexpr (DoubleFreePreventionIsEnabled)
+            {
+                ptr = nullptr;
+            }
+
+            return size;
+        }
+
         const UIntPtr address        = std::bit_cast<UIntPtr>(ptr);
         auto [header, headerAddress] = Internal::GetHeaderFromAddress<MallocHeader>(address);
-        const Padding padding        = ExtendPaddingForHeader(0, alignof(header.size), sizeof(MallocHeader));
 
         // We can't call `free(ptr)` because `ptr` not the same as the one returned by malloc, since we added padding for header
         // So we subtract that padding to get the original pointer
-        const UIntPtr mallocAddress = address - padding;
+        const UIntPtr mallocAddress = address - header.padding;
         void*         mallocPtr     = std::bit_cast<void*>(mallocAddress);
-        DeallocateInternal(mallocPtr, header.size);
+        DeallocateInternal(mallocPtr, header.size, header.padding, GetBlockAlignment(header.padding));
 
         if constexpr (DoubleFreePreventionIsEnabled)
         {
@@ -260,29 +454,260 @@ class Mallocator : public Allocator
         return header.size;
     }
 
-    void DeallocateInternal(void* ptr, Size size)
+    void DeallocateInternal(void* ptr, Size size, Padding padding = 0, Size alignment = mallocAlignment)
     {
+        [[maybe_unused]] const auto timer = TimeLatency<LatencyTrackingIsEnabled>(LatencyOperation::Deallocate);
 
-        free(ptr);
+        if constexpr (IsHeaderFree && SizeTrackingIsEnabled)
+        {
+            size = GetMallocSize(ptr);
+        }
+
+        // Before the block is freed, as another thread may get the same address from malloc right after
+        if constexpr (LeakDetectionIsEnabled)
+        {
+            RemoveLiveAllocation(ptr);
+        }
+        if constexpr (HeapSamplingIsEnabled)
+        {
+            RemoveHeapSample(ptr);
+        }
+        if constexpr (TraceRecordingIsEnabled)
+        {
+            RecordTraceDeallocation(ptr);
+        }
+        if constexpr (Settings.hooks->onDeallocate != nullptr)
+        {
+            Settings.hooks->onDeallocate(std::bit_cast<void*>(std::bit_cast<UIntPtr>(ptr) + padding), size);
+        }
+
+        DeallocateBlock(ptr, size, padding, alignment);
 
         {
             LockGuard<Mutex> guard(m_MultithreadedPolicy.m_Mutex);
 
-            if constexpr (AllocationTrackingIsEnabled)
+            if (ShouldTrack<AllocationTrackingIsEnabled, DynamicTrackingIsEnabled>())
             {
-                AddDeallocation();
+                AddDeallocation(size);
             }
             if constexpr (SizeTrackingIsEnabled)
             {
-
                 DecreaseTotalSize(size);
                 DecreaseUsedSize(size);
             }
+            if constexpr (WasteTrackingIsEnabled)
+            {
+                TrackWaste(size, padding, false);
+            }
         }
     }
 
-    void AllocateHeader(void* ptr) {}
+    // The leak detection entry and the heap sample of a block that is being reallocated
+    struct LiveReallocation
+    {
+        std::optional<LiveAllocationTable::LiveAllocation> liveAllocation;
+        std::optional<HeapSampleTable::Sample>             heapSample;
+    };
+
+    // Before the block is reallocated, as another thread may get the same address from malloc once realloc frees it
+    LiveReallocation BeginLiveReallocation(const void* oldBlockPtr)
+    {
+        LiveReallocation liveReallocation;
+        if constexpr (LeakDetectionIsEnabled)
+        {
+            liveReallocation.liveAllocation = ExtractLiveAllocation(oldBlockPtr);
+        }
+        if constexpr (HeapSamplingIsEnabled)
+        {
+            liveReallocation.heapSample = ExtractHeapSample(oldBlockPtr);
+        }
+        return liveReallocation;
+    }
+
+    // A failed realloc leaves the old block live, so its entries are put back
+    void CancelLiveReallocation(const void* oldBlockPtr, const LiveReallocation& liveReallocation)
+    {
+        if constexpr (LeakDetectionIsEnabled)
+        {
+            if (liveReallocation.liveAllocation.has_value())
+            {
+                RestoreLiveAllocation(oldBlockPtr, *liveReallocation.liveAllocation);
+            }
+        }
+        if constexpr (HeapSamplingIsEnabled)
+        {
+            if (liveReallocation.heapSample.has_value())
+            {
+                RestoreHeapSample(oldBlockPtr, *liveReallocation.heapSample);
+            }
+        }
+    }
+
+    // A reallocated block keeps its place in the leak report under the call site of the reallocation, and is sampled as a new
+    // allocation
+    void TrackLiveReallocation(const LiveReallocation& liveReallocation, const void* oldBlockPtr, const void* newBlockPtr,
+                               const Size newSize, CategoryId category, const SourceLocation& sourceLocation)
+    {
+        if constexpr (LeakDetectionIsEnabled)
+        {
+            AddLiveAllocation(newBlockPtr, newSize, category, sourceLocation);
+        }
+        if constexpr (HeapSamplingIsEnabled)
+        {
+            if (liveReallocation.heapSample.has_value())
+            {
+                FreeHeapSample(*liveReallocation.heapSample);
+            }
+            SampleAllocation(newBlockPtr, newSize);
+        }
+        if constexpr (TraceRecordingIsEnabled)
+        {
+            RecordTraceReallocation(oldBlockPtr, newBlockPtr, newSize);
+        }
+    }
+
+    // A reallocation is reported as the deallocation of the old allocation and the allocation of the new one
+    void CallReallocationHooks(void* oldPtr, const Size oldSize, void* newPtr, const Size newSize, const Size alignment)
+    {
+        if constexpr (Settings.hooks->onDeallocate != nullptr)
+        {
+            Settings.hooks->onDeallocate(oldPtr, oldSize);
+        }
+        if constexpr (Settings.hooks->onAllocate != nullptr)
+        {
+            Settings.hooks->onAllocate(newPtr, newSize, alignment);
+        }
+    }
+
+    // A non-zero padding holds the header, and the alignment padding in front of it
+    void TrackWaste(const Size size, const Padding padding, const bool isAllocation)
+    {
+        const Size headerSize  = padding > 0 ? sizeof(MallocHeader) : 0;
+        const Size paddingSize = padding - headerSize;
+        const Size tailSize    = GetTailWasteSize(size, padding);
+
+        if (isAllocation)
+        {
+            IncreasePaddingSize(paddingSize);
+            IncreaseHeaderSize(headerSize);
+            IncreaseTailWasteSize(tailSize);
+        }
+        else
+        {
+            DecreasePaddingSize(paddingSize);
+            DecreaseHeaderSize(headerSize);
+            DecreaseTailWasteSize(tailSize);
+        }
+    }
+
+    // Direct mapped allocations are rounded up to whole pages
+    [[nodiscard]] Size GetTailWasteSize(const Size size, const Padding padding) const
+    {
+        return IsDirectMapped(size) ? RoundUpToPageSize(padding + size) - (padding + size) : 0;
+    }
+
+    void TrackReallocation(const Size oldSize, const Size newSize, const Size slackSize = 0)
+    {
+        LockGuard<Mutex> guard(m_MultithreadedPolicy.m_Mutex);
+
+        if constexpr (SizeTrackingIsEnabled)
+        {
+            DecreaseTotalSize(oldSize);
+            DecreaseUsedSize(oldSize);
+            IncreaseTotalSize(newSize);
+            IncreaseUsedSize(newSize);
+            IncreaseSlackSize(slackSize);
+        }
+    }
+
+    [[nodiscard]] inline bool IsDirectMapped(const Size size) const { return DirectMapIsEnabled && size >= m_DirectMapThreshold; }
+
+    // Only over-aligned allocations are padded by more than the default, and their padding equals their alignment
+    static constexpr Size GetBlockAlignment(const Padding padding) { return padding > DefaultHeaderPadding ? padding : mallocAlignment; }
+
+    void* AllocateBlock(const Size size, const Padding padding, const Size alignment)
+    {
+        if constexpr (DirectMapIsEnabled)
+        {
+            if (IsDirectMapped(size))
+            {
+                return MapAlignedMemory(RoundUpToPageSize(padding + size), alignment, PopulateDirectMapIsEnabled,
+                                        HugePageDirectMapIsEnabled);
+            }
+        }
+
+        return AlignedMalloc(padding + size, alignment);
+    }
+
+    void DeallocateBlock(void* ptr, const Size size, const Padding padding, const Size alignment)
+    {
+        if constexpr (DirectMapIsEnabled)
+        {
+            if (IsDirectMapped(size))
+            {
+                UnmapMemory(ptr, RoundUpToPageSize(padding + size));
+                return;
+            }
+        }
+
+        AlignedFree(ptr, alignment);
+    }
+
+    void* ReallocateBlock(void* ptr, const Size oldSize, const Size newSize, const Padding padding, const Size alignment)
+    {
+        if constexpr (DirectMapIsEnabled)
+        {
+            const bool wasDirectMapped = IsDirectMapped(oldSize);
+            const bool isDirectMapped  = IsDirectMapped(newSize);
+
+            if (wasDirectMapped && isDirectMapped)
+            {
+                const Size oldMapSize = RoundUpToPageSize(padding + oldSize);
+                const Size newMapSize = RoundUpToPageSize(padding + newSize);
+
+                if (oldMapSize == newMapSize)
+                {
+                    return ptr;
+                }
+
+                // A remapped block is only guaranteed to be page aligned
+                void* newPtr = alignment <= GetPageSize() ? RemapMemory(ptr, oldMapSize, newMapSize) : nullptr;
+                if (newPtr != nullptr)
+                {
+                    if constexpr (HugePageDirectMapIsEnabled)
+                    {
+                        AdviseHugePages(newPtr, newMapSize);
+                    }
+                    return newPtr;
+                }
+            }
+
+            // Moving between malloc and a mapping (or remapping is not supported), so the contents have to be copied
+            if (wasDirectMapped || isDirectMapped)
+            {
+                return MoveBlock(ptr, oldSize, newSize, padding, alignment);
+            }
+        }
+
+        // realloc only guarantees the alignment of malloc
+        if (alignment > mallocAlignment)
+        {
+            return MoveBlock(ptr, oldSize, newSize, padding, alignment);
+        }
+
+        return realloc(ptr, padding + newSize);
+    }
+
+    void* MoveBlock(void* ptr, const Size oldSize, const Size newSize, const Padding padding, const Size alignment)
+    {
+        void* newPtr = AllocateBlock(newSize, padding, alignment);
+        RETURN_VAL_IF_NULLPTR(newPtr, nullptr);
+        std::memcpy(newPtr, ptr, padding + std::min(oldSize, newSize));
+        DeallocateBlock(ptr, oldSize, padding, alignment);
+        return newPtr;
+    }
 
     ThreadPolicy m_MultithreadedPolicy;
+    Size         m_DirectMapThreshold = defaultDirectMapThreshold;
 };
 } // namespace Memarena
\ No newline at end of file
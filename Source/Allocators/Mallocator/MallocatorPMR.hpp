@@ -12,7 +12,7 @@ class MallocatorPMR : public std::pmr::memory_resource
   public:
     explicit MallocatorPMR(const std::string& debugName = "MallocatorPMR") : m_Mallocator(debugName) {}
 
-    void*              do_allocate(size_t bytes, size_t /*alignment*/) override { return m_Mallocator.Allocate(bytes); }
+    void*              do_allocate(size_t bytes, size_t alignment) override { return m_Mallocator.Allocate(bytes, alignment); }
     void               do_deallocate(void* ptr, size_t /*bytes*/, size_t /*alignment*/) override { m_Mallocator.Deallocate(ptr); }
     [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
 
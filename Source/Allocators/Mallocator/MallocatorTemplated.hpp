@@ -31,25 +31,24 @@ class MallocatorTemplated
         return m_Mallocator.template NewArray<Object>(objectCount, std::forward<Args>(argList)...);
     }
 
-    NO_DISCARD void* Allocate(const Size size, const std::string& category = "",
+    NO_DISCARD void* Allocate(const Size size, const Alignment& alignment = defaultAlignment, CategoryId category = {},
                               const SourceLocation& sourceLocation = SourceLocation::current())
     {
-
-        return m_Mallocator.Allocate(size, category, sourceLocation);
+        return m_Mallocator.Allocate(size, alignment, category, sourceLocation);
     }
 
-    NO_DISCARD void* Allocate(const std::string& category = "", const SourceLocation& sourceLocation = SourceLocation::current())
+    NO_DISCARD void* Allocate(CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
-        return m_Mallocator.Allocate(sizeof(Object), category, sourceLocation);
+        return m_Mallocator.Allocate(sizeof(Object), alignof(Object), category, sourceLocation);
     }
 
-    NO_DISCARD void* AllocateArray(const Size objectCount, const Size objectSize, const std::string& category = "",
-                                   const SourceLocation& sourceLocation = SourceLocation::current())
+    NO_DISCARD void* AllocateArray(const Size objectCount, const Size objectSize, const Alignment& alignment = defaultAlignment,
+                                   CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
-        return m_Mallocator.AllocateArray(objectCount, objectSize, category, sourceLocation);
+        return m_Mallocator.AllocateArray(objectCount, objectSize, alignment, category, sourceLocation);
     }
 
-    NO_DISCARD void* AllocateArray(const Size objectCount, const std::string& category = "",
+    NO_DISCARD void* AllocateArray(const Size objectCount, CategoryId category = {},
                                    const SourceLocation& sourceLocation = SourceLocation::current())
     {
         return AllocateArray(objectCount, sizeof(Object), alignof(Object), category, sourceLocation);
@@ -12,6 +12,7 @@
 #include "Source/Policies/BoundsCheckPolicy.hpp"
 #include "Source/Policies/MultithreadedPolicy.hpp"
 #include "Source/Policies/Policies.hpp"
+#include "Source/PresizeProfile.hpp"
 #include "Source/Traits.hpp"
 #include "Source/Utility/Alignment/Alignment.hpp"
 
@@ -33,7 +34,7 @@ template <typename T>
 class PoolPtr : public Ptr<T>
 {
     // Allow only StackAllocator to create a StackPtr by making constructors private
-    template <PoolAllocatorSettings Settings>
+    template <PoolAllocatorSettings Settings, BaseAllocatable BaseAllocator>
     friend class PoolAllocator;
 
   private:
@@ -44,7 +45,7 @@ template <typename T>
 class PoolArrayPtr : public ArrayPtr<T>
 {
     // Allow only StackAllocator to create a StackPtr by making constructors private
-    template <PoolAllocatorSettings Settings>
+    template <PoolAllocatorSettings Settings, BaseAllocatable BaseAllocator>
     friend class PoolAllocator;
 
   private:
@@ -63,7 +64,7 @@ struct Chunk
 };
 } // namespace Internal
 
-template <PoolAllocatorSettings Settings = poolAllocatorDefaultSettings>
+template <PoolAllocatorSettings Settings = poolAllocatorDefaultSettings, BaseAllocatable BaseAllocator = Allocator>
 class PoolAllocator : public Allocator
 {
     template <PoolAllocatorSettings PMRSettings>
@@ -80,6 +81,19 @@ class PoolAllocator : public Allocator
     static constexpr bool IsGrowable                    = PolicyContains(Policy, PoolAllocatorPolicy::Growable);
     static constexpr bool IsMultithreaded               = PolicyContains(Policy, PoolAllocatorPolicy::Multithreaded);
     static constexpr bool AllocationTrackingIsEnabled   = PolicyContains(Policy, PoolAllocatorPolicy::AllocationTracking);
+    static constexpr bool DynamicTrackingIsEnabled      = PolicyContains(Policy, PoolAllocatorPolicy::DynamicTracking);
+    static constexpr bool LatencyTrackingIsEnabled      = PolicyContains(Policy, PoolAllocatorPolicy::LatencyTracking);
+    static constexpr bool SizeHistogramIsEnabled        = PolicyContains(Policy, PoolAllocatorPolicy::SizeHistogram);
+    static constexpr bool WasteTrackingIsEnabled        = PolicyContains(Policy, PoolAllocatorPolicy::WasteTracking);
+    static constexpr bool LeakDetectionIsEnabled        = PolicyContains(Policy, PoolAllocatorPolicy::LeakDetection);
+    static constexpr bool HeapSamplingIsEnabled         = PolicyContains(Policy, PoolAllocatorPolicy::HeapSampling);
+    static constexpr bool TraceRecordingIsEnabled       = PolicyContains(Policy, PoolAllocatorPolicy::TraceRecording);
+    static constexpr bool IsPresized                    = PolicyContains(Policy, PoolAllocatorPolicy::Presized); // Needs the statistics
+    static constexpr bool IsTracked                     = UsageTrackingIsEnabled || AllocationTrackingIsEnabled || SizeHistogramIsEnabled ||
+                                                          LatencyTrackingIsEnabled || WasteTrackingIsEnabled || LeakDetectionIsEnabled ||
+                                                          HeapSamplingIsEnabled || TraceRecordingIsEnabled || IsPresized;
+
+    static_assert(!IsPresized || UsageTrackingIsEnabled, "Error: Presized requires SizeTracking to measure the peak used size!");
 
     using ThreadPolicy = MultithreadedPolicy<IsMultithreaded, IsGrowable>;
     using Chunk        = Internal::Chunk;
@@ -88,6 +102,8 @@ class PoolAllocator : public Allocator
     using LockGuard = typename ThreadPolicy::template LockGuard<SyncPrimitive>;
     using Mutex     = typename ThreadPolicy::Mutex;
 
+    using BaseAllocatorHolder = Internal::BaseAllocatorHolder<BaseAllocator>;
+
   public:
     // Prohibit default construction, moving and assignment
     PoolAllocator()                     = delete;
@@ -98,23 +114,47 @@ class PoolAllocator : public Allocator
     PoolAllocator& operator=(PoolAllocator&&) = delete;
 
     explicit PoolAllocator(const Size objectSize, const Size objectsPerBlock, const std::string& debugName = "PoolAllocator",
-                           std::shared_ptr<Allocator> baseAllocator = Allocator::GetDefaultAllocator())
-        : Allocator(0, debugName), m_ObjectSize(objectSize), m_ObjectsPerBlock(objectsPerBlock), m_BlockSize(objectSize * objectsPerBlock),
-          m_BaseAllocator(std::move(baseAllocator))
+                           typename BaseAllocatorHolder::Argument baseAllocator = Allocator::GetDefaultAllocator())
+        : Allocator(0, debugName, false, IsTracked, BaseAllocatorHolder::GetAllocatorId(baseAllocator)), m_ObjectSize(objectSize),
+          m_ObjectsPerBlock(objectsPerBlock), m_BlockSize(objectSize * objectsPerBlock),
+          m_BaseAllocator(std::forward<typename BaseAllocatorHolder::Argument>(baseAllocator))
     {
         MEMARENA_ASSERT(objectSize >= sizeof(Chunk), "Error: Object size must be >= to the pointer size (%u) for the allocator '%s'\n",
                         sizeof(void*), GetDebugName().c_str());
         MEMARENA_ASSERT(objectsPerBlock > 0, "Error: Objects per block must be greater than 0 for the allocator '%s'\n",
                         GetDebugName().c_str());
         AllocateBlock();
+
+        if constexpr (IsPresized)
+        {
+            // Reserves enough blocks for the peak of the profiled run. They are all free, so the used size stays untouched
+            const PresizeProfile::Entry entry      = PresizeProfile::Acquire(GetTrackedData());
+            const Size                  blockCount = (entry.peakUsedSize + m_BlockSize - 1) / m_BlockSize;
+            m_PresizeSlot                          = entry.slot;
+            while (m_BlockPtrs.size() < blockCount)
+            {
+                // The pool grows from here as usual if the base allocator runs out
+                if (!AddBlock())
+                {
+                    break;
+                }
+            }
+            UpdateTotalSize();
+        }
     }
 
     ~PoolAllocator()
     {
-        for (void* ptr : m_BlockPtrs)
+        if constexpr (IsPresized)
         {
-            m_BaseAllocator->DeallocateBase(ptr);
-        };
+            PresizeProfile::Release(GetTrackedData(), m_PresizeSlot);
+        }
+
+        // Newest first, so that an upstream StackAllocator gets its blocks back in the order it requires
+        while (!m_BlockPtrs.empty())
+        {
+            FreeLastBlock();
+        }
     }
 
     template <Allocatable Object, typename... Args>
@@ -167,13 +207,12 @@ class PoolAllocator : public Allocator
         std::destroy_n(ptr.GetPtr(), ptr.GetCount());
     }
 
-    NO_DISCARD void* Allocate(const std::string& category = "", const SourceLocation& sourceLocation = SourceLocation::current())
+    NO_DISCARD void* Allocate(CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
         return AllocateInternal(category, sourceLocation);
     }
 
-    NO_DISCARD void* Allocate(const Size size, const std::string& category = "",
-                              const SourceLocation& sourceLocation = SourceLocation::current())
+    NO_DISCARD void* Allocate(const Size size, CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
         MEMARENA_CHECK_ALLOCATION_SIZE(size, nullptr);
         return AllocateInternal(category, sourceLocation);
@@ -183,6 +222,35 @@ class PoolAllocator : public Allocator
 
     [[nodiscard]] Size GetObjectSize() const { return m_ObjectSize; }
 
+    /**
+     * @brief Measures the free chunks and records them in the waste metrics. Contiguous free chunks form a run, which is what
+     * array allocations need. Walks the whole free list, so the metrics are only refreshed when this is called.
+     */
+    void UpdateFragmentationMetrics()
+    {
+        if constexpr (WasteTrackingIsEnabled)
+        {
+            LockGuard<Mutex> guard(m_MultithreadedPolicy.m_Mutex);
+
+            std::vector<UIntPtr> freeAddresses;
+            for (const Chunk* chunk = std::bit_cast<Chunk*>(m_CurrentPtr); chunk != nullptr; chunk = chunk->nextChunk)
+            {
+                freeAddresses.push_back(std::bit_cast<UIntPtr>(chunk));
+            }
+            std::ranges::sort(freeAddresses);
+
+            Size largestRunLength = 0;
+            Size runLength        = 0;
+            for (Size i = 0; i < freeAddresses.size(); i++)
+            {
+                runLength        = i > 0 && freeAddresses[i] == freeAddresses[i - 1] + m_ObjectSize ? runLength + 1 : 1;
+                largestRunLength = std::max(largestRunLength, runLength);
+            }
+
+            SetFreeSize(freeAddresses.size() * m_ObjectSize, largestRunLength * m_ObjectSize);
+        }
+    }
+
     [[nodiscard]] bool Owns(UIntPtr address) const
     {
         return std::ranges::any_of(m_BlockPtrs, [&](void* blockPtr) {
@@ -222,41 +290,64 @@ class PoolAllocator : public Allocator
     }
 
     NO_DISCARD
-    void* AllocateInternal(const std::string& category = "", const SourceLocation& sourceLocation = SourceLocation::current())
+    void* AllocateInternal(CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
-
-        LockGuard<Mutex> guard(m_MultithreadedPolicy.m_Mutex);
+        [[maybe_unused]] const auto timer = TimeLatency<LatencyTrackingIsEnabled>(LatencyOperation::Allocate);
+        LockGuard<Mutex>            guard(m_MultithreadedPolicy.m_Mutex);
 
         if constexpr (IsGrowable)
         {
-            if (m_CurrentPtr == nullptr)
+            // If the base allocator runs out, the free list stays empty and the allocation fails below
+            if (m_CurrentPtr == nullptr && AllocateBlock())
             {
-                AllocateBlock();
+                MEMARENA_PROBE(pool_grow, this, GetProbeName(), m_BlockPtrs.size());
             }
         }
 
+        if (m_CurrentPtr == nullptr)
+        {
+            MEMARENA_PROBE(out_of_memory, this, GetProbeName(), m_ObjectSize);
+        }
         MEMARENA_ASSERT_RETURN(m_CurrentPtr != nullptr, nullptr, "Error: The allocator '%s' is out of memory!\n", GetDebugName().c_str());
 
         void*  freePtr      = m_CurrentPtr;
         Chunk* currentChunk = std::bit_cast<Chunk*>(m_CurrentPtr);
         m_CurrentPtr        = currentChunk->nextChunk;
 
-        if constexpr (AllocationTrackingIsEnabled)
+        if (ShouldTrack<AllocationTrackingIsEnabled, DynamicTrackingIsEnabled>())
         {
             AddAllocation(m_ObjectSize, category, sourceLocation);
         }
-
-        if constexpr (UsageTrackingIsEnabled)
+        if constexpr (SizeHistogramIsEnabled)
+        {
+            RecordAllocationSize(m_ObjectSize);
+        }
+        if constexpr (LeakDetectionIsEnabled)
+        {
+            AddLiveAllocation(freePtr, m_ObjectSize, category, sourceLocation);
+        }
+        if constexpr (HeapSamplingIsEnabled)
+        {
+            SampleAllocation(freePtr, m_ObjectSize);
+        }
+        if constexpr (TraceRecordingIsEnabled)
         {
-            IncreaseUsedSize(m_ObjectSize);
+            RecordTraceAllocation(freePtr, m_ObjectSize, defaultAlignment, sourceLocation);
         }
+        if constexpr (Settings.hooks->onAllocate != nullptr)
+        {
+            Settings.hooks->onAllocate(freePtr, m_ObjectSize, defaultAlignment);
+        }
+
+        UpdateUsedSize(1, true);
 
         return freePtr;
     }
 
-    NO_DISCARD void* AllocateArrayInternal(const Size objectCount, const std::string& category = "",
+    NO_DISCARD void* AllocateArrayInternal(const Size objectCount, CategoryId category = {},
                                            const SourceLocation& sourceLocation = SourceLocation::current())
     {
+        [[maybe_unused]] const auto timer = TimeLatency<LatencyTrackingIsEnabled>(LatencyOperation::Allocate);
 
         MEMARENA_ASSERT_RETURN(objectCount <= m_ObjectsPerBlock, nullptr,
                                "Error: Allocation object count (%u) must be <= to objects per block (%u) for allocator '%s'!\n",
@@ -276,7 +367,13 @@ class PoolAllocator : public Allocator
             {
                 if (currentChunk == nullptr)
                 {
-                    AllocateBlock();
+                    if (!AllocateBlock())
+                    {
+                        MEMARENA_PROBE(out_of_memory, this, GetProbeName(), m_ObjectSize * objectCount);
+                        MEMARENA_ERROR("Error: The allocator '%s' is out of memory!\n", GetDebugName().c_str());
+                        return nullptr;
+                    }
+                    MEMARENA_PROBE(pool_grow, this, GetProbeName(), m_BlockPtrs.size());
                     // We know for sure that the newly allocated block has the required number of consecutive chunks
                     // So we can just return the starting pointer of the new block
                     startingChunk = std::bit_cast<Chunk*>(m_CurrentPtr);
@@ -284,6 +381,10 @@ class PoolAllocator : public Allocator
                 }
             }
 
+            if (m_CurrentPtr == nullptr)
+            {
+                MEMARENA_PROBE(out_of_memory, this, GetProbeName(), m_ObjectSize * objectCount);
+            }
             MEMARENA_ASSERT_RETURN(m_CurrentPtr != nullptr, nullptr, "Error: The allocator '%s' is out of memory!\n",
                                    GetDebugName().c_str());
 
@@ -301,15 +402,32 @@ class PoolAllocator : public Allocator
             currentChunk = currentChunk->nextChunk;
         }
 
-        if constexpr (AllocationTrackingIsEnabled)
+        if (ShouldTrack<AllocationTrackingIsEnabled, DynamicTrackingIsEnabled>())
         {
             AddAllocation(m_ObjectSize * objectCount, category, sourceLocation);
         }
-
-        if constexpr (UsageTrackingIsEnabled)
+        if constexpr (SizeHistogramIsEnabled)
+        {
+            RecordAllocationSize(m_ObjectSize * objectCount);
+        }
+        if constexpr (LeakDetectionIsEnabled)
+        {
+            AddLiveAllocation(startingChunk, m_ObjectSize * objectCount, category, sourceLocation);
+        }
+        if constexpr (HeapSamplingIsEnabled)
+        {
+            SampleAllocation(startingChunk, m_ObjectSize * objectCount);
+        }
+        if constexpr (TraceRecordingIsEnabled)
         {
-            IncreaseUsedSize(m_ObjectSize * objectCount);
+            RecordTraceAllocation(startingChunk, m_ObjectSize * objectCount, defaultAlignment, sourceLocation);
         }
+        if constexpr (Settings.hooks->onAllocate != nullptr)
+        {
+            Settings.hooks->onAllocate(startingChunk, m_ObjectSize * objectCount, defaultAlignment);
+        }
+
+        UpdateUsedSize(objectCount, true);
 
         const UIntPtr startingAddress = std::bit_cast<UIntPtr>(startingChunk);
         if (startingAddress == std::bit_cast<UIntPtr>(m_CurrentPtr))
@@ -323,7 +441,8 @@ class PoolAllocator : public Allocator
 
     void DeallocateVoidInternal(void* ptr)
     {
-        LockGuard<Mutex> guard(m_MultithreadedPolicy.m_Mutex);
+        [[maybe_unused]] const auto timer = TimeLatency<LatencyTrackingIsEnabled>(LatencyOperation::Deallocate);
+        LockGuard<Mutex>            guard(m_MultithreadedPolicy.m_Mutex);
 
         if (!CheckPtr(ptr))
         {
@@ -334,20 +453,34 @@ class PoolAllocator : public Allocator
         chunk->nextChunk = std::bit_cast<Chunk*>(m_CurrentPtr);
         m_CurrentPtr     = ptr;
 
-        if constexpr (AllocationTrackingIsEnabled)
+        if (ShouldTrack<AllocationTrackingIsEnabled, DynamicTrackingIsEnabled>())
         {
-            AddDeallocation();
+            AddDeallocation(m_ObjectSize);
         }
 
-        if constexpr (UsageTrackingIsEnabled)
+        UpdateUsedSize(1, false);
+        if constexpr (LeakDetectionIsEnabled)
+        {
+            RemoveLiveAllocation(ptr);
+        }
+        if constexpr (HeapSamplingIsEnabled)
+        {
+            RemoveHeapSample(ptr);
+        }
+        if constexpr (TraceRecordingIsEnabled)
+        {
+            RecordTraceDeallocation(ptr);
+        }
+        if constexpr (Settings.hooks->onDeallocate != nullptr)
         {
-            DecreaseUsedSize(m_ObjectSize);
+            Settings.hooks->onDeallocate(ptr, m_ObjectSize);
         }
     }
 
     void DeallocateArrayInternal(void* ptr, Size objectCount)
     {
-        LockGuard<Mutex> guard(m_MultithreadedPolicy.m_Mutex);
+        [[maybe_unused]] const auto timer = TimeLatency<LatencyTrackingIsEnabled>(LatencyOperation::Deallocate);
+        LockGuard<Mutex>            guard(m_MultithreadedPolicy.m_Mutex);
 
         if (!CheckPtr(ptr))
         {
@@ -361,21 +494,60 @@ class PoolAllocator : public Allocator
         lastChunk->nextChunk = std::bit_cast<Chunk*>(m_CurrentPtr);
         m_CurrentPtr         = ptr;
 
-        if constexpr (AllocationTrackingIsEnabled)
+        if (ShouldTrack<AllocationTrackingIsEnabled, DynamicTrackingIsEnabled>())
         {
-            AddDeallocation();
+            AddDeallocation(m_ObjectSize * objectCount);
         }
 
-        if constexpr (UsageTrackingIsEnabled)
+        UpdateUsedSize(objectCount, false);
+        if constexpr (LeakDetectionIsEnabled)
+        {
+            RemoveLiveAllocation(ptr);
+        }
+        if constexpr (HeapSamplingIsEnabled)
+        {
+            RemoveHeapSample(ptr);
+        }
+        if constexpr (TraceRecordingIsEnabled)
+        {
+            RecordTraceDeallocation(ptr);
+        }
+        if constexpr (Settings.hooks->onDeallocate != nullptr)
         {
-            DecreaseUsedSize(m_ObjectSize * objectCount);
+            Settings.hooks->onDeallocate(ptr, m_ObjectSize * objectCount);
         }
     }
 
-    void AllocateBlock()
+    // Returns false if the base allocator is out of memory
+    bool AllocateBlock()
+    {
+        [[maybe_unused]] const auto timer = TimeLatency<LatencyTrackingIsEnabled>(LatencyOperation::BlockRefill);
+
+        if (!AddBlock())
+        {
+            return false;
+        }
+
+        if (ShouldTrack<UsageTrackingIsEnabled, DynamicTrackingIsEnabled>())
+        {
+            // The pool only grows once every chunk of the earlier blocks is in use
+            SetUsedSize((m_BlockPtrs.size() - 1) * m_BlockSize);
+        }
+
+        UpdateTotalSize();
+        return true;
+    }
+
+    // Puts the chunks of a new block in front of the free list. Returns false and leaves the free list untouched if the base
+    // allocator is out of memory
+    bool AddBlock()
     {
         // The first chunk of the new block
-        void* newBlockPtr = m_BaseAllocator->AllocateBase(m_BlockSize);
+        void* newBlockPtr = m_BaseAllocator->AllocateBase(m_BlockSize, Settings.blockAlignment);
+        if (newBlockPtr == nullptr)
+        {
+            return false;
+        }
 
         // Once the block is allocated, we need to chain all the chunks in this block:
         Chunk* currentChunk = std::bit_cast<Chunk*>(newBlockPtr);
@@ -386,18 +558,19 @@ class PoolAllocator : public Allocator
             currentChunk            = currentChunk->nextChunk;
         }
 
-        currentChunk->nextChunk = nullptr;
+        // The chunks that were still free follow the new block
+        currentChunk->nextChunk = std::bit_cast<Chunk*>(m_CurrentPtr);
 
         m_BlockPtrs.push_back(newBlockPtr);
 
-        if constexpr (UsageTrackingIsEnabled)
+        MEMARENA_PROBE(block_acquire, this, GetProbeName(), newBlockPtr, m_BlockSize);
+        if constexpr (Settings.hooks->onBlockAcquire != nullptr)
         {
-            SetUsedSize((m_BlockPtrs.size() - 1) * m_BlockSize);
+            Settings.hooks->onBlockAcquire(newBlockPtr, m_BlockSize);
         }
 
-        UpdateTotalSize();
-
         m_CurrentPtr = newBlockPtr;
+        return true;
     }
 
     inline void DeallocateBlocks()
@@ -411,7 +584,38 @@ class PoolAllocator : public Allocator
             UpdateTotalSize();
         }
 
-        m_CurrentPtr = m_BlockPtrs[0];
+        // Empty if the base allocator could not even provide the first block
+        m_CurrentPtr = m_BlockPtrs.empty() ? nullptr : m_BlockPtrs[0];
+    }
+
+    // The live object count is kept even while tracking is off, so that the used size can be recounted once it is back on
+    inline void UpdateUsedSize(const Size objectCount, const bool isAllocation)
+    {
+        if constexpr (DynamicTrackingIsEnabled)
+        {
+            m_LiveObjectCount = isAllocation ? m_LiveObjectCount + objectCount : m_LiveObjectCount - objectCount;
+        }
+        if (ShouldTrack<UsageTrackingIsEnabled, DynamicTrackingIsEnabled>())
+        {
+            if (ShouldResyncUsedSize<DynamicTrackingIsEnabled>()) [[unlikely]]
+            {
+                SetUsedSize(m_LiveObjectCount * m_ObjectSize);
+            }
+            else
+            {
+                isAllocation ? IncreaseUsedSize(m_ObjectSize * objectCount) : DecreaseUsedSize(m_ObjectSize * objectCount);
+            }
+        }
+    }
+
+    // The PoolAllocatorPMR rounds requests up to whole objects, which is counted as padding
+    inline void TrackRoundingPadding(const Size objectCount, const Size requestedSize, const bool isAllocation)
+    {
+        if constexpr (WasteTrackingIsEnabled)
+        {
+            const Size paddingSize = objectCount * m_ObjectSize - requestedSize;
+            isAllocation ? IncreasePaddingSize(paddingSize) : DecreasePaddingSize(paddingSize);
+        }
     }
 
     inline bool CheckPtr(void* ptr)
@@ -434,10 +638,20 @@ class PoolAllocator : public Allocator
 
     inline void FreeLastBlock()
     {
-        m_BaseAllocator->DeallocateBase(m_BlockPtrs.back());
+        ReturnBlock(m_BlockPtrs.back());
         m_BlockPtrs.pop_back();
     }
 
+    inline void ReturnBlock(void* blockPtr)
+    {
+        MEMARENA_PROBE(block_release, this, GetProbeName(), blockPtr, m_BlockSize);
+        if constexpr (Settings.hooks->onBlockRelease != nullptr)
+        {
+            Settings.hooks->onBlockRelease(blockPtr, m_BlockSize);
+        }
+        m_BaseAllocator->DeallocateBase(blockPtr);
+    }
+
     inline void UpdateTotalSize()
     {
         if constexpr (UsageTrackingIsEnabled)
@@ -473,8 +687,8 @@ class PoolAllocator : public Allocator
         }
     }
 
-    std::shared_ptr<Allocator> m_BaseAllocator;
-    std::vector<void*>         m_BlockPtrs;
+    BaseAllocatorHolder m_BaseAllocator;
+    std::vector<void*>  m_BlockPtrs;
 
     ThreadPolicy m_MultithreadedPolicy;
 
@@ -483,6 +697,8 @@ class PoolAllocator : public Allocator
     Size m_ObjectsPerBlock;
     Size m_ObjectSize;
     Size m_BlockSize;
+    Size m_PresizeSlot     = 0; // Only used by the Presized policy
+    Size m_LiveObjectCount = 0; // Only kept by the DynamicTracking policy
 };
 
 // template <PoolAllocatorPolicy policy>
@@ -14,10 +14,19 @@ class PoolAllocatorPMR : public std::pmr::memory_resource
         : m_PoolAllocator(objectSize, objectsPerBlock, debugName)
     {
     }
-    void* do_allocate(Size size, Size /*alignment*/) override { return m_PoolAllocator.AllocateArrayInternal(GetMinimumObjectCount(size)); }
-    void  do_deallocate(void* ptr, Size size, Size /*alignment*/) override
+    void* do_allocate(Size size, Size /*alignment*/) override
     {
-        m_PoolAllocator.DeallocateArrayInternal(ptr, GetMinimumObjectCount(size));
+        const Size objectCount = GetMinimumObjectCount(size);
+        void*      ptr         = m_PoolAllocator.AllocateArrayInternal(objectCount);
+        RETURN_VAL_IF_NULLPTR(ptr, nullptr);
+        m_PoolAllocator.TrackRoundingPadding(objectCount, size, true);
+        return ptr;
+    }
+    void do_deallocate(void* ptr, Size size, Size /*alignment*/) override
+    {
+        const Size objectCount = GetMinimumObjectCount(size);
+        m_PoolAllocator.DeallocateArrayInternal(ptr, objectCount);
+        m_PoolAllocator.TrackRoundingPadding(objectCount, size, false);
     }
     [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
 
@@ -38,12 +38,12 @@ class PoolAllocatorTemplated
 
     void DeleteArray(PoolArrayPtr<Object> ptr) { m_PoolAllocator.Delete(ptr); }
 
-    NO_DISCARD PoolPtr<void> Allocate(const std::string& category = "", const SourceLocation& sourceLocation = SourceLocation::current())
+    NO_DISCARD PoolPtr<void> Allocate(CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
         return m_PoolAllocator.Allocate(category, sourceLocation);
     }
 
-    NO_DISCARD PoolArrayPtr<void> AllocateArray(Size objectCount, const std::string& category = "",
+    NO_DISCARD PoolArrayPtr<void> AllocateArray(Size objectCount, CategoryId category = {},
                                                 const SourceLocation& sourceLocation = SourceLocation::current())
     {
         return m_PoolAllocator.AllocateArray(objectCount, category, sourceLocation);
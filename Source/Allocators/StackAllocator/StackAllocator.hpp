@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstring>
 #include <experimental/source_location>
 #include <utility>
 
@@ -23,62 +24,65 @@ constexpr StackAllocatorSettings stackAllocatorDefaultSettings{};
 namespace Internal
 {
 
+template <typename OffsetType = Offset>
 struct StackHeaderLite
 {
-    Offset startOffset;
+    OffsetType startOffset;
 
-    StackHeaderLite(Offset _startOffset, Offset /*_endOffset*/) : startOffset(_startOffset) {}
+    StackHeaderLite(OffsetType _startOffset, OffsetType /*_endOffset*/) : startOffset(_startOffset) {}
 };
 
+template <typename OffsetType = Offset>
 struct StackHeader
 {
-    Offset startOffset;
-    Offset endOffset;
+    OffsetType startOffset;
+    OffsetType endOffset;
 
-    StackHeader(Offset _startOffset, Offset _endOffset) : startOffset(_startOffset), endOffset(_endOffset) {}
+    StackHeader(OffsetType _startOffset, OffsetType _endOffset) : startOffset(_startOffset), endOffset(_endOffset) {}
 };
 
+template <typename OffsetType = Offset>
 struct StackArrayHeader
 {
-    Offset startOffset;
-    Offset count;
+    OffsetType startOffset;
+    OffsetType count;
 
-    StackArrayHeader(Offset _startOffset, Offset _count) : startOffset(_startOffset), count(_count) {}
+    StackArrayHeader(OffsetType _startOffset, OffsetType _count) : startOffset(_startOffset), count(_count) {}
 };
 } // namespace Internal
 
-template <typename T>
+template <typename T, typename OffsetType = Offset>
 class StackPtr : public Ptr<T>
 {
     // Allow only StackAllocator to create a StackPtr by making constructors private
-    template <StackAllocatorSettings Settings>
+    template <StackAllocatorSettings Settings, BaseAllocatable BaseAllocator>
     friend class StackAllocator;
 
   public:
-    [[nodiscard]] inline const Internal::StackHeader& GetHeader() const { return m_Header; }
+    [[nodiscard]] inline const Internal::StackHeader<OffsetType>& GetHeader() const { return m_Header; }
 
   private:
-    inline StackPtr(T* ptr, const Internal::StackHeader& header) : Ptr<T>(ptr), m_Header(header) {}
-    inline StackPtr(T* ptr, Offset startOffset, Offset endOffset) : Ptr<T>(ptr), m_Header(startOffset, endOffset) {}
-    Internal::StackHeader m_Header;
+    inline StackPtr(T* ptr, const Internal::StackHeader<OffsetType>& header) : Ptr<T>(ptr), m_Header(header) {}
+    inline StackPtr(T* ptr, OffsetType startOffset, OffsetType endOffset) : Ptr<T>(ptr), m_Header(startOffset, endOffset) {}
+    Internal::StackHeader<OffsetType> m_Header;
 };
 
-template <typename T>
+template <typename T, typename OffsetType = Offset>
 class StackArrayPtr : public ArrayPtr<T>
 {
     // Allow only StackAllocator to create a StackArrayPtr by making constructors private
-    template <StackAllocatorSettings Settings>
+    template <StackAllocatorSettings Settings, BaseAllocatable BaseAllocator>
     friend class StackAllocator;
 
   public:
-    [[nodiscard]] inline Size                              GetCount() const { return m_Header.count; }
-    [[nodiscard]] inline const Internal::StackArrayHeader& GetHeader() const { return m_Header; }
+    [[nodiscard]] inline Size                                          GetCount() const { return m_Header.count; }
+    [[nodiscard]] inline const Internal::StackArrayHeader<OffsetType>& GetHeader() const { return m_Header; }
 
   private:
-    StackArrayPtr(T* ptr, const Internal::StackArrayHeader& header) : ArrayPtr<T>(ptr, header.count), m_Header(header) {}
-    StackArrayPtr(T* ptr, Offset startOffset, Offset count) : ArrayPtr<T>(ptr, count), m_Header(startOffset, count) {}
+    StackArrayPtr(T* ptr, const Internal::StackArrayHeader<OffsetType>& header) : ArrayPtr<T>(ptr, header.count), m_Header(header) {}
+    StackArrayPtr(T* ptr, OffsetType startOffset, OffsetType count) : ArrayPtr<T>(ptr, count), m_Header(startOffset, count) {}
 
-    Internal::StackArrayHeader m_Header;
+    Internal::StackArrayHeader<OffsetType> m_Header;
 };
 
 /**
@@ -96,8 +100,9 @@ class StackArrayPtr : public ArrayPtr<T>
  * Allocation and deallocation complexity: O(1)
  *
  * @tparam policy The `StackAllocatorPolicy`mjn object to define the behaviour of this allocator
+ * @tparam BaseAllocator The allocator that the memory is allocated from. `Allocator` selects the upstream at runtime
  */
-template <StackAllocatorSettings Settings = stackAllocatorDefaultSettings>
+template <StackAllocatorSettings Settings = stackAllocatorDefaultSettings, BaseAllocatable BaseAllocator = Allocator>
 class StackAllocator : public Allocator
 {
   private:
@@ -110,13 +115,36 @@ class StackAllocator : public Allocator
     static constexpr bool UsageTrackingIsEnabled        = PolicyContains(Policy, StackAllocatorPolicy::SizeTracking);
     static constexpr bool IsMultithreaded               = PolicyContains(Policy, StackAllocatorPolicy::Multithreaded);
     static constexpr bool AllocationTrackingIsEnabled   = PolicyContains(Policy, StackAllocatorPolicy::AllocationTracking);
+    static constexpr bool DynamicTrackingIsEnabled      = PolicyContains(Policy, StackAllocatorPolicy::DynamicTracking);
     static constexpr bool IsResizable                   = PolicyContains(Policy, StackAllocatorPolicy::Resizable);
     static constexpr bool DoubleFreePreventionIsEnabled = PolicyContains(Policy, StackAllocatorPolicy::DoubleFreePrevention);
+    static constexpr bool LatencyTrackingIsEnabled      = PolicyContains(Policy, StackAllocatorPolicy::LatencyTracking);
+    static constexpr bool SizeHistogramIsEnabled        = PolicyContains(Policy, StackAllocatorPolicy::SizeHistogram);
+    static constexpr bool WasteTrackingIsEnabled        = PolicyContains(Policy, StackAllocatorPolicy::WasteTracking);
+    static constexpr bool LeakDetectionIsEnabled        = PolicyContains(Policy, StackAllocatorPolicy::LeakDetection);
+    static constexpr bool HeapSamplingIsEnabled         = PolicyContains(Policy, StackAllocatorPolicy::HeapSampling);
+    static constexpr bool TraceRecordingIsEnabled       = PolicyContains(Policy, StackAllocatorPolicy::TraceRecording);
+    static constexpr bool IsTracked                     = UsageTrackingIsEnabled || AllocationTrackingIsEnabled || SizeHistogramIsEnabled ||
+                                                          LatencyTrackingIsEnabled || WasteTrackingIsEnabled || LeakDetectionIsEnabled ||
+                                                          HeapSamplingIsEnabled || TraceRecordingIsEnabled;
+    static constexpr bool HasLargeOffsets               = PolicyContains(Policy, StackAllocatorPolicy::LargeOffsets);
 
-    using InplaceHeader      = typename std::conditional<StackCheckIsEnabled, Internal::StackHeader, Internal::StackHeaderLite>::type;
-    using Header             = Internal::StackHeader;
-    using InplaceArrayHeader = Internal::StackArrayHeader;
-    using ArrayHeader        = Internal::StackArrayHeader;
+  public:
+    using OffsetType = std::conditional_t<HasLargeOffsets, LargeOffset, Offset>;
+
+    template <typename T>
+    using StackPtrType = StackPtr<T, OffsetType>;
+    template <typename T>
+    using StackArrayPtrType = StackArrayPtr<T, OffsetType>;
+
+  private:
+    using InplaceHeader =
+        typename std::conditional<StackCheckIsEnabled, Internal::StackHeader<OffsetType>, Internal::StackHeaderLite<OffsetType>>::type;
+    using Header             = Internal::StackHeader<OffsetType>;
+    using InplaceArrayHeader = Internal::StackArrayHeader<OffsetType>;
+    using ArrayHeader        = Internal::StackArrayHeader<OffsetType>;
+    using FrontGuard         = BoundGuardFront<OffsetType>;
+    using BackGuard          = BoundGuardBack<OffsetType>;
 
     using ThreadPolicy = MultithreadedPolicy<IsMultithreaded>;
 
@@ -124,7 +152,9 @@ class StackAllocator : public Allocator
     using LockGuard = typename ThreadPolicy::template LockGuard<SyncPrimitive>;
     using Mutex     = typename ThreadPolicy::Mutex;
 
-    static constexpr Size BackGuardSize = BoundsCheckIsEnabled ? sizeof(BoundGuardBack) : 0;
+    static constexpr Size BackGuardSize = BoundsCheckIsEnabled ? sizeof(BackGuard) : 0;
+
+    using BaseAllocatorHolder = Internal::BaseAllocatorHolder<BaseAllocator>;
 
   public:
     // Prohibit default construction, moving and assignment
@@ -136,25 +166,50 @@ class StackAllocator : public Allocator
     StackAllocator& operator=(StackAllocator&&) = delete;
 
     explicit StackAllocator(const Size totalSize, const std::string& debugName = "StackAllocator",
-                            std::shared_ptr<Allocator> baseAllocator = Allocator::GetDefaultAllocator())
-        : Allocator(totalSize, debugName), m_StartPtr(baseAllocator->AllocateBase(totalSize)),
-          m_StartAddress(std::bit_cast<UIntPtr>(m_StartPtr)), m_EndAddress(m_StartAddress + totalSize),
-          m_BaseAllocator(std::move(baseAllocator))
+                            typename BaseAllocatorHolder::Argument baseAllocator = Allocator::GetDefaultAllocator())
+        : Allocator(totalSize, debugName, false, IsTracked, BaseAllocatorHolder::GetAllocatorId(baseAllocator)),
+          m_BaseAllocator(std::forward<typename BaseAllocatorHolder::Argument>(baseAllocator)),
+          m_StartPtr(m_BaseAllocator->AllocateBase(CheckTotalSize(totalSize, debugName), Settings.blockAlignment)),
+          m_StartAddress(std::bit_cast<UIntPtr>(m_StartPtr)),
+          // If the base allocator is out of memory, the arena is left empty and every allocation fails
+          m_EndAddress(m_StartPtr != nullptr ? m_StartAddress + totalSize : m_StartAddress)
     {
+        if (m_StartPtr != nullptr)
+        {
+            MEMARENA_PROBE(block_acquire, this, GetProbeName(), m_StartPtr, totalSize);
+            if constexpr (Settings.hooks->onBlockAcquire != nullptr)
+            {
+                Settings.hooks->onBlockAcquire(m_StartPtr, totalSize);
+            }
+        }
+        UpdateFreeSize();
     }
 
-    ~StackAllocator() { m_BaseAllocator->DeallocateBase(m_StartPtr); };
+    ~StackAllocator()
+    {
+        if (m_StartPtr == nullptr)
+        {
+            return;
+        }
+
+        MEMARENA_PROBE(block_release, this, GetProbeName(), m_StartPtr, m_EndAddress - m_StartAddress);
+        if constexpr (Settings.hooks->onBlockRelease != nullptr)
+        {
+            Settings.hooks->onBlockRelease(m_StartPtr, m_EndAddress - m_StartAddress);
+        }
+        m_BaseAllocator->DeallocateBase(m_StartPtr);
+    };
 
     friend bool operator==(const StackAllocator& s1, const StackAllocator& s2) { return s1.m_StartAddress == s2.m_StartAddress; }
 
     template <Allocatable Object, typename... Args>
-    NO_DISCARD StackPtr<Object> New(Args&&... argList)
+    NO_DISCARD StackPtrType<Object> New(Args&&... argList)
     {
-        auto [voidPtr, startOffset, endOffset] = AllocateInternal(sizeof(Object), alignof(Object));
-        RETURN_VAL_IF_NULLPTR(voidPtr, StackPtr<Object>(nullptr, 0, 0));
+        auto [voidPtr, startOffset, endOffset] = AllocateInternal(sizeof(Object), StaticAlignment<alignof(Object)>{});
+        RETURN_VAL_IF_NULLPTR(voidPtr, StackPtrType<Object>(nullptr, 0, 0));
         Object* ptr = static_cast<Object*>(voidPtr);
         ptr         = std::construct_at(ptr, std::forward<Args>(argList)...);
-        return StackPtr<Object>(ptr, startOffset, endOffset);
+        return StackPtrType<Object>(ptr, startOffset, endOffset);
     }
 
     template <Allocatable Object, typename... Args>
@@ -167,12 +222,12 @@ class StackAllocator : public Allocator
     }
 
     template <Allocatable Object, typename... Args>
-    NO_DISCARD StackArrayPtr<Object> NewArray(const Size objectCount, Args&&... argList)
+    NO_DISCARD StackArrayPtrType<Object> NewArray(const Size objectCount, Args&&... argList)
     {
-        auto [voidPtr, startOffset, endOffset] = AllocateInternal(objectCount * sizeof(Object), alignof(Object));
-        RETURN_VAL_IF_NULLPTR(voidPtr, StackArrayPtr<Object>(nullptr, 0, 0));
+        auto [voidPtr, startOffset, endOffset] = AllocateInternal(objectCount * sizeof(Object), StaticAlignment<alignof(Object)>{});
+        RETURN_VAL_IF_NULLPTR(voidPtr, StackArrayPtrType<Object>(nullptr, 0, 0));
         Object* ptr = Internal::ConstructArray<Object>(voidPtr, objectCount, std::forward<Args>(argList)...);
-        return StackArrayPtr<Object>(ptr, startOffset, objectCount);
+        return StackArrayPtrType<Object>(ptr, startOffset, objectCount);
     }
 
     template <Allocatable Object, typename... Args>
@@ -184,7 +239,7 @@ class StackAllocator : public Allocator
     }
 
     template <Allocatable Object>
-    void Delete(StackPtr<Object>& ptr)
+    void Delete(StackPtrType<Object>& ptr)
     {
         DeallocateInternal(ptr);
         ptr->~Object();
@@ -205,52 +260,50 @@ class StackAllocator : public Allocator
     }
 
     template <Allocatable Object>
-    void DeleteArray(StackArrayPtr<Object>& ptr)
+    void DeleteArray(StackArrayPtrType<Object>& ptr)
     {
         const Size objectCount = DeallocateArrayInternal(ptr, sizeof(Object));
         std::destroy_n(ptr.GetPtr(), objectCount);
     }
 
-    NO_DISCARD void* Allocate(const Size size, const Alignment& alignment = defaultAlignment, const std::string& category = "",
+    NO_DISCARD void* Allocate(const Size size, const Alignment& alignment = defaultAlignment, CategoryId category = {},
                               const SourceLocation& sourceLocation = SourceLocation::current())
     {
-        auto [voidPtr, startOffset, endOffset] = AllocateInternal<sizeof(InplaceHeader)>(size, alignment, category, sourceLocation);
-        RETURN_IF_NULLPTR(voidPtr);
-        Internal::AllocateHeader<InplaceHeader>(voidPtr, startOffset, endOffset);
-        return voidPtr;
+        return AllocateWithHeader(size, alignment, category, sourceLocation);
     }
 
     template <typename Object>
-    NO_DISCARD void* Allocate(const std::string& category = "", const SourceLocation& sourceLocation = SourceLocation::current())
+    NO_DISCARD void* Allocate(CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
-        return Allocate(sizeof(Object), alignof(Object), category, sourceLocation);
+        return AllocateWithHeader(sizeof(Object), StaticAlignment<alignof(Object)>{}, category, sourceLocation);
     }
 
     NO_DISCARD void* AllocateArray(const Size objectCount, const Size objectSize, const Alignment& alignment,
-                                   const std::string& category = "", const SourceLocation& sourceLocation = SourceLocation::current())
+                                   CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
-        const Size allocationSize = objectCount * objectSize;
-        auto [voidPtr, startOffset, endOffset] =
-            AllocateInternal<sizeof(InplaceArrayHeader)>(allocationSize, alignment, category, sourceLocation);
-        RETURN_IF_NULLPTR(voidPtr);
-        Internal::AllocateHeader<InplaceArrayHeader>(voidPtr, startOffset, objectCount);
-        return voidPtr;
+        return AllocateArrayWithHeader(objectCount, objectSize, alignment, category, sourceLocation);
     }
 
     template <typename Object>
-    NO_DISCARD void* AllocateArray(const Size objectCount, const std::string& category = "",
+    NO_DISCARD void* AllocateArray(const Size objectCount, CategoryId category = {},
                                    const SourceLocation& sourceLocation = SourceLocation::current())
     {
-        return AllocateArray(objectCount, sizeof(Object), alignof(Object), category, sourceLocation);
+        return AllocateArrayWithHeader(objectCount, sizeof(Object), StaticAlignment<alignof(Object)>{}, category, sourceLocation);
     }
 
     void Deallocate(void*& ptr) { DeallocateInternal(ptr); }
 
-    void Deallocate(StackPtr<void>& ptr) { DeallocateInternal(ptr); }
+    void Deallocate(StackPtrType<void>& ptr) { DeallocateInternal(ptr); }
 
     Size DeallocateArray(void*& ptr, const Size objectSize) { return DeallocateArrayInternal(ptr, objectSize); }
 
-    Size DeallocateArray(StackArrayPtr<void>& ptr, const Size objectSize) { return DeallocateArrayInternal(ptr, objectSize); }
+    Size DeallocateArray(StackArrayPtrType<void>& ptr, const Size objectSize) { return DeallocateArrayInternal(ptr, objectSize); }
+
+    NO_DISCARD void* AllocateBase(const Size size, const Alignment& alignment = defaultAlignment) final
+    {
+        return Allocate(size, alignment);
+    }
+    void DeallocateBase(void* ptr) final { Deallocate(ptr); }
 
     /**
      * @brief Releases the allocator to its initial state. Any further allocations
@@ -262,7 +315,25 @@ class StackAllocator : public Allocator
     inline void Release()
     {
         LockGuard<Mutex> guard(m_MultithreadedPolicy.m_Mutex);
+        MEMARENA_PROBE(release, this, GetProbeName());
         SetCurrentOffset(0);
+
+        if constexpr (WasteTrackingIsEnabled)
+        {
+            ResetWasteSizes();
+        }
+        if constexpr (LeakDetectionIsEnabled)
+        {
+            ClearLiveAllocations();
+        }
+        if constexpr (HeapSamplingIsEnabled)
+        {
+            ClearHeapSamples();
+        }
+        if constexpr (TraceRecordingIsEnabled)
+        {
+            RecordTraceRelease();
+        }
     };
 
     [[nodiscard]] bool Owns(UIntPtr address) const { return address >= m_StartAddress && address <= m_EndAddress; }
@@ -274,6 +345,38 @@ class StackAllocator : public Allocator
     }
 
   private:
+    // Runs in the member initializers, so that an oversized arena is rejected before it is taken from the upstream
+    static Size CheckTotalSize(const Size totalSize, const std::string& debugName)
+    {
+        MEMARENA_DEFAULT_ASSERT(totalSize <= std::numeric_limits<OffsetType>::max(),
+                                "Error: Max size of allocator '%s' cannot be more than %llu! Value passed was %llu. Enable the "
+                                "LargeOffsets policy for larger arenas.\n",
+                                debugName.c_str(), static_cast<ULLInt>(std::numeric_limits<OffsetType>::max()),
+                                static_cast<ULLInt>(totalSize));
+        return totalSize;
+    }
+
+    template <typename AlignmentType>
+    void* AllocateWithHeader(const Size size, const AlignmentType& alignment, CategoryId category, const SourceLocation& sourceLocation)
+    {
+        auto [voidPtr, startOffset, endOffset] = AllocateInternal<sizeof(InplaceHeader)>(size, alignment, category, sourceLocation);
+        RETURN_IF_NULLPTR(voidPtr);
+        Internal::AllocateHeader<InplaceHeader>(voidPtr, startOffset, endOffset);
+        return voidPtr;
+    }
+
+    template <typename AlignmentType>
+    void* AllocateArrayWithHeader(const Size objectCount, const Size objectSize, const AlignmentType& alignment,
+                                  CategoryId category, const SourceLocation& sourceLocation)
+    {
+        const Size allocationSize = objectCount * objectSize;
+        auto [voidPtr, startOffset, endOffset] =
+            AllocateInternal<sizeof(InplaceArrayHeader)>(allocationSize, alignment, category, sourceLocation);
+        RETURN_IF_NULLPTR(voidPtr);
+        Internal::AllocateHeader<InplaceArrayHeader>(voidPtr, startOffset, objectCount);
+        return voidPtr;
+    }
+
     template <typename T>
     void DeallocateInternal(T*& ptr)
     {
@@ -284,7 +387,7 @@ class StackAllocator : public Allocator
     }
 
     template <typename T>
-    void DeallocateInternal(StackPtr<T>& ptr)
+    void DeallocateInternal(StackPtrType<T>& ptr)
     {
         const void*   voidPtr        = ptr.GetPtr();
         const UIntPtr currentAddress = GetAddressFromPtr(voidPtr);
@@ -305,12 +408,12 @@ class StackAllocator : public Allocator
     }
 
     template <typename T>
-    Size DeallocateArrayInternal(StackArrayPtr<T>& ptr, const Size objectSize)
+    Size DeallocateArrayInternal(StackArrayPtrType<T>& ptr, const Size objectSize)
     {
         const void*   voidPtr        = ptr.GetPtr();
         const UIntPtr currentAddress = GetAddressFromPtr(voidPtr);
 
-        const Internal::StackArrayHeader header = ptr.GetHeader();
+        const ArrayHeader header = ptr.GetHeader();
         DeallocateInternal(currentAddress, currentAddress,
                            Header(header.startOffset,
                                   Internal::GetArrayEndOffset(currentAddress, m_StartAddress, header.count, objectSize, BackGuardSize)));
@@ -318,14 +421,15 @@ class StackAllocator : public Allocator
         return header.count;
     }
 
-    template <Size HeaderSize = 0>
-    std::tuple<void*, Offset, Offset> AllocateInternal(const Size size, const Alignment& alignment, const std::string& category = "",
-                                                       const SourceLocation& sourceLocation = SourceLocation::current())
+    template <Size HeaderSize = 0, typename AlignmentType = Alignment>
+    std::tuple<void*, OffsetType, OffsetType> AllocateInternal(const Size size, const AlignmentType& alignment, CategoryId category = {},
+                                                               const SourceLocation& sourceLocation = SourceLocation::current())
     {
-        LockGuard<Mutex> guard(m_MultithreadedPolicy.m_Mutex);
+        [[maybe_unused]] const auto timer = TimeLatency<LatencyTrackingIsEnabled>(LatencyOperation::Allocate);
+        LockGuard<Mutex>            guard(m_MultithreadedPolicy.m_Mutex);
 
-        const Offset  startOffset = m_CurrentOffset;
-        const UIntPtr baseAddress = m_StartAddress + m_CurrentOffset;
+        const OffsetType startOffset = m_CurrentOffset;
+        const UIntPtr    baseAddress = m_StartAddress + m_CurrentOffset;
 
         Padding padding{0};
         UIntPtr alignedAddress{0};
@@ -343,32 +447,64 @@ class StackAllocator : public Allocator
             padding        = alignedAddress - baseAddress;
         }
 
-        Size totalSizeAfterAllocation = m_CurrentOffset + padding + size;
+        // The back guard has to fit too
+        const Size totalSizeAfterAllocation = m_CurrentOffset + padding + size + BackGuardSize;
 
-        MEMARENA_ASSERT_RETURN(totalSizeAfterAllocation <= GetTotalSize(), (std::tuple(nullptr, 0, 0)),
+        if (totalSizeAfterAllocation > m_EndAddress - m_StartAddress)
+        {
+            MEMARENA_PROBE(out_of_memory, this, GetProbeName(), size);
+        }
+        MEMARENA_ASSERT_RETURN(totalSizeAfterAllocation <= m_EndAddress - m_StartAddress, (std::tuple(nullptr, 0, 0)),
                                "Error: The allocator '%s' is out of memory!\n", GetDebugName().c_str());
 
         if constexpr (BoundsCheckIsEnabled)
         {
-            totalSizeAfterAllocation += sizeof(BoundGuardBack);
-
             const UIntPtr frontGuardAddress = alignedAddress - totalHeaderSize;
             const UIntPtr backGuardAddress  = alignedAddress + size;
 
-            new (std::bit_cast<void*>(frontGuardAddress)) BoundGuardFront(m_CurrentOffset, size);
-            new (std::bit_cast<void*>(backGuardAddress)) BoundGuardBack(m_CurrentOffset);
+            new (std::bit_cast<void*>(frontGuardAddress)) FrontGuard(m_CurrentOffset, size);
+
+            // The back guard follows the user's bytes directly, so it is usually misaligned and has to be copied in
+            const BackGuard backGuard(m_CurrentOffset);
+            std::memcpy(std::bit_cast<void*>(backGuardAddress), &backGuard, sizeof(BackGuard));
         }
 
         SetCurrentOffset(totalSizeAfterAllocation);
 
-        const Offset endOffset = m_CurrentOffset;
+        if constexpr (WasteTrackingIsEnabled)
+        {
+            IncreasePaddingSize(padding - totalHeaderSize);
+            IncreaseHeaderSize(totalHeaderSize + BackGuardSize);
+        }
+
+        const OffsetType endOffset = m_CurrentOffset;
 
         void* allocatedPtr = std::bit_cast<void*>(alignedAddress);
 
-        if constexpr (AllocationTrackingIsEnabled)
+        if (ShouldTrack<AllocationTrackingIsEnabled, DynamicTrackingIsEnabled>())
         {
             AddAllocation(size, category, sourceLocation);
         }
+        if constexpr (SizeHistogramIsEnabled)
+        {
+            RecordAllocationSize(size);
+        }
+        if constexpr (LeakDetectionIsEnabled)
+        {
+            AddLiveAllocation(allocatedPtr, size, category, sourceLocation);
+        }
+        if constexpr (HeapSamplingIsEnabled)
+        {
+            SampleAllocation(allocatedPtr, size);
+        }
+        if constexpr (TraceRecordingIsEnabled)
+        {
+            RecordTraceAllocation(allocatedPtr, size, Alignment(alignment), sourceLocation);
+        }
+        if constexpr (Settings.hooks->onAllocate != nullptr)
+        {
+            Settings.hooks->onAllocate(allocatedPtr, size, Alignment(alignment));
+        }
 
         return {allocatedPtr, startOffset, endOffset};
     }
@@ -376,9 +512,10 @@ class StackAllocator : public Allocator
     template <typename Header>
     void DeallocateInternal(const UIntPtr address, const UIntPtr addressMarker, const Header& header)
     {
-        LockGuard<Mutex> guard(m_MultithreadedPolicy.m_Mutex);
+        [[maybe_unused]] const auto timer = TimeLatency<LatencyTrackingIsEnabled>(LatencyOperation::Deallocate);
+        LockGuard<Mutex>            guard(m_MultithreadedPolicy.m_Mutex);
 
-        const Offset newOffset = header.startOffset;
+        const OffsetType newOffset = header.startOffset;
 
         if constexpr (StackCheckIsEnabled)
         {
@@ -388,20 +525,47 @@ class StackAllocator : public Allocator
 
         if constexpr (BoundsCheckIsEnabled)
         {
-            const UIntPtr          frontGuardAddress = addressMarker - sizeof(BoundGuardFront);
-            const BoundGuardFront* frontGuard        = std::bit_cast<BoundGuardFront*>(frontGuardAddress);
+            const UIntPtr     frontGuardAddress = addressMarker - sizeof(FrontGuard);
+            const FrontGuard* frontGuard        = std::bit_cast<FrontGuard*>(frontGuardAddress);
 
-            const UIntPtr         backGuardAddress = address + frontGuard->allocationSize;
-            const BoundGuardBack* backGuard        = std::bit_cast<BoundGuardBack*>(backGuardAddress);
+            const UIntPtr backGuardAddress = address + frontGuard->allocationSize;
+            BackGuard     backGuard(0);
+            std::memcpy(&backGuard, std::bit_cast<const void*>(backGuardAddress), sizeof(BackGuard));
 
-            MEMARENA_ASSERT_RETURN(frontGuard->offset == newOffset && backGuard->offset == newOffset, void(),
+            MEMARENA_ASSERT_RETURN(frontGuard->offset == newOffset && backGuard.offset == newOffset, void(),
                                    "Error: Memory stomping detected in allocator '%s' at offset %d and address %d!\n",
                                    GetDebugName().c_str(), newOffset, address);
         }
 
-        if constexpr (AllocationTrackingIsEnabled)
+        // In LIFO order the allocation ends at the current offset, before its back guard
+        [[maybe_unused]] const Size size = m_StartAddress + m_CurrentOffset - BackGuardSize - address;
+
+        if (ShouldTrack<AllocationTrackingIsEnabled, DynamicTrackingIsEnabled>())
+        {
+            AddDeallocation(size);
+        }
+        if constexpr (WasteTrackingIsEnabled)
+        {
+            // The front guard and the inplace header (if any) sit right before the address, and the padding before them
+            const Size headerSize = address - addressMarker + GetTotalHeaderSize<0>();
+            DecreasePaddingSize(address - (m_StartAddress + newOffset) - headerSize);
+            DecreaseHeaderSize(headerSize + BackGuardSize);
+        }
+        if constexpr (LeakDetectionIsEnabled)
+        {
+            RemoveLiveAllocation(std::bit_cast<void*>(address));
+        }
+        if constexpr (HeapSamplingIsEnabled)
         {
-            AddDeallocation();
+            RemoveHeapSample(std::bit_cast<void*>(address));
+        }
+        if constexpr (TraceRecordingIsEnabled)
+        {
+            RecordTraceDeallocation(std::bit_cast<void*>(address));
+        }
+        if constexpr (Settings.hooks->onDeallocate != nullptr)
+        {
+            Settings.hooks->onDeallocate(std::bit_cast<void*>(address), size);
         }
 
         SetCurrentOffset(newOffset);
@@ -430,7 +594,7 @@ class StackAllocator : public Allocator
     {
         if constexpr (BoundsCheckIsEnabled)
         {
-            return headerSize + sizeof(BoundGuardFront);
+            return headerSize + sizeof(FrontGuard);
         }
         else
         {
@@ -438,13 +602,32 @@ class StackAllocator : public Allocator
         }
     }
 
-    void SetCurrentOffset(const Offset offset)
+    void SetCurrentOffset(const OffsetType offset)
     {
+        if (ShouldTrack<UsageTrackingIsEnabled, DynamicTrackingIsEnabled>())
+        {
+            // The used size of a stack is its offset
+            if (ShouldResyncUsedSize<DynamicTrackingIsEnabled>()) [[unlikely]]
+            {
+                SetUsedSize(offset);
+            }
+            else
+            {
+                ChangeUsedSize(m_CurrentOffset, offset);
+            }
+        }
+
         m_CurrentOffset = offset;
+        UpdateFreeSize();
+    }
 
-        if constexpr (UsageTrackingIsEnabled)
+    // The free memory of a stack is always the single run above the current offset
+    inline void UpdateFreeSize()
+    {
+        if constexpr (WasteTrackingIsEnabled)
         {
-            SetUsedSize(m_CurrentOffset);
+            const Size freeSize = (m_EndAddress - m_StartAddress) - m_CurrentOffset;
+            SetFreeSize(freeSize, freeSize);
         }
     }
 
@@ -458,7 +641,7 @@ class StackAllocator : public Allocator
     }
 
     template <typename T>
-    inline void CheckDoubleFree(StackPtr<T>& ptr)
+    inline void CheckDoubleFree(StackPtrType<T>& ptr)
     {
         if constexpr (DoubleFreePreventionIsEnabled)
         {
@@ -467,7 +650,7 @@ class StackAllocator : public Allocator
     }
 
     template <typename T>
-    inline void CheckDoubleFree(StackArrayPtr<T>& ptr)
+    inline void CheckDoubleFree(StackArrayPtrType<T>& ptr)
     {
         if constexpr (DoubleFreePreventionIsEnabled)
         {
@@ -475,6 +658,9 @@ class StackAllocator : public Allocator
         }
     }
 
+    // Declared before the block below, since the start pointer is allocated from it
+    BaseAllocatorHolder m_BaseAllocator;
+
     ThreadPolicy m_MultithreadedPolicy;
 
     // Dont change member variable declaration order in this block!
@@ -483,9 +669,7 @@ class StackAllocator : public Allocator
     UIntPtr m_EndAddress;
     // -------------------
 
-    Offset m_CurrentOffset = 0;
-
-    std::shared_ptr<Allocator> m_BaseAllocator;
+    OffsetType m_CurrentOffset = 0;
 };
 
 // template <StackAllocatorPolicy policy>
@@ -8,6 +8,11 @@ template <Allocatable Object, auto Settings = StackAllocatorSettings()>
 class StackAllocatorTemplated
 {
   public:
+    template <typename T>
+    using StackPtr = typename StackAllocator<Settings>::template StackPtrType<T>;
+    template <typename T>
+    using StackArrayPtr = typename StackAllocator<Settings>::template StackArrayPtrType<T>;
+
     StackAllocatorTemplated()                               = delete;
     StackAllocatorTemplated(StackAllocatorTemplated&)       = delete;
     StackAllocatorTemplated(const StackAllocatorTemplated&) = delete;
@@ -54,13 +59,13 @@ class StackAllocatorTemplated
 
     void DeleteArray(StackArrayPtr<Object> ptr) { m_StackAllocator.DeleteArray(ptr); }
 
-    NO_DISCARD void* Allocate(const Size size, const Alignment& alignment = defaultAlignment, const std::string& category = "",
+    NO_DISCARD void* Allocate(const Size size, const Alignment& alignment = defaultAlignment, CategoryId category = {},
                               const SourceLocation& sourceLocation = SourceLocation::current())
     {
         return m_StackAllocator.Allocate(size, alignment, category, sourceLocation);
     }
 
-    NO_DISCARD void* Allocate(const std::string& category = "", const SourceLocation& sourceLocation = SourceLocation::current())
+    NO_DISCARD void* Allocate(CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
         return m_StackAllocator.Allocate(sizeof(Object), alignof(Object), category, sourceLocation);
     }
@@ -70,12 +75,12 @@ class StackAllocatorTemplated
     void Deallocate(const StackPtr<void>& ptr) { m_StackAllocator.Deallocate(ptr); }
 
     NO_DISCARD void* AllocateArray(const Size objectCount, const Size objectSize, const Alignment& alignment,
-                                   const std::string& category = "", const SourceLocation& sourceLocation = SourceLocation::current())
+                                   CategoryId category = {}, const SourceLocation& sourceLocation = SourceLocation::current())
     {
         return m_StackAllocator.AllocateArray(objectCount, objectSize, alignment, category, sourceLocation);
     }
 
-    NO_DISCARD void* AllocateArray(const Size objectCount, const std::string& category = "",
+    NO_DISCARD void* AllocateArray(const Size objectCount, CategoryId category = {},
                                    const SourceLocation& sourceLocation = SourceLocation::current())
     {
         return AllocateArray(objectCount, sizeof(Object), alignof(Object), category, sourceLocation);
@@ -0,0 +1,106 @@
+#include "PCH.hpp"
+
+#include "CallSite.hpp"
+
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Memarena
+{
+
+namespace
+{
+struct CallSiteTable
+{
+    std::mutex                                  mutex;
+    std::vector<CallSite>                       callSites{CallSite{}};
+    std::unordered_map<std::string, CallSiteId> ids;
+};
+
+CallSiteTable& GetCallSiteTable()
+{
+    static CallSiteTable table;
+    return table;
+}
+
+// Source locations from different translation units can point to different copies of the same file name, so the
+// registry compares the strings. The per-thread cache only compares pointers, and may hold several entries for a site.
+struct CachedCallSite
+{
+    const char* fileName     = nullptr;
+    const char* functionName = nullptr;
+    UInt32      line         = 0;
+    UInt32      column       = 0;
+    CallSiteId  id;
+};
+
+constexpr Size callSiteCacheSize = 64;
+
+thread_local CachedCallSite callSiteCache[callSiteCacheSize];
+
+CallSiteId RegisterSlow(const SourceLocation& sourceLocation)
+{
+    CallSiteTable&              table = GetCallSiteTable();
+    std::lock_guard<std::mutex> guard(table.mutex);
+
+    std::string key = std::string(sourceLocation.file_name()) + ':' + std::to_string(sourceLocation.line()) + ':' +
+                      std::to_string(sourceLocation.column()) + ':' + sourceLocation.function_name();
+
+    const auto it = table.ids.find(key);
+    if (it != table.ids.end())
+    {
+        return it->second;
+    }
+
+    if (table.callSites.size() > std::numeric_limits<UInt16>::max())
+    {
+        return unknownCallSite;
+    }
+
+    const CallSiteId id{static_cast<UInt16>(table.callSites.size())};
+    table.callSites.push_back({sourceLocation.file_name(), sourceLocation.function_name(), sourceLocation.line()});
+    table.ids.emplace(std::move(key), id);
+    return id;
+}
+} // namespace
+
+CallSiteId CallSiteRegistry::Register(const SourceLocation& sourceLocation)
+{
+    const char* fileName     = sourceLocation.file_name();
+    const char* functionName = sourceLocation.function_name();
+    const auto  line         = static_cast<UInt32>(sourceLocation.line());
+    const auto  column       = static_cast<UInt32>(sourceLocation.column());
+
+    const Size      index  = (std::bit_cast<UIntPtr>(fileName) ^ (line * 31 + column)) % callSiteCacheSize;
+    CachedCallSite& cached = callSiteCache[index];
+
+    if (cached.fileName == fileName && cached.functionName == functionName && cached.line == line && cached.column == column)
+    {
+        return cached.id;
+    }
+
+    const CallSiteId id = RegisterSlow(sourceLocation);
+    cached              = {fileName, functionName, line, column, id};
+    return id;
+}
+
+CallSite CallSiteRegistry::Get(const CallSiteId id)
+{
+    CallSiteTable&              table = GetCallSiteTable();
+    std::lock_guard<std::mutex> guard(table.mutex);
+
+    return id.value < table.callSites.size() ? table.callSites[id.value] : CallSite{};
+}
+
+Size CallSiteRegistry::GetCallSiteCount()
+{
+    CallSiteTable&              table = GetCallSiteTable();
+    std::lock_guard<std::mutex> guard(table.mutex);
+
+    return table.callSites.size();
+}
+
+} // namespace Memarena
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Source/Aliases.hpp"
+#include "Source/TypeAliases.hpp"
+
+namespace Memarena
+{
+
+/**
+ * @brief An interned source location. Id 0 is the unknown call site, which is also returned once the table is full.
+ */
+struct CallSiteId
+{
+    UInt16 value = 0;
+
+    friend constexpr bool operator==(CallSiteId, CallSiteId) = default;
+};
+
+constexpr CallSiteId unknownCallSite{};
+
+struct CallSite
+{
+    const char* fileName     = "";
+    const char* functionName = "";
+    UInt32      line         = 0;
+};
+
+class CallSiteRegistry
+{
+  public:
+    /**
+     * @brief Interns a source location. Repeated lookups of a call site are answered from a small per-thread cache, so
+     * only the first allocation from a call site on each thread takes the registry lock.
+     */
+    static CallSiteId Register(const SourceLocation& sourceLocation);
+
+    [[nodiscard]] static CallSite Get(CallSiteId id);
+
+    // The number of registered call sites, including the unknown call site
+    [[nodiscard]] static Size GetCallSiteCount();
+};
+
+} // namespace Memarena
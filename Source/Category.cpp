@@ -0,0 +1,68 @@
+#include "PCH.hpp"
+
+#include "Category.hpp"
+
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "Assert.hpp"
+
+namespace Memarena
+{
+
+namespace
+{
+struct CategoryTable
+{
+    std::mutex                                   mutex;
+    std::deque<std::string>                      names{""}; // A deque so that views of the names stay valid
+    std::unordered_map<std::string_view, UInt16> ids{{names.front(), 0}};
+};
+
+// Categories are registered during static initialization, so the table has to be created on first use
+CategoryTable& GetCategoryTable()
+{
+    static CategoryTable table;
+    return table;
+}
+} // namespace
+
+CategoryId CategoryRegistry::Register(const std::string_view name)
+{
+    CategoryTable&              table = GetCategoryTable();
+    std::lock_guard<std::mutex> guard(table.mutex);
+
+    const auto it = table.ids.find(name);
+    if (it != table.ids.end())
+    {
+        return {it->second};
+    }
+
+    MEMARENA_DEFAULT_ASSERT(table.names.size() <= std::numeric_limits<UInt16>::max(), "Error: Too many allocation categories!\n")
+
+    const auto id = static_cast<UInt16>(table.names.size());
+    table.names.emplace_back(name);
+    table.ids.emplace(table.names.back(), id);
+    return {id};
+}
+
+std::string_view CategoryRegistry::GetName(const CategoryId id)
+{
+    CategoryTable&              table = GetCategoryTable();
+    std::lock_guard<std::mutex> guard(table.mutex);
+
+    return id.value < table.names.size() ? std::string_view(table.names[id.value]) : std::string_view();
+}
+
+Size CategoryRegistry::GetCategoryCount()
+{
+    CategoryTable&              table = GetCategoryTable();
+    std::lock_guard<std::mutex> guard(table.mutex);
+
+    return table.names.size();
+}
+
+} // namespace Memarena
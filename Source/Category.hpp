@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string_view>
+
+#include "Source/Aliases.hpp"
+#include "Source/Utility/FixedString.hpp"
+
+namespace Memarena
+{
+
+/**
+ * @brief An interned allocation category. Allocators take and store this instead of the category name, so tagging an
+ * allocation costs one integer. Id 0 is the empty category.
+ */
+struct CategoryId
+{
+    UInt16 value = 0;
+
+    friend constexpr bool operator==(CategoryId, CategoryId) = default;
+};
+
+constexpr CategoryId noCategory{};
+
+class CategoryRegistry
+{
+  public:
+    /**
+     * @brief Interns a category name. Registering the same name again returns the same id.
+     */
+    static CategoryId Register(std::string_view name);
+
+    /**
+     * @brief Returns the name a category was registered with, or an empty view for unknown ids.
+     */
+    [[nodiscard]] static std::string_view GetName(CategoryId id);
+
+    // The number of registered categories, including the empty category
+    [[nodiscard]] static Size GetCategoryCount();
+};
+
+/**
+ * @brief A category tag known at compile time, e.g. `stackAllocator.Allocate<int>(Category<"Rendering">{})`. The name is
+ * interned once during static initialization, so passing the tag only passes its id.
+ */
+template <FixedString Name>
+struct Category
+{
+    static inline const CategoryId id = CategoryRegistry::Register(Name.View());
+
+    operator CategoryId() const noexcept { return id; } // NOLINT
+};
+
+} // namespace Memarena
@@ -0,0 +1,191 @@
+#include "PCH.hpp"
+
+#include "HeapProfiler.hpp"
+
+#include <cmath>
+
+namespace Memarena
+{
+
+namespace
+{
+std::atomic<Size> sampleInterval = HeapSampler::defaultSampleInterval;
+
+// While sampling is off, each thread checks for a new interval after this many bytes
+constexpr Int64 disabledCheckInterval = Int64(1) << 20;
+// Keeps the drawn distance far from overflowing the counter
+constexpr double maxSampleDistance = 4611686018427387904.0; // 2^62
+} // namespace
+
+void HeapSampler::SetSampleInterval(const Size interval)
+{
+    sampleInterval.store(interval, std::memory_order_relaxed);
+    // The calling thread moves to the new interval right away
+    [[maybe_unused]] const bool isSampled = PickNextSample();
+}
+
+Size HeapSampler::GetSampleInterval() { return sampleInterval.load(std::memory_order_relaxed); }
+
+bool HeapSampler::PickNextSample() noexcept
+{
+    // The first call of a thread only seeds its generator, so a thread's first allocation is never sampled
+    const bool isSeeded = t_RandomState != 0;
+    if (!isSeeded)
+    {
+        const auto time = static_cast<UInt64>(std::chrono::steady_clock::now().time_since_epoch().count());
+        t_RandomState   = (static_cast<UInt64>(std::bit_cast<UIntPtr>(&t_RandomState)) ^ time) | 1;
+    }
+
+    const Size interval = GetSampleInterval();
+    if (interval == 0)
+    {
+        t_BytesUntilSample = disabledCheckInterval;
+        return false;
+    }
+
+    // xorshift64*, then a uniform value in (0, 1] from the top 53 bits
+    t_RandomState ^= t_RandomState >> 12;
+    t_RandomState ^= t_RandomState << 25;
+    t_RandomState ^= t_RandomState >> 27;
+    const UInt64 random  = t_RandomState * 0x2545F4914F6CDD1DULL;
+    const double uniform = (static_cast<double>(random >> 11) + 1.0) / 9007199254740992.0;
+
+    const double distance = -std::log(uniform) * static_cast<double>(interval);
+    t_BytesUntilSample    = static_cast<Int64>(std::min(distance, maxSampleDistance)) + 1;
+
+    return isSeeded;
+}
+
+void HeapSampleTable::Insert(const void* ptr, const Size size, const StackTrace& stackTrace)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
+    const std::lock_guard<std::mutex> guard(m_Mutex);
+
+    const auto [it, inserted] = m_LiveSamples.try_emplace(ptr);
+    if (inserted)
+    {
+        m_Filter[GetFilterIndex(ptr)].fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        AddToFreed(it->second);
+    }
+    it->second = {.size = size, .stackTrace = stackTrace};
+}
+
+void HeapSampleTable::EraseSampled(const void* ptr)
+{
+    const std::lock_guard<std::mutex> guard(m_Mutex);
+
+    const auto it = m_LiveSamples.find(ptr);
+    if (it == m_LiveSamples.end())
+    {
+        return;
+    }
+
+    AddToFreed(it->second);
+    m_LiveSamples.erase(it);
+    m_Filter[GetFilterIndex(ptr)].fetch_sub(1, std::memory_order_relaxed);
+}
+
+std::optional<HeapSampleTable::Sample> HeapSampleTable::ExtractSampled(const void* ptr)
+{
+    const std::lock_guard<std::mutex> guard(m_Mutex);
+
+    const auto it = m_LiveSamples.find(ptr);
+    if (it == m_LiveSamples.end())
+    {
+        return std::nullopt;
+    }
+
+    Sample sample = std::move(it->second);
+    m_LiveSamples.erase(it);
+    m_Filter[GetFilterIndex(ptr)].fetch_sub(1, std::memory_order_relaxed);
+    return sample;
+}
+
+void HeapSampleTable::AddFreed(const Sample& sample)
+{
+    const std::lock_guard<std::mutex> guard(m_Mutex);
+    AddToFreed(sample);
+}
+
+void HeapSampleTable::Clear()
+{
+    const std::lock_guard<std::mutex> guard(m_Mutex);
+
+    for (const auto& [ptr, sample] : m_LiveSamples)
+    {
+        AddToFreed(sample);
+    }
+    m_LiveSamples.clear();
+
+    for (std::atomic<UInt16>& count : m_Filter)
+    {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::vector<HeapProfileEntry> HeapSampleTable::GetHeapProfile() const
+{
+    std::vector<HeapProfileEntry> profile;
+    AccumulateInto(profile);
+    SortHeapProfile(profile);
+    return profile;
+}
+
+void HeapSampleTable::AccumulateInto(std::vector<HeapProfileEntry>& profile) const
+{
+    std::unordered_map<StackTrace, Size, StackTraceHash> entryIndices;
+    for (Size i = 0; i < profile.size(); i++)
+    {
+        entryIndices.emplace(profile[i].stackTrace, i);
+    }
+
+    const auto getEntry = [&](const StackTrace& stackTrace) -> HeapProfileEntry& {
+        const auto [it, inserted] = entryIndices.emplace(stackTrace, profile.size());
+        if (inserted)
+        {
+            profile.push_back({.stackTrace = stackTrace});
+        }
+        return profile[it->second];
+    };
+
+    const std::lock_guard<std::mutex> guard(m_Mutex);
+
+    for (const auto& [ptr, sample] : m_LiveSamples)
+    {
+        HeapProfileEntry& entry = getEntry(sample.stackTrace);
+        entry.liveCount++;
+        entry.liveSize += sample.size;
+        entry.allocatedCount++;
+        entry.allocatedSize += sample.size;
+    }
+
+    for (const auto& [stackTrace, freedSamples] : m_FreedSamples)
+    {
+        HeapProfileEntry& entry = getEntry(stackTrace);
+        entry.allocatedCount += freedSamples.count;
+        entry.allocatedSize += freedSamples.size;
+    }
+}
+
+void HeapSampleTable::AddToFreed(const Sample& sample)
+{
+    FreedSamples& freedSamples = m_FreedSamples[sample.stackTrace];
+    freedSamples.count++;
+    freedSamples.size += sample.size;
+}
+
+void SortHeapProfile(std::vector<HeapProfileEntry>& profile)
+{
+    std::ranges::sort(profile, [](const HeapProfileEntry& a, const HeapProfileEntry& b) {
+        return a.liveSize != b.liveSize ? a.liveSize > b.liveSize : a.allocatedSize > b.allocatedSize;
+    });
+}
+
+} // namespace Memarena
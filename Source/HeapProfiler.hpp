@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "Source/Aliases.hpp"
+#include "Source/Utility/StackTrace.hpp"
+
+namespace Memarena
+{
+
+// The sampled allocations made from one stack
+struct HeapProfileEntry
+{
+    StackTrace stackTrace;
+    Size       liveCount      = 0;
+    Size       liveSize       = 0;
+    Size       allocatedCount = 0; // Includes the live allocations
+    Size       allocatedSize  = 0;
+};
+
+/**
+ * @brief Picks the allocations that the HeapSampling policy records. As in tcmalloc, the bytes between two samples are
+ * drawn from an exponential distribution with the sample interval as its mean, so every byte has the same chance of
+ * being sampled and allocation patterns cannot line up with a fixed period. Each thread counts its own bytes, so the fast
+ * path is a thread local subtraction.
+ */
+class HeapSampler
+{
+  public:
+    static constexpr Size defaultSampleInterval = 512 * 1024; // The tcmalloc default
+
+    // An interval of 0 turns sampling off. Other threads pick up a new interval after their next sample
+    static void SetSampleInterval(Size interval);
+    [[nodiscard]] static Size GetSampleInterval();
+
+    // Counts `size` bytes towards the next sample, and returns true if this allocation is to be sampled
+    [[nodiscard]] static inline bool ShouldSample(const Size size) noexcept
+    {
+        t_BytesUntilSample -= static_cast<Int64>(std::min<Size>(size, std::numeric_limits<Int64>::max()));
+        if (t_BytesUntilSample > 0) [[likely]]
+        {
+            return false;
+        }
+        return PickNextSample();
+    }
+
+  private:
+    static bool PickNextSample() noexcept;
+
+    inline static thread_local Int64  t_BytesUntilSample = 0;
+    inline static thread_local UInt64 t_RandomState      = 0; // 0 until the thread has been seeded
+};
+
+/**
+ * @brief The sampled allocations of an allocator that are still live, with their stacks. The totals of the freed samples
+ * are kept by stack, so the profile can also show where memory was allocated over the whole run.
+ *
+ * Every deallocation has to check whether its allocation was sampled, which is rare. A counting filter over the addresses
+ * answers that with one relaxed load, and the lock is only taken on a hit.
+ */
+class HeapSampleTable
+{
+  public:
+    struct Sample
+    {
+        Size       size = 0;
+        StackTrace stackTrace;
+    };
+
+    void Insert(const void* ptr, Size size, const StackTrace& stackTrace);
+    inline void Erase(const void* ptr)
+    {
+        if (m_Filter[GetFilterIndex(ptr)].load(std::memory_order_relaxed) != 0) [[unlikely]]
+        {
+            EraseSampled(ptr);
+        }
+    }
+    // Takes the sample of `ptr` out without counting it as freed, or returns nothing if `ptr` was not sampled. Put it back
+    // with Insert, or count it as freed with AddFreed
+    [[nodiscard]] inline std::optional<Sample> Extract(const void* ptr)
+    {
+        if (m_Filter[GetFilterIndex(ptr)].load(std::memory_order_relaxed) != 0) [[unlikely]]
+        {
+            return ExtractSampled(ptr);
+        }
+        return std::nullopt;
+    }
+    void AddFreed(const Sample& sample);
+    // Forgets the live samples, counting them as freed
+    void Clear();
+
+    // The samples grouped by stack. The counts are of samples, which pprof scales back up using the sample interval
+    [[nodiscard]] std::vector<HeapProfileEntry> GetHeapProfile() const;
+    // Adds the samples to `profile`, merging them into the entries with the same stack
+    void AccumulateInto(std::vector<HeapProfileEntry>& profile) const;
+
+  private:
+    static constexpr Size filterSize = 1024;
+
+    struct FreedSamples
+    {
+        Size count = 0;
+        Size size  = 0;
+    };
+
+    static inline Size GetFilterIndex(const void* ptr)
+    {
+        const UInt64 hash = static_cast<UInt64>(std::bit_cast<UIntPtr>(ptr)) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<Size>(hash >> (64 - std::countr_zero(filterSize)));
+    }
+
+    void                  EraseSampled(const void* ptr);
+    std::optional<Sample> ExtractSampled(const void* ptr);
+    // Must be called with the lock held
+    void AddToFreed(const Sample& sample);
+
+    std::array<std::atomic<UInt16>, filterSize>                  m_Filter{};
+    std::unordered_map<const void*, Sample>                      m_LiveSamples;
+    std::unordered_map<StackTrace, FreedSamples, StackTraceHash> m_FreedSamples;
+    mutable std::mutex                                           m_Mutex;
+};
+
+// Sorts a profile by live size, largest first, then by allocated size
+void SortHeapProfile(std::vector<HeapProfileEntry>& profile);
+
+} // namespace Memarena
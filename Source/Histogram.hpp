@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <new>
+#include <vector>
+
+#include "Source/Aliases.hpp"
+#include "Source/Macros.hpp"
+
+namespace Memarena
+{
+
+struct HistogramBucket
+{
+    UInt64 lowerBound = 0; // The smallest value counted in the bucket
+    UInt64 upperBound = 0; // The largest value counted in the bucket
+    UInt64 count      = 0;
+};
+
+/**
+ * @brief Counts values in power of 2 buckets that are each split into 2^SubBucketBits linear sub-buckets, so every
+ * bucket spans at most 1/2^SubBucketBits of its lower bound. Values below the sub-bucket count get a bucket each.
+ * Recording is lock-free and only allocates the counters on the first record.
+ */
+template <Size SubBucketBits>
+class LogLinearHistogram
+{
+  public:
+    static constexpr Size subBucketCount = Size(1) << SubBucketBits;
+    static constexpr Size bucketCount    = subBucketCount + (64 - SubBucketBits) * subBucketCount;
+
+    LogLinearHistogram() = default;
+    ~LogLinearHistogram() { delete[] m_Counts.load(std::memory_order_relaxed); }
+
+    LogLinearHistogram(const LogLinearHistogram&) = delete;
+    LogLinearHistogram(LogLinearHistogram&&)      = delete;
+    LogLinearHistogram& operator=(const LogLinearHistogram&) = delete;
+    LogLinearHistogram& operator=(LogLinearHistogram&&) = delete;
+
+    static constexpr Size GetBucketIndex(const UInt64 value)
+    {
+        if (value < subBucketCount)
+        {
+            return value;
+        }
+
+        const Size exponent = std::bit_width(value) - 1;
+        const Size subIndex = (value >> (exponent - SubBucketBits)) & (subBucketCount - 1);
+        return subBucketCount + (exponent - SubBucketBits) * subBucketCount + subIndex;
+    }
+
+    static constexpr UInt64 GetBucketLowerBound(const Size index)
+    {
+        if (index < subBucketCount)
+        {
+            return index;
+        }
+
+        const Size shift    = (index - subBucketCount) / subBucketCount;
+        const Size subIndex = (index - subBucketCount) % subBucketCount;
+        return (subBucketCount + subIndex) << shift;
+    }
+
+    static constexpr UInt64 GetBucketUpperBound(const Size index)
+    {
+        if (index < subBucketCount)
+        {
+            return index;
+        }
+
+        return GetBucketLowerBound(index) + ((UInt64(1) << ((index - subBucketCount) / subBucketCount)) - 1);
+    }
+
+    inline void Record(const UInt64 value) noexcept
+    {
+        std::atomic<UInt64>* counts = m_Counts.load(std::memory_order_acquire);
+        if (counts == nullptr)
+        {
+            counts = CreateCounts();
+            RETURN_VAL_IF_NULLPTR(counts, void());
+        }
+
+        counts[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] UInt64 GetCount(const Size index) const
+    {
+        const std::atomic<UInt64>* counts = m_Counts.load(std::memory_order_acquire);
+        return counts == nullptr || index >= bucketCount ? 0 : counts[index].load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] UInt64 GetTotalCount() const
+    {
+        UInt64 totalCount = 0;
+        for (Size i = 0; i < bucketCount; i++)
+        {
+            totalCount += GetCount(i);
+        }
+        return totalCount;
+    }
+
+    // The buckets that have a count, smallest values first
+    [[nodiscard]] std::vector<HistogramBucket> GetBuckets() const { return MakeBuckets(GetCounts()); }
+
+    // A copy of the count of every bucket
+    [[nodiscard]] std::vector<UInt64> GetCounts() const
+    {
+        std::vector<UInt64> counts(bucketCount);
+        AccumulateInto(counts);
+        return counts;
+    }
+
+    // Adds the count of every bucket to `counts`, which must have bucketCount entries
+    void AccumulateInto(std::vector<UInt64>& counts) const
+    {
+        const std::atomic<UInt64>* histogramCounts = m_Counts.load(std::memory_order_acquire);
+        if (histogramCounts == nullptr)
+        {
+            return;
+        }
+
+        for (Size i = 0; i < bucketCount; i++)
+        {
+            counts[i] += histogramCounts[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    // Turns bucketCount per-bucket counts into the buckets that have a count
+    [[nodiscard]] static std::vector<HistogramBucket> MakeBuckets(const std::vector<UInt64>& counts)
+    {
+        std::vector<HistogramBucket> buckets;
+        for (Size i = 0; i < bucketCount; i++)
+        {
+            if (counts[i] != 0)
+            {
+                buckets.push_back({.lowerBound = GetBucketLowerBound(i), .upperBound = GetBucketUpperBound(i), .count = counts[i]});
+            }
+        }
+        return buckets;
+    }
+
+    /**
+     * @brief The upper bound of the bucket that holds the value at `percentile` (0 to 100) of bucketCount per-bucket
+     * counts. The result overestimates the exact value by less than a sub-bucket. Zero if there are no counts.
+     */
+    [[nodiscard]] static UInt64 GetValueAtPercentile(const std::vector<UInt64>& counts, const double percentile)
+    {
+        UInt64 totalCount = 0;
+        for (const UInt64 count : counts)
+        {
+            totalCount += count;
+        }
+
+        const auto targetCount     = static_cast<UInt64>(std::ceil(percentile / 100.0 * static_cast<double>(totalCount)));
+        UInt64     cumulativeCount = 0;
+        for (Size i = 0; i < bucketCount; i++)
+        {
+            cumulativeCount += counts[i];
+            if (counts[i] != 0 && cumulativeCount >= std::max<UInt64>(targetCount, 1))
+            {
+                return GetBucketUpperBound(i);
+            }
+        }
+        return 0;
+    }
+
+  private:
+    std::atomic<UInt64>* CreateCounts()
+    {
+        std::atomic<UInt64>* newCounts = new (std::nothrow) std::atomic<UInt64>[bucketCount]();
+        RETURN_VAL_IF_NULLPTR(newCounts, nullptr);
+
+        // Another thread may have created the counters in the meantime, in which case we use theirs
+        std::atomic<UInt64>* expected = nullptr;
+        if (!m_Counts.compare_exchange_strong(expected, newCounts, std::memory_order_acq_rel))
+        {
+            delete[] newCounts;
+            return expected;
+        }
+
+        return newCounts;
+    }
+
+    std::atomic<std::atomic<UInt64>*> m_Counts{nullptr};
+};
+
+// Requested sizes. Buckets are at most a quarter of their lower bound wide
+using SizeHistogram = LogLinearHistogram<2>;
+// Durations in cycle counter ticks. Buckets are at most a 16th of their lower bound wide
+using LatencyHistogram = LogLinearHistogram<4>;
+
+static_assert(SizeHistogram::GetBucketIndex(~UInt64(0)) == SizeHistogram::bucketCount - 1);
+static_assert(SizeHistogram::GetBucketUpperBound(SizeHistogram::bucketCount - 1) == ~UInt64(0));
+static_assert(LatencyHistogram::GetBucketUpperBound(LatencyHistogram::bucketCount - 1) == ~UInt64(0));
+
+} // namespace Memarena
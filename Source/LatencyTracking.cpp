@@ -0,0 +1,31 @@
+#include "PCH.hpp"
+
+#include "LatencyTracking.hpp"
+
+namespace Memarena
+{
+
+LatencyPercentiles CalculateLatencyPercentiles(const std::vector<UInt64>& counts)
+{
+    LatencyPercentiles percentiles;
+    for (Size i = 0; i < LatencyHistogram::bucketCount; i++)
+    {
+        percentiles.count += counts[i];
+        if (counts[i] != 0)
+        {
+            percentiles.max = CyclesToNanoseconds(LatencyHistogram::GetBucketUpperBound(i));
+        }
+    }
+
+    if (percentiles.count == 0)
+    {
+        return percentiles;
+    }
+
+    percentiles.p50  = CyclesToNanoseconds(LatencyHistogram::GetValueAtPercentile(counts, 50.0));
+    percentiles.p99  = CyclesToNanoseconds(LatencyHistogram::GetValueAtPercentile(counts, 99.0));
+    percentiles.p999 = CyclesToNanoseconds(LatencyHistogram::GetValueAtPercentile(counts, 99.9));
+    return percentiles;
+}
+
+} // namespace Memarena
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+
+#include "Source/Aliases.hpp"
+#include "Source/Histogram.hpp"
+#include "Source/Utility/CycleClock.hpp"
+
+namespace Memarena
+{
+
+enum class LatencyOperation : UInt8
+{
+    Allocate,
+    Deallocate,
+    BlockRefill, // Getting a new block from the upstream allocator. Also counted in the allocation that caused it
+};
+
+constexpr Size latencyOperationCount = 3;
+
+// Durations in nanoseconds
+struct LatencyPercentiles
+{
+    UInt64 count = 0;
+    UInt64 p50   = 0;
+    UInt64 p99   = 0;
+    UInt64 p999  = 0;
+    UInt64 max   = 0;
+};
+
+/**
+ * @brief Summarizes the per-bucket counts of a LatencyHistogram. Each percentile is the upper bound of its bucket, so
+ * it overestimates the exact duration by at most 1/16.
+ */
+LatencyPercentiles CalculateLatencyPercentiles(const std::vector<UInt64>& counts);
+
+namespace Internal
+{
+// Records the cycles between its construction and destruction
+template <bool Enabled>
+class ScopedLatencyTimer
+{
+  public:
+    explicit ScopedLatencyTimer(LatencyHistogram& histogram) : m_Histogram(histogram), m_StartCycles(ReadCycleCounter()) {}
+    ~ScopedLatencyTimer() { m_Histogram.Record(ReadCycleCounter() - m_StartCycles); }
+
+    ScopedLatencyTimer(const ScopedLatencyTimer&) = delete;
+    ScopedLatencyTimer(ScopedLatencyTimer&&)      = delete;
+    ScopedLatencyTimer& operator=(const ScopedLatencyTimer&) = delete;
+    ScopedLatencyTimer& operator=(ScopedLatencyTimer&&) = delete;
+
+  private:
+    LatencyHistogram& m_Histogram;
+    UInt64            m_StartCycles;
+};
+
+template <>
+class ScopedLatencyTimer<false>
+{
+  public:
+    explicit ScopedLatencyTimer(LatencyHistogram& /*histogram*/) {}
+};
+} // namespace Internal
+
+} // namespace Memarena
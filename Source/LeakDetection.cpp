@@ -0,0 +1,261 @@
+#include "PCH.hpp"
+
+#include "LeakDetection.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
+#include "Source/Macros.hpp"
+#include "Utility/VirtualMemory.hpp"
+
+namespace Memarena
+{
+
+namespace
+{
+constexpr Size initialTableCapacity = 1024;
+
+UInt32 GetGroupKey(const CallSiteId callSite, const CategoryId category)
+{
+    return (static_cast<UInt32>(callSite.value) << 16) | category.value;
+}
+} // namespace
+
+LiveAllocationTable::~LiveAllocationTable()
+{
+    if (m_Entries != nullptr)
+    {
+        UnmapMemory(m_Entries, RoundUpToPageSize(m_Capacity * sizeof(Entry)));
+    }
+}
+
+void LiveAllocationTable::Insert(const void* ptr, const Size size, const CallSiteId callSite, const CategoryId category) noexcept
+{
+    const UIntPtr address = std::bit_cast<UIntPtr>(ptr);
+    if (address == 0)
+    {
+        return;
+    }
+
+    Lock();
+
+    // Keep the table at most half full, so probe sequences stay short
+    if ((m_Count + 1) * 2 > m_Capacity && !Grow())
+    {
+        Unlock();
+        return;
+    }
+
+    const Size mask  = m_Capacity - 1;
+    Size       index = GetSlotIndex(address);
+    while (m_Entries[index].address != 0 && m_Entries[index].address != address)
+    {
+        index = (index + 1) & mask;
+    }
+
+    if (m_Entries[index].address == 0)
+    {
+        m_Count++;
+    }
+    m_Entries[index] = {.address = address, .size = size, .callSite = callSite, .category = category};
+
+    Unlock();
+}
+
+void LiveAllocationTable::Erase(const void* ptr) noexcept
+{
+    [[maybe_unused]] const std::optional<LiveAllocation> liveAllocation = Extract(ptr);
+}
+
+std::optional<LiveAllocationTable::LiveAllocation> LiveAllocationTable::Extract(const void* ptr) noexcept
+{
+    const UIntPtr address = std::bit_cast<UIntPtr>(ptr);
+
+    Lock();
+
+    if (m_Entries == nullptr)
+    {
+        Unlock();
+        return std::nullopt;
+    }
+
+    const Size mask  = m_Capacity - 1;
+    Size       index = GetSlotIndex(address);
+    while (m_Entries[index].address != address)
+    {
+        if (m_Entries[index].address == 0)
+        {
+            Unlock();
+            return std::nullopt;
+        }
+        index = (index + 1) & mask;
+    }
+
+    const Entry entry = m_Entries[index];
+    m_Entries[index]  = {};
+    m_Count--;
+
+    // Move back every following entry that would no longer be reachable across the new hole
+    for (Size next = (index + 1) & mask; m_Entries[next].address != 0; next = (next + 1) & mask)
+    {
+        const Size probeDistance = (next - GetSlotIndex(m_Entries[next].address)) & mask;
+        if (probeDistance >= ((next - index) & mask))
+        {
+            m_Entries[index] = m_Entries[next];
+            m_Entries[next]  = {};
+            index            = next;
+        }
+    }
+
+    Unlock();
+    return LiveAllocation{.size = entry.size, .callSite = entry.callSite, .category = entry.category};
+}
+
+void LiveAllocationTable::Clear() noexcept
+{
+    Lock();
+
+    if (m_Entries != nullptr)
+    {
+        std::memset(static_cast<void*>(m_Entries), 0, m_Capacity * sizeof(Entry));
+    }
+    m_Count = 0;
+
+    Unlock();
+}
+
+Size LiveAllocationTable::GetLiveCount() const
+{
+    Lock();
+    const Size count = m_Count;
+    Unlock();
+    return count;
+}
+
+std::vector<LeakReportEntry> LiveAllocationTable::GetLeakReport() const
+{
+    std::vector<LeakReportEntry> report;
+    AccumulateInto(report);
+    SortLeakReport(report);
+    return report;
+}
+
+void LiveAllocationTable::AccumulateInto(std::vector<LeakReportEntry>& report) const
+{
+    std::unordered_map<UInt32, Size> groupIndices;
+    for (Size i = 0; i < report.size(); i++)
+    {
+        groupIndices.emplace(GetGroupKey(report[i].callSite, report[i].category), i);
+    }
+
+    Lock();
+
+    for (Size i = 0; i < m_Capacity; i++)
+    {
+        const Entry& entry = m_Entries[i];
+        if (entry.address == 0)
+        {
+            continue;
+        }
+
+        const auto [it, inserted] = groupIndices.emplace(GetGroupKey(entry.callSite, entry.category), report.size());
+        if (inserted)
+        {
+            report.push_back({.callSite = entry.callSite, .category = entry.category});
+        }
+
+        LeakReportEntry& group = report[it->second];
+        group.allocationCount++;
+        group.size += entry.size;
+    }
+
+    Unlock();
+}
+
+Size LiveAllocationTable::GetSlotIndex(const UIntPtr address) const
+{
+    // Fibonacci hashing spreads the aligned, mostly sequential addresses over the high bits of the product
+    const UInt64 hash = static_cast<UInt64>(address) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<Size>(hash >> (64 - std::countr_zero(m_Capacity)));
+}
+
+bool LiveAllocationTable::Grow() noexcept
+{
+    const Size newCapacity = m_Capacity == 0 ? initialTableCapacity : m_Capacity * 2;
+    auto*      newEntries  = static_cast<Entry*>(MapMemory(RoundUpToPageSize(newCapacity * sizeof(Entry))));
+    RETURN_VAL_IF_NULLPTR(newEntries, false);
+
+    // Fresh mappings are zeroed, so every slot starts out empty
+    Entry*     oldEntries  = m_Entries;
+    const Size oldCapacity = m_Capacity;
+    m_Entries              = newEntries;
+    m_Capacity             = newCapacity;
+
+    const Size mask = m_Capacity - 1;
+    for (Size i = 0; i < oldCapacity; i++)
+    {
+        if (oldEntries[i].address != 0)
+        {
+            Size index = GetSlotIndex(oldEntries[i].address);
+            while (m_Entries[index].address != 0)
+            {
+                index = (index + 1) & mask;
+            }
+            m_Entries[index] = oldEntries[i];
+        }
+    }
+
+    if (oldEntries != nullptr)
+    {
+        UnmapMemory(oldEntries, RoundUpToPageSize(oldCapacity * sizeof(Entry)));
+    }
+
+    return true;
+}
+
+void LiveAllocationTable::Lock() const noexcept
+{
+    while (m_Lock.test_and_set(std::memory_order_acquire))
+    {
+        while (m_Lock.test(std::memory_order_relaxed))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void LiveAllocationTable::Unlock() const noexcept { m_Lock.clear(std::memory_order_release); }
+
+void SortLeakReport(std::vector<LeakReportEntry>& report)
+{
+    std::ranges::sort(report, [](const LeakReportEntry& a, const LeakReportEntry& b) { return a.size > b.size; });
+}
+
+void PrintLeakReport(const std::string& debugName, const std::vector<LeakReportEntry>& report)
+{
+    Size allocationCount = 0;
+    Size size            = 0;
+    for (const LeakReportEntry& entry : report)
+    {
+        allocationCount += entry.allocationCount;
+        size += entry.size;
+    }
+
+    fprintf(stderr, "Memarena: The allocator '%s' has %llu live allocations (%llu bytes):\n", debugName.c_str(),
+            static_cast<ULLInt>(allocationCount), static_cast<ULLInt>(size));
+
+    for (const LeakReportEntry& entry : report)
+    {
+        const CallSite         callSite = CallSiteRegistry::Get(entry.callSite);
+        const std::string_view category = CategoryRegistry::GetName(entry.category);
+        fprintf(stderr, "    %llu bytes in %llu allocations from %s:%u (%s) in category '%.*s'\n", static_cast<ULLInt>(entry.size),
+                static_cast<ULLInt>(entry.allocationCount), callSite.fileName, callSite.line, callSite.functionName,
+                static_cast<int>(category.size()), category.data());
+    }
+}
+
+} // namespace Memarena
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Source/Aliases.hpp"
+#include "Source/CallSite.hpp"
+#include "Source/Category.hpp"
+
+namespace Memarena
+{
+
+// The allocations made from one call site in one category that are still live
+struct LeakReportEntry
+{
+    CallSiteId callSite;
+    CategoryId category;
+    Size       allocationCount = 0;
+    Size       size            = 0;
+};
+
+/**
+ * @brief The live allocations of an allocator, in an open addressing hash table keyed by address. The slots are mapped
+ * straight from the OS, so the table never allocates from the allocators it is tracking. Removed entries are filled by
+ * shifting the following entries back, so probes never have to skip tombstones. A spin lock guards the table, which is
+ * held for a single probe in the common case.
+ */
+class LiveAllocationTable
+{
+  public:
+    // What Insert records for an allocation, so that an extracted entry can be put back
+    struct LiveAllocation
+    {
+        Size       size = 0;
+        CallSiteId callSite;
+        CategoryId category;
+    };
+
+    LiveAllocationTable() = default;
+    ~LiveAllocationTable();
+
+    LiveAllocationTable(const LiveAllocationTable&) = delete;
+    LiveAllocationTable(LiveAllocationTable&&)      = delete;
+    LiveAllocationTable& operator=(const LiveAllocationTable&) = delete;
+    LiveAllocationTable& operator=(LiveAllocationTable&&) = delete;
+
+    // Replaces the entry of `ptr` if there is one. The allocation is dropped if the table cannot grow
+    void Insert(const void* ptr, Size size, CallSiteId callSite, CategoryId category) noexcept;
+    // Does nothing if `ptr` is not in the table
+    void Erase(const void* ptr) noexcept;
+    // Removes the entry of `ptr` and returns it, or nothing if `ptr` is not in the table
+    [[nodiscard]] std::optional<LiveAllocation> Extract(const void* ptr) noexcept;
+    void Clear() noexcept;
+
+    [[nodiscard]] Size GetLiveCount() const;
+
+    // The live allocations, grouped by call site and category, largest total size first
+    [[nodiscard]] std::vector<LeakReportEntry> GetLeakReport() const;
+    // Adds the live allocations to `report`, merging them into the entries with the same call site and category
+    void AccumulateInto(std::vector<LeakReportEntry>& report) const;
+
+  private:
+    struct Entry
+    {
+        UIntPtr    address = 0; // 0 marks an empty slot
+        Size       size    = 0;
+        CallSiteId callSite;
+        CategoryId category;
+    };
+
+    [[nodiscard]] Size GetSlotIndex(UIntPtr address) const;
+    // Must be called with the lock held
+    bool Grow() noexcept;
+
+    void Lock() const noexcept;
+    void Unlock() const noexcept;
+
+    Entry* m_Entries  = nullptr;
+    Size   m_Capacity = 0; // Always a power of 2
+    Size   m_Count    = 0;
+
+    mutable std::atomic_flag m_Lock;
+};
+
+// Sorts a report by total size, largest first
+void SortLeakReport(std::vector<LeakReportEntry>& report);
+
+// Writes the report to stderr, with the location and category of every call site
+void PrintLeakReport(const std::string& debugName, const std::vector<LeakReportEntry>& report);
+
+} // namespace Memarena
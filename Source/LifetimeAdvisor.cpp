@@ -0,0 +1,256 @@
+#include "PCH.hpp"
+
+#include "LifetimeAdvisor.hpp"
+
+#include <unordered_map>
+
+#include "Source/Allocators/StackAllocator/StackAllocator.hpp"
+
+namespace Memarena
+{
+
+namespace
+{
+// A site is long-lived if more than half of its allocations are live at the end
+constexpr Size longLivedDivisor = 2;
+// The share of the frees, in tenths, that have to come in drained batches for a site to be bulk freed
+constexpr Size bulkFreedTenths = 9;
+// The batches have to be this large on average, so that a site that only ever has one live allocation is not bulk freed
+constexpr Size minBulkBatchSize = 4;
+// A pool pays off once its chunks are reused, so the site has to allocate at least this many times its peak live count
+constexpr Size minChurnReuse = 2;
+// The largest header a StackAllocator puts in front of an allocation
+constexpr Size stackHeaderSize = sizeof(Internal::StackHeader<LargeOffset>);
+
+struct SiteState
+{
+    AllocationSiteAdvice advice;
+    Size                 maxAlignment      = 1;
+    Size                 liveSize          = 0;
+    Size                 liveFootprint     = 0; // The live sizes with their worst case padding
+    Size                 peakFootprint     = 0;
+    Size                 lifoFreeCount     = 0;
+    Size                 batchSize         = 0; // The frees since the last allocation of the site
+    Size                 drainedBatchFrees = 0; // The frees in batches that left nothing of the site live
+    Size                 drainedBatchCount = 0;
+    std::vector<UInt32>  liveStack; // Pointer ids in allocation order. Freed ids are only popped once they are on top
+};
+
+struct PointerState
+{
+    SiteState* site      = nullptr;
+    Size       size      = 0;
+    Size       footprint = 0;
+    bool       isLive    = false;
+};
+
+void UpdatePeaks(SiteState& site)
+{
+    site.advice.peakLiveCount = std::max(site.advice.peakLiveCount, site.advice.liveCount);
+    site.advice.peakLiveSize  = std::max(site.advice.peakLiveSize, site.liveSize);
+    site.peakFootprint        = std::max(site.peakFootprint, site.liveFootprint);
+}
+
+void EndFree(SiteState& site, const Size freeCount)
+{
+    site.batchSize += freeCount;
+    if (site.advice.liveCount == 0)
+    {
+        site.drainedBatchFrees += site.batchSize;
+        site.drainedBatchCount++;
+        site.batchSize = 0;
+    }
+}
+
+void Classify(SiteState& site)
+{
+    AllocationSiteAdvice& advice    = site.advice;
+    const Size            freeCount = advice.deallocationCount + advice.releasedCount;
+
+    const bool isLongLived     = advice.liveCount * longLivedDivisor > advice.allocationCount;
+    const bool isSameSizeChurn = advice.minSize == advice.maxSize && advice.reallocationCount == 0 &&
+                                 advice.allocationCount >= advice.peakLiveCount * minChurnReuse;
+    const bool isStrictlyLifo  = advice.deallocationCount > 0 && site.lifoFreeCount == advice.deallocationCount &&
+                                 advice.reallocationCount == 0;
+    const bool isBulkFreed     = freeCount > 0 && site.drainedBatchFrees * 10 >= freeCount * bulkFreedTenths &&
+                                 site.drainedBatchFrees >= site.drainedBatchCount * minBulkBatchSize;
+
+    if (isLongLived)
+    {
+        advice.pattern              = LifetimePattern::LongLived;
+        advice.recommendedAllocator = AllocatorKind::Mallocator;
+    }
+    else if (isSameSizeChurn)
+    {
+        // Every chunk has to hold the pointer to the next free chunk, and keep the alignment of the one after it
+        advice.pattern              = LifetimePattern::SameSizeChurn;
+        advice.recommendedAllocator = AllocatorKind::Pool;
+        advice.objectSize           = std::max<Size>(CalculateAlignedAddress(advice.maxSize, Alignment(site.maxAlignment)), sizeof(void*));
+        advice.objectsPerBlock      = advice.peakLiveCount;
+    }
+    else if (isStrictlyLifo)
+    {
+        advice.pattern              = LifetimePattern::StrictlyLifo;
+        advice.recommendedAllocator = AllocatorKind::Stack;
+        advice.totalSize            = site.peakFootprint + advice.peakLiveCount * stackHeaderSize;
+    }
+    else if (isBulkFreed)
+    {
+        advice.pattern              = LifetimePattern::BulkFreed;
+        advice.recommendedAllocator = AllocatorKind::Linear;
+        advice.totalSize            = site.peakFootprint;
+    }
+    else
+    {
+        advice.pattern              = LifetimePattern::Mixed;
+        advice.recommendedAllocator = AllocatorKind::Mallocator;
+    }
+}
+} // namespace
+
+std::vector<AllocationSiteAdvice> AnalyzeLifetimes(const std::vector<TraceRecord>& records)
+{
+    UInt32 lastPointerId = 0;
+    for (const TraceRecord& record : records)
+    {
+        lastPointerId = std::max(lastPointerId, record.pointerId);
+    }
+
+    // Keyed by the allocator id and the call site. The map keeps the states in place as it grows
+    std::unordered_map<UInt64, SiteState> sites;
+    std::vector<PointerState>             pointers(Size(lastPointerId) + 1);
+
+    for (const TraceRecord& record : records)
+    {
+        PointerState& pointer = pointers[record.pointerId];
+
+        switch (record.operation)
+        {
+        case TraceOperation::Allocate:
+        {
+            SiteState& site = sites[(UInt64(record.allocatorId) << 16) | record.callSite];
+            if (site.advice.allocationCount == 0)
+            {
+                site.advice.allocatorId = record.allocatorId;
+                site.advice.callSite    = record.callSite;
+                site.advice.minSize     = record.size;
+            }
+
+            const Size alignment = Size(1) << record.alignmentShift;
+            pointer              = {.site = &site, .size = record.size, .footprint = record.size + alignment - 1, .isLive = true};
+
+            AllocationSiteAdvice& advice = site.advice;
+            advice.allocationCount++;
+            advice.allocatedSize += record.size;
+            advice.minSize = std::min<Size>(advice.minSize, record.size);
+            advice.maxSize = std::max<Size>(advice.maxSize, record.size);
+            advice.liveCount++;
+            site.maxAlignment = std::max(site.maxAlignment, alignment);
+            site.liveSize += pointer.size;
+            site.liveFootprint += pointer.footprint;
+            site.batchSize = 0;
+            site.liveStack.push_back(record.pointerId);
+            UpdatePeaks(site);
+            break;
+        }
+        case TraceOperation::Deallocate:
+        {
+            if (!pointer.isLive)
+            {
+                break;
+            }
+
+            SiteState& site = *pointer.site;
+            pointer.isLive  = false;
+            if (site.liveStack.back() == record.pointerId)
+            {
+                site.lifoFreeCount++;
+                while (!site.liveStack.empty() && !pointers[site.liveStack.back()].isLive)
+                {
+                    site.liveStack.pop_back();
+                }
+            }
+
+            site.advice.deallocationCount++;
+            site.advice.liveCount--;
+            site.liveSize -= pointer.size;
+            site.liveFootprint -= pointer.footprint;
+            EndFree(site, 1);
+            break;
+        }
+        case TraceOperation::Reallocate:
+        {
+            if (!pointer.isLive)
+            {
+                break;
+            }
+
+            SiteState& site      = *pointer.site;
+            const Size alignment = Size(1) << record.alignmentShift;
+            const Size footprint = record.size + alignment - 1;
+            site.liveSize        = site.liveSize - pointer.size + record.size;
+            site.liveFootprint   = site.liveFootprint - pointer.footprint + footprint;
+            pointer.size         = record.size;
+            pointer.footprint    = footprint;
+
+            site.advice.reallocationCount++;
+            site.advice.minSize = std::min<Size>(site.advice.minSize, record.size);
+            site.advice.maxSize = std::max<Size>(site.advice.maxSize, record.size);
+            UpdatePeaks(site);
+            break;
+        }
+        case TraceOperation::Release:
+        {
+            for (auto& [key, site] : sites)
+            {
+                if (site.advice.allocatorId != record.allocatorId || site.advice.liveCount == 0)
+                {
+                    continue;
+                }
+
+                for (const UInt32 pointerId : site.liveStack)
+                {
+                    pointers[pointerId].isLive = false;
+                }
+
+                const Size releasedCount = site.advice.liveCount;
+                site.advice.releasedCount += releasedCount;
+                site.advice.liveCount = 0;
+                site.liveSize         = 0;
+                site.liveFootprint    = 0;
+                site.liveStack.clear();
+                EndFree(site, releasedCount);
+            }
+            break;
+        }
+        }
+    }
+
+    std::vector<AllocationSiteAdvice> advice;
+    advice.reserve(sites.size());
+    for (auto& [key, site] : sites)
+    {
+        Classify(site);
+        advice.push_back(site.advice);
+    }
+
+    std::ranges::sort(advice, [](const AllocationSiteAdvice& a, const AllocationSiteAdvice& b) {
+        return a.allocationCount != b.allocationCount ? a.allocationCount > b.allocationCount : a.allocatedSize > b.allocatedSize;
+    });
+    return advice;
+}
+
+const char* GetLifetimePatternName(const LifetimePattern pattern)
+{
+    switch (pattern)
+    {
+    case LifetimePattern::StrictlyLifo: return "strictly LIFO";
+    case LifetimePattern::SameSizeChurn: return "same-size churn";
+    case LifetimePattern::BulkFreed: return "bulk freed";
+    case LifetimePattern::LongLived: return "long-lived";
+    case LifetimePattern::Mixed: return "mixed";
+    }
+    return "";
+}
+
+} // namespace Memarena
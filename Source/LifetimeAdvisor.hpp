@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "Source/Aliases.hpp"
+#include "Source/TraceRecorder.hpp"
+
+namespace Memarena
+{
+
+enum class LifetimePattern : UInt8
+{
+    StrictlyLifo,  // Every free was of the most recent live allocation of the site
+    SameSizeChurn, // One size, allocated and freed again many times over
+    BulkFreed,     // Freed in batches that leave nothing of the site live, or by releasing the allocator
+    LongLived,     // Most allocations were still live at the end of the trace
+    Mixed,         // None of the above
+};
+
+enum class AllocatorKind : UInt8
+{
+    Stack,
+    Pool,
+    Linear,
+    Mallocator,
+};
+
+/**
+ * @brief What a trace shows about the allocations made from one call site into one allocator, and the allocator that
+ * suits them best.
+ */
+struct AllocationSiteAdvice
+{
+    UInt32          allocatorId          = 0;
+    UInt16          callSite             = 0; // Indexes Trace::callSites
+    LifetimePattern pattern              = LifetimePattern::Mixed;
+    AllocatorKind   recommendedAllocator = AllocatorKind::Mallocator;
+
+    Size allocationCount   = 0;
+    Size allocatedSize     = 0;
+    Size deallocationCount = 0; // Freed one at a time
+    Size releasedCount     = 0; // Freed by releasing the allocator
+    Size reallocationCount = 0;
+    Size liveCount         = 0; // Still live at the end of the trace
+    Size minSize           = 0;
+    Size maxSize           = 0;
+    Size peakLiveCount     = 0;
+    Size peakLiveSize      = 0;
+
+    // The arguments to create the recommended allocator with
+    Size objectSize      = 0; // PoolAllocator
+    Size objectsPerBlock = 0; // PoolAllocator
+    Size totalSize       = 0; // StackAllocator, or the block size of a LinearAllocator. Includes the worst case padding
+};
+
+/**
+ * @brief Classifies the allocation sites of a trace by the lifetimes of their allocations, and recommends an allocator
+ * for each. Sites are ordered by their allocation count, most first.
+ *
+ * A site is long-lived if most of its allocations outlive the trace, as nothing is known about how they are freed. A site
+ * whose allocations all have the same size goes to a pool even if it is also LIFO or bulk freed, as pools have no headers.
+ * A LIFO site goes to a stack even if it is also drained in batches, as a stack does not need a point to release it at.
+ */
+[[nodiscard]] std::vector<AllocationSiteAdvice> AnalyzeLifetimes(const std::vector<TraceRecord>& records);
+
+[[nodiscard]] const char* GetLifetimePatternName(LifetimePattern pattern);
+
+} // namespace Memarena
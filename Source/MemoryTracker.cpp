@@ -2,88 +2,353 @@
 
 #include "MemoryTracker.hpp"
 
-#include "AllocatorData.hpp"
+#include <array>
+#include <atomic>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "AllocatorData.hpp"
 
 namespace Memarena
 {
 
-std::mutex      MemoryTracker::m_Mutex;
-AllocatorVector MemoryTracker::m_Allocators;
-AllocatorVector MemoryTracker::m_BaseAllocators;
-Cache<Size>     MemoryTracker::m_TotalAllocatedSize = {0, false};
+namespace
+{
+struct Registry
+{
+    Registry()                = default;
+    Registry(const Registry&) = delete;
+    Registry(Registry&&)      = delete;
+    Registry& operator=(const Registry&) = delete;
+    Registry& operator=(Registry&&) = delete;
 
-void MemoryTracker::RegisterAllocator(const std::shared_ptr<AllocatorData>& allocatorData)
+    ~Registry()
+    {
+        delete allocators.load();
+        delete baseAllocators.load();
+    }
+
+    std::mutex                          writeMutex;
+    std::atomic<const AllocatorVector*> allocators     = new AllocatorVector();
+    std::atomic<const AllocatorVector*> baseAllocators = new AllocatorVector();
+
+    // Readers count themselves in the counter picked by the parity of the epoch when they started
+    std::atomic<UInt64>                epoch = 0;
+    std::array<std::atomic<UInt64>, 2> readers{};
+
+    // Only the total size is used
+    AllocatorStatistics baseAllocatorStatistics;
+    // The switch that new allocators with the DynamicTracking policy start with
+    std::atomic<bool> isTrackingEnabled = true;
+};
+
+// Allocators are created during static initialization, so the registry has to be created on first use
+Registry& GetRegistry()
 {
-    std::lock_guard<std::mutex> guard(m_Mutex);
+    static Registry registry;
+    return registry;
+}
 
-    if (allocatorData->isBaseAllocator)
+std::atomic<const AllocatorVector*>& GetSnapshot(Registry& registry, const bool baseAllocators)
+{
+    return baseAllocators ? registry.baseAllocators : registry.allocators;
+}
+
+void WaitForReaders(Registry& registry)
+{
+    // Flipping the epoch sends new readers to the other counter, so each counter drains even while readers keep arriving
+    for (int i = 0; i < 2; i++)
     {
-        m_BaseAllocators.push_back(allocatorData);
+        const UInt64 parity = registry.epoch.fetch_add(1) & 1;
+        while (registry.readers[parity].load() != 0)
+        {
+            std::this_thread::yield();
+        }
     }
-    else
+}
+
+AllocatorTreeNode BuildTreeNode(const std::shared_ptr<AllocatorData>&              allocatorData,
+                                const std::unordered_map<UInt32, AllocatorVector>& childrenByParent)
+{
+    AllocatorTreeNode node{.allocatorData = allocatorData, .children = {}, .usedSize = 0, .totalSize = 0, .peakUsedSize = 0};
+
+    Size childrenTotalSize    = 0;
+    Size childrenPeakUsedSize = 0;
+    if (const auto it = childrenByParent.find(allocatorData->id.value); it != childrenByParent.end())
     {
-        m_Allocators.push_back(allocatorData);
+        for (const auto& child : it->second)
+        {
+            const AllocatorTreeNode& childNode = node.children.emplace_back(BuildTreeNode(child, childrenByParent));
+            childrenTotalSize += child->statistics.GetTotalSize();
+            childrenPeakUsedSize += childNode.peakUsedSize;
+            node.usedSize += childNode.usedSize;
+            node.totalSize += childNode.totalSize;
+        }
+    }
+
+    // The blocks of the children are part of this allocator's own usage, and are already counted by the children
+    const AllocatorStatistics& statistics = allocatorData->statistics;
+    const Size                 usedSize   = statistics.GetUsedSize();
+    const Size                 totalSize  = statistics.GetTotalSize();
+    node.usedSize += usedSize - std::min(usedSize, childrenTotalSize);
+    node.totalSize += totalSize - std::min(totalSize, childrenTotalSize);
+    node.peakUsedSize = std::max(statistics.GetPeakUsedSize(), childrenPeakUsedSize);
+
+    return node;
+}
+
+// Must be called with the write mutex held
+void Publish(Registry& registry, std::atomic<const AllocatorVector*>& snapshot, AllocatorVector allocators)
+{
+    const AllocatorVector* oldSnapshot = snapshot.exchange(new AllocatorVector(std::move(allocators)));
+    WaitForReaders(registry);
+    delete oldSnapshot;
+}
+} // namespace
+
+void MemoryTracker::RegisterAllocator(const std::shared_ptr<AllocatorData>& allocatorData)
+{
+    Registry&                   registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry.writeMutex);
+
+    std::atomic<const AllocatorVector*>& snapshot   = GetSnapshot(registry, allocatorData->isBaseAllocator);
+    AllocatorVector                      allocators = *snapshot.load();
+    allocators.push_back(allocatorData);
+    Publish(registry, snapshot, std::move(allocators));
+
+    allocatorData->isRegistered = true;
+    if (allocatorData->isBaseAllocator)
+    {
+        registry.baseAllocatorStatistics.IncreaseTotalSize(allocatorData->statistics.GetTotalSize());
     }
 }
 
 void MemoryTracker::UnRegisterAllocator(const std::shared_ptr<AllocatorData>& allocatorData)
 {
-    std::lock_guard<std::mutex> guard(m_Mutex);
+    Registry&                   registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry.writeMutex);
+
+    // Allocators that were dropped by a reset are no longer in the snapshot
+    if (!allocatorData->isRegistered)
+    {
+        return;
+    }
 
+    std::atomic<const AllocatorVector*>& snapshot   = GetSnapshot(registry, allocatorData->isBaseAllocator);
+    AllocatorVector                      allocators = *snapshot.load();
+    allocators.erase(std::remove(allocators.begin(), allocators.end(), allocatorData), allocators.end());
+    Publish(registry, snapshot, std::move(allocators));
+
+    allocatorData->isRegistered = false;
     if (allocatorData->isBaseAllocator)
     {
-        m_BaseAllocators.erase(std::remove(m_BaseAllocators.begin(), m_BaseAllocators.end(), allocatorData), m_BaseAllocators.end());
+        registry.baseAllocatorStatistics.DecreaseTotalSize(allocatorData->statistics.GetTotalSize());
     }
-    else
+}
+
+void MemoryTracker::IncreaseTotalAllocatedSize(Size size) { GetRegistry().baseAllocatorStatistics.IncreaseTotalSize(size); }
+void MemoryTracker::DecreaseTotalAllocatedSize(Size size) { GetRegistry().baseAllocatorStatistics.DecreaseTotalSize(size); }
+
+Size MemoryTracker::GetTotalAllocatedSize() { return GetRegistry().baseAllocatorStatistics.GetTotalSize(); }
+
+void MemoryTracker::SetTrackingEnabled(const bool isEnabled)
+{
+    GetRegistry().isTrackingEnabled.store(isEnabled);
+    ForEachAllocator([isEnabled](AllocatorData& allocatorData) {
+        if (isEnabled)
+        {
+            allocatorData.isUsedSizeStale.store(true);
+        }
+        allocatorData.isTrackingEnabled.store(isEnabled);
+    });
+}
+
+bool MemoryTracker::IsTrackingEnabled() { return GetRegistry().isTrackingEnabled.load(); }
+
+AllocatorVector MemoryTracker::GetAllocators()
+{
+    const ReadGuard guard;
+    return guard.GetAllocators();
+}
+
+AllocatorVector MemoryTracker::GetBaseAllocators()
+{
+    const ReadGuard guard;
+    return guard.GetBaseAllocators();
+}
+
+std::vector<AllocatorTreeNode> MemoryTracker::GetAllocatorTree()
+{
+    AllocatorVector allocators;
     {
-        m_Allocators.erase(std::remove(m_Allocators.begin(), m_Allocators.end(), allocatorData), m_Allocators.end());
+        const ReadGuard        guard;
+        const AllocatorVector& snapshot = guard.GetAllocators();
+        allocators                      = guard.GetBaseAllocators();
+        allocators.insert(allocators.end(), snapshot.begin(), snapshot.end());
     }
+
+    // Ids grow with creation order, and an upstream is created before the allocators that use it
+    std::sort(allocators.begin(), allocators.end(), [](const auto& a, const auto& b) { return a->id.value < b->id.value; });
+
+    std::unordered_set<UInt32>                  registeredIds;
+    std::unordered_map<UInt32, AllocatorVector> childrenByParent;
+    AllocatorVector                             roots;
+    for (const auto& allocatorData : allocators)
+    {
+        registeredIds.insert(allocatorData->id.value);
+
+        if (registeredIds.contains(allocatorData->parentId.value))
+        {
+            childrenByParent[allocatorData->parentId.value].push_back(allocatorData);
+        }
+        else
+        {
+            roots.push_back(allocatorData);
+        }
+    }
+
+    std::vector<AllocatorTreeNode> tree;
+    tree.reserve(roots.size());
+    for (const auto& root : roots)
+    {
+        tree.push_back(BuildTreeNode(root, childrenByParent));
+    }
+    return tree;
 }
 
-Size MemoryTracker::GetTotalAllocatedSize()
+std::vector<HistogramBucket> MemoryTracker::GetSizeHistogram()
 {
-    if (m_TotalAllocatedSize.invalidated)
+    std::vector<UInt64> counts(SizeHistogram::bucketCount);
+
+    const ReadGuard guard;
+    for (const AllocatorVector* allocators : {&guard.GetBaseAllocators(), &guard.GetAllocators()})
     {
-        Size totalSize = 0;
-        for (const auto& it : m_BaseAllocators)
+        for (const auto& allocatorData : *allocators)
         {
-            totalSize += it->totalSize;
+            allocatorData->sizeHistogram.AccumulateInto(counts);
         }
+    }
+
+    return SizeHistogram::MakeBuckets(counts);
+}
+
+WasteMetrics MemoryTracker::GetWasteMetrics()
+{
+    WasteMetrics totalMetrics;
 
-        m_TotalAllocatedSize.value = totalSize;
+    const ReadGuard guard;
+    for (const AllocatorVector* allocators : {&guard.GetBaseAllocators(), &guard.GetAllocators()})
+    {
+        for (const auto& allocatorData : *allocators)
+        {
+            const WasteMetrics metrics = allocatorData->statistics.GetWasteMetrics();
+            totalMetrics.paddingSize += metrics.paddingSize;
+            totalMetrics.headerSize += metrics.headerSize;
+            totalMetrics.tailWasteSize += metrics.tailWasteSize;
+            totalMetrics.freeSize += metrics.freeSize;
+            totalMetrics.largestFreeSize = std::max(totalMetrics.largestFreeSize, metrics.largestFreeSize);
+        }
     }
 
-    return m_TotalAllocatedSize.value;
+    return totalMetrics;
 }
-void MemoryTracker::Reset()
+
+WasteMetrics MemoryTracker::GetWasteMetrics(const AllocatorData& allocatorData) { return allocatorData.statistics.GetWasteMetrics(); }
+
+std::vector<LeakReportEntry> MemoryTracker::GetLeakReport()
+{
+    std::vector<LeakReportEntry> report;
+
+    const ReadGuard guard;
+    for (const AllocatorVector* allocators : {&guard.GetBaseAllocators(), &guard.GetAllocators()})
+    {
+        for (const auto& allocatorData : *allocators)
+        {
+            allocatorData->liveAllocations.AccumulateInto(report);
+        }
+    }
+
+    SortLeakReport(report);
+    return report;
+}
+
+std::vector<HeapProfileEntry> MemoryTracker::GetHeapProfile()
 {
-    std::lock_guard<std::mutex> guard(m_Mutex);
+    std::vector<HeapProfileEntry> profile;
+
+    const ReadGuard guard;
+    for (const AllocatorVector* allocators : {&guard.GetBaseAllocators(), &guard.GetAllocators()})
+    {
+        for (const auto& allocatorData : *allocators)
+        {
+            allocatorData->heapSamples.AccumulateInto(profile);
+        }
+    }
+
+    SortHeapProfile(profile);
+    return profile;
+}
+
+LatencyPercentiles MemoryTracker::GetLatencyPercentiles(const LatencyOperation operation)
+{
+    std::vector<UInt64> counts(LatencyHistogram::bucketCount);
+
+    const ReadGuard guard;
+    for (const AllocatorVector* allocators : {&guard.GetBaseAllocators(), &guard.GetAllocators()})
+    {
+        for (const auto& allocatorData : *allocators)
+        {
+            allocatorData->latencyHistograms[static_cast<Size>(operation)].AccumulateInto(counts);
+        }
+    }
 
-    m_Allocators.clear();
-    m_Allocators.shrink_to_fit();
-    m_BaseAllocators.clear();
-    m_BaseAllocators.shrink_to_fit();
+    return CalculateLatencyPercentiles(counts);
 }
 
-void MemoryTracker::ResetAllocators()
+LatencyPercentiles MemoryTracker::GetLatencyPercentiles(const AllocatorData& allocatorData, const LatencyOperation operation)
 {
-    std::lock_guard<std::mutex> guard(m_Mutex);
+    return CalculateLatencyPercentiles(allocatorData.latencyHistograms[static_cast<Size>(operation)].GetCounts());
+}
 
-    m_Allocators.clear();
-    m_Allocators.shrink_to_fit();
+void MemoryTracker::Reset()
+{
+    ResetAllocators();
+    ResetBaseAllocators();
 }
 
-void MemoryTracker::ResetBaseAllocators()
+void MemoryTracker::ResetAllocators() { ResetSnapshot(false); }
+void MemoryTracker::ResetBaseAllocators() { ResetSnapshot(true); }
+
+void MemoryTracker::ResetSnapshot(const bool baseAllocators)
 {
-    std::lock_guard<std::mutex> guard(m_Mutex);
+    Registry&                   registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry.writeMutex);
 
-    m_BaseAllocators.clear();
-    m_BaseAllocators.shrink_to_fit();
+    std::atomic<const AllocatorVector*>& snapshot = GetSnapshot(registry, baseAllocators);
+    for (const auto& allocatorData : *snapshot.load())
+    {
+        allocatorData->isRegistered = false;
+    }
+    Publish(registry, snapshot, {});
+
+    if (baseAllocators)
+    {
+        registry.baseAllocatorStatistics.SetTotalSize(0);
+    }
 }
 
-void MemoryTracker::InvalidateTotalAllocatedSizeCache() { m_TotalAllocatedSize.invalidated = true; }
+MemoryTracker::ReadGuard::ReadGuard()
+{
+    Registry& registry = GetRegistry();
+    m_Parity           = registry.epoch.load() & 1;
+    registry.readers[m_Parity].fetch_add(1);
+}
+
+MemoryTracker::ReadGuard::~ReadGuard() { GetRegistry().readers[m_Parity].fetch_sub(1); }
+
+const AllocatorVector& MemoryTracker::ReadGuard::GetAllocators() const { return *GetRegistry().allocators.load(); }
+const AllocatorVector& MemoryTracker::ReadGuard::GetBaseAllocators() const { return *GetRegistry().baseAllocators.load(); }
 
-const AllocatorVector& MemoryTracker::GetAllocators() { return m_Allocators; }
-const AllocatorVector& MemoryTracker::GetBaseAllocators() { return m_BaseAllocators; }
-} // namespace Memarena
\ No newline at end of file
+} // namespace Memarena
@@ -1,9 +1,16 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "Aliases.hpp"
+#include "AllocatorStatistics.hpp"
+#include "HeapProfiler.hpp"
+#include "Histogram.hpp"
+#include "LatencyTracking.hpp"
+#include "LeakDetection.hpp"
 
 namespace Memarena
 {
@@ -11,13 +18,32 @@ struct AllocatorData;
 
 using AllocatorVector = std::vector<std::shared_ptr<AllocatorData>>;
 
-template <typename T>
-struct Cache
+enum class SnapshotFormat : UInt8
 {
-    T    value;
-    bool invalidated = false;
+    Json,        // The allocator tree, with the statistics, waste, histograms and latencies of every allocator
+    ChromeTrace, // The retained allocation events as a trace that chrome://tracing and Perfetto can load
 };
 
+/**
+ * @brief An allocator and the allocators that get their blocks from it. The sizes cover the whole subtree. A block that an
+ * allocator hands to a child is counted in the child, so it is not counted twice.
+ */
+struct AllocatorTreeNode
+{
+    std::shared_ptr<AllocatorData> allocatorData;
+    std::vector<AllocatorTreeNode> children;
+    Size                           usedSize  = 0; // Bytes in use by the clients of the subtree
+    Size                           totalSize = 0; // Bytes the subtree holds
+    // The allocator's own peak, which includes the blocks of its children, or the sum of the children's peaks if larger
+    Size peakUsedSize = 0;
+};
+
+/**
+ * @brief Keeps track of every tracked allocator. The registered allocators are published as immutable copy-on-write
+ * snapshots, so readers never take a lock. Writers pay for it: creating or destroying a tracked allocator takes a mutex,
+ * copies the whole snapshot and then waits for the readers of the replaced one to finish before freeing it. Long reads,
+ * such as a ForEachAllocator callback, therefore delay the creation and destruction of allocators.
+ */
 class MemoryTracker
 {
   public:
@@ -26,20 +52,124 @@ class MemoryTracker
     static void RegisterAllocator(const std::shared_ptr<AllocatorData>& allocatorData);
     static void UnRegisterAllocator(const std::shared_ptr<AllocatorData>& allocatorData);
 
-    static void InvalidateTotalAllocatedSizeCache();
+    // Keep the running total of the registered base allocators in step with their total sizes
+    static void IncreaseTotalAllocatedSize(Size size);
+    static void DecreaseTotalAllocatedSize(Size size);
+
+    /**
+     * @brief Switches the AllocationTracking and SizeTracking hooks of every allocator with the DynamicTracking policy,
+     * including the ones created later. It neither locks nor allocates, so it can be called from a signal handler.
+     */
+    static void               SetTrackingEnabled(bool isEnabled);
+    [[nodiscard]] static bool IsTrackingEnabled();
+
+    // The sum of the total sizes of the registered base allocators
+    [[nodiscard]] static Size GetTotalAllocatedSize();
+
+    // Copies of the current snapshots
+    [[nodiscard]] static AllocatorVector GetAllocators();
+    [[nodiscard]] static AllocatorVector GetBaseAllocators();
+
+    /**
+     * @brief Arranges the registered allocators by the upstream they get their blocks from. The roots are the allocators
+     * whose upstream is untracked or no longer registered.
+     */
+    [[nodiscard]] static std::vector<AllocatorTreeNode> GetAllocatorTree();
+
+    // The size histograms of every registered allocator, added together
+    [[nodiscard]] static std::vector<HistogramBucket> GetSizeHistogram();
+
+    /**
+     * @brief The waste of every registered allocator, added together. The largest free size is the largest run found in
+     * any one allocator, so the fragmentation score compares it against all the free memory.
+     */
+    [[nodiscard]] static WasteMetrics GetWasteMetrics();
+    [[nodiscard]] static WasteMetrics GetWasteMetrics(const AllocatorData& allocatorData);
+
+    // The live allocations of every registered allocator, grouped by call site and category
+    [[nodiscard]] static std::vector<LeakReportEntry> GetLeakReport();
 
-    [[nodiscard]] static Size                   GetTotalAllocatedSize();
-    [[nodiscard]] static const AllocatorVector& GetAllocators();
-    [[nodiscard]] static const AllocatorVector& GetBaseAllocators();
+    // The sampled allocations of every registered allocator, grouped by stack
+    [[nodiscard]] static std::vector<HeapProfileEntry> GetHeapProfile();
+
+    /**
+     * @brief Writes the sampled allocations to `path` in the heap profile format of gperftools, which pprof reads. The
+     * memory map of the process is appended on Linux, so pprof can symbolize the stacks. Returns false if the file
+     * could not be written.
+     */
+    static bool WriteHeapProfile(const std::string& path);
+
+    // The latencies of `operation` in every registered allocator, or in one allocator
+    [[nodiscard]] static LatencyPercentiles GetLatencyPercentiles(LatencyOperation operation);
+    [[nodiscard]] static LatencyPercentiles GetLatencyPercentiles(const AllocatorData& allocatorData, LatencyOperation operation);
+
+    /**
+     * @brief Writes the current state of the registered allocators to `path`. The output is streamed straight to the
+     * file, so no copy of it is built in memory. Returns false if the file could not be written.
+     */
+    static bool WriteSnapshot(const std::string& path, SnapshotFormat format);
+
+    /**
+     * @brief Publishes the statistics of the registered allocators into shared memory every `interval` from a background
+     * thread, so that memarena-top can watch them from another process. The memory is named `name`, or the default name of
+     * this process if it is empty, and has room for `capacity` allocators. Returns false if publishing is already running
+     * or the memory cannot be created.
+     */
+    static bool StartPublishing(const std::string& name = "", std::chrono::milliseconds interval = std::chrono::seconds(1),
+                                Size capacity = 256);
+    // Stops the thread and removes the shared memory. Readers that are attached keep the last statistics
+    static void StopPublishing();
+    // Publishes without waiting for the interval. Does nothing unless publishing is running
+    static void PublishStatistics();
+
+    /**
+     * @brief Calls `function` with the AllocatorData of every registered allocator, without copying the snapshot.
+     * `function` must not create or destroy tracked allocators, as that waits for this call to finish.
+     */
+    template <typename Function>
+    static void ForEachAllocator(Function&& function)
+    {
+        const ReadGuard guard;
+        for (const auto& allocatorData : guard.GetAllocators())
+        {
+            function(*allocatorData);
+        }
+    }
+    // Same as ForEachAllocator, for the base allocators
+    template <typename Function>
+    static void ForEachBaseAllocator(Function&& function)
+    {
+        const ReadGuard guard;
+        for (const auto& allocatorData : guard.GetBaseAllocators())
+        {
+            function(*allocatorData);
+        }
+    }
 
     static void Reset();
     static void ResetAllocators();
     static void ResetBaseAllocators();
 
   private:
-    static std::mutex      m_Mutex;
-    static AllocatorVector m_Allocators;
-    static AllocatorVector m_BaseAllocators;
-    static Cache<Size>     m_TotalAllocatedSize;
+    // Keeps the snapshots that were current when it was created alive until it is destroyed
+    class ReadGuard
+    {
+      public:
+        ReadGuard();
+        ~ReadGuard();
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard(ReadGuard&&)      = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ReadGuard& operator=(ReadGuard&&) = delete;
+
+        [[nodiscard]] const AllocatorVector& GetAllocators() const;
+        [[nodiscard]] const AllocatorVector& GetBaseAllocators() const;
+
+      private:
+        UInt64 m_Parity;
+    };
+
+    static void ResetSnapshot(bool baseAllocators);
 };
-} // namespace Memarena
\ No newline at end of file
+} // namespace Memarena
@@ -4,18 +4,20 @@
 
 namespace Memarena
 {
+template <typename OffsetType = Offset>
 struct BoundGuardFront
 {
-    Offset offset;
-    Offset allocationSize;
+    OffsetType offset;
+    OffsetType allocationSize;
 
-    BoundGuardFront(Offset _offset, Offset _allocationSize) : offset(_offset), allocationSize(_allocationSize) {}
+    BoundGuardFront(OffsetType _offset, OffsetType _allocationSize) : offset(_offset), allocationSize(_allocationSize) {}
 };
 
+template <typename OffsetType = Offset>
 struct BoundGuardBack
 {
-    Offset offset;
+    OffsetType offset;
 
-    explicit BoundGuardBack(Offset _offset) : offset(_offset) {}
+    explicit BoundGuardBack(OffsetType _offset) : offset(_offset) {}
 };
 } // namespace Memarena
\ No newline at end of file
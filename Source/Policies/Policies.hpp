@@ -22,9 +22,16 @@ struct IsPolicy
     };
 
 #define BASE_ALLOCATOR_POLICIES                                                                                        \
-    Empty = 0, AllocationTracking = Bit(27), /* Track the amount of allocations and deallocations of this allocator */ \
-        SizeTracking  = Bit(28),             /* Track the amount of space used by this allocator */                    \
-        Multithreaded = Bit(29)              /* Make allocations thread-safe. This will also make them blocking */
+    Empty = 0, DynamicTracking = Bit(20),    /* Let AllocationTracking and SizeTracking be switched off at runtime */  \
+        TraceRecording     = Bit(21),        /* Write every operation to the TraceRecorder while it is recording */    \
+        HeapSampling       = Bit(22),        /* Record the stacks of sampled allocations, for a pprof heap profile */  \
+        LeakDetection      = Bit(23),        /* Keep a table of live allocations, reported on destruction */           \
+        WasteTracking      = Bit(24),        /* Track bytes lost to padding, headers and block tails */                \
+        LatencyTracking    = Bit(25),        /* Time allocations, deallocations and block refills */                   \
+        SizeHistogram      = Bit(26),        /* Count the requested sizes in log2 buckets */                           \
+        AllocationTracking = Bit(27),        /* Track the amount of allocations and deallocations of this allocator */ \
+        SizeTracking       = Bit(28),        /* Track the amount of space used by this allocator */                    \
+        Multithreaded      = Bit(29)         /* Make allocations thread-safe. This will also make them blocking */
 
 #define ALLOCATOR_POLICIES BASE_ALLOCATOR_POLICIES
 
@@ -62,6 +69,7 @@ enum class StackAllocatorPolicy : UInt32
     StackCheck           = Bit(3), // Check is deallocations are performed in LIFO order
     Resizable            = Bit(4), // Allow the allocator to grow when memory is exhausted
     DoubleFreePrevention = Bit(5), // Set the ptr to null on free to prevent double frees
+    LargeOffsets         = Bit(6), // Use 64-bit offsets in headers, allowing arenas larger than 4 GiB at the cost of larger headers
 
     Default = NullDeallocCheck | OwnershipCheck | StackCheck | SizeTracking,
     Release = Empty,
@@ -79,6 +87,7 @@ enum class PoolAllocatorPolicy : UInt32
     DoubleFreePrevention = Bit(3), // Set the ptr to null on free to prevent double frees
     Growable             = Bit(4), // Allow the allocator to grow when memory is exhausted
     AllocationSizeCheck  = Bit(5), // Check if the size of object being allocated or deallocated is equal to objectSize
+    Presized             = Bit(6), // Reserve blocks for the peak used size in the PresizeProfile, and record this run's peak
 
     Default = NullDeallocCheck | OwnershipCheck | SizeTracking | DoubleFreePrevention | AllocationSizeCheck,
     Release = Empty,
@@ -91,8 +100,10 @@ enum class LinearAllocatorPolicy : UInt32
 {
     ALLOCATOR_POLICIES,
 
-    Growable  = Bit(0), // Allow the allocator to grow when memory is exhausted
-    SizeCheck = Bit(1), // Check if the allocator has sufficient space when allocating //
+    Growable     = Bit(0), // Allow the allocator to grow when memory is exhausted
+    SizeCheck    = Bit(1), // Check if the allocator has sufficient space when allocating //
+    LargeOffsets = Bit(2), // Use a 64-bit offset, allowing blocks larger than 4 GiB
+    Presized     = Bit(3), // Start with a block as large as the peak used size in the PresizeProfile, and record this run's peak
 
     Default = SizeTracking | SizeCheck,
     Release = Empty,
@@ -108,6 +119,10 @@ enum class MallocatorPolicy : UInt32
     NullAllocCheck       = Bit(0), // Check if malloc returns null
     NullDeallocCheck     = Bit(1), // Check if the pointer is null when deallocating
     DoubleFreePrevention = Bit(2), // Set the ptr to null on free to prevent double frees
+    HeaderFree           = Bit(3), // Query the block size from malloc instead of storing a header. Sizes are tracked in usable bytes
+    DirectMap            = Bit(4), // Map allocations above the direct map threshold straight from the OS instead of using malloc
+    PopulateDirectMap    = Bit(5), // Pre-fault the pages of direct mapped allocations
+    HugePageDirectMap    = Bit(6), // Hint the OS to back direct mapped allocations with transparent huge pages
 
     Default = NullDeallocCheck | NullAllocCheck | SizeTracking | DoubleFreePrevention,
     Release = Empty,
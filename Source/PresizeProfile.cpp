@@ -0,0 +1,169 @@
+#include "PCH.hpp"
+
+#include "PresizeProfile.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#include "AllocatorData.hpp"
+
+namespace Memarena
+{
+
+namespace
+{
+// The first line of a profile. Each following line is a peak used size in bytes and a slot, and the rest of the line is the
+// debug name
+constexpr const char* profileHeader = "memarena-presize-profile 2";
+
+using ProfileKey = std::pair<std::string, Size>; // The debug name and the slot
+
+struct ProfileState
+{
+    std::mutex                 mutex;
+    std::map<ProfileKey, Size> loadedPeaks;
+    // The peaks of the destroyed allocators. Ordered, so that saved profiles are easy to compare
+    std::map<ProfileKey, Size>                           recordedPeaks;
+    std::map<ProfileKey, std::shared_ptr<AllocatorData>> liveAllocators;
+    std::string                                          exitPath; // Set by Enable
+};
+
+ProfileState& GetState()
+{
+    static ProfileState state;
+    return state;
+}
+
+void SaveAtExit()
+{
+    std::string path;
+    {
+        ProfileState&                     state = GetState();
+        const std::lock_guard<std::mutex> guard(state.mutex);
+        path = state.exitPath;
+    }
+    [[maybe_unused]] const bool isSaved = PresizeProfile::Save(path);
+}
+} // namespace
+
+bool PresizeProfile::Enable(const std::string& path)
+{
+    // A missing file is the first run
+    if (std::ifstream(path).good() && !Load(path))
+    {
+        return false;
+    }
+
+    ProfileState&                     state = GetState();
+    const std::lock_guard<std::mutex> guard(state.mutex);
+
+    const bool isRegistered = !state.exitPath.empty();
+    state.exitPath          = path;
+    return isRegistered || std::atexit(SaveAtExit) == 0;
+}
+
+bool PresizeProfile::Load(const std::string& path)
+{
+    std::ifstream file(path);
+    std::string   line;
+    if (!std::getline(file, line) || line != profileHeader)
+    {
+        return false;
+    }
+
+    std::map<ProfileKey, Size> peaks;
+    while (std::getline(file, line))
+    {
+        std::istringstream stream(line);
+        Size               peakUsedSize = 0;
+        Size               slot         = 0;
+        std::string        debugName;
+        if (!(stream >> peakUsedSize >> slot) || stream.get() != ' ' || !std::getline(stream, debugName))
+        {
+            return false;
+        }
+        peaks[{debugName, slot}] = peakUsedSize;
+    }
+
+    ProfileState&                     state = GetState();
+    const std::lock_guard<std::mutex> guard(state.mutex);
+    state.loadedPeaks = std::move(peaks);
+    return true;
+}
+
+bool PresizeProfile::Save(const std::string& path)
+{
+    std::map<ProfileKey, Size> peaks;
+    {
+        ProfileState&                     state = GetState();
+        const std::lock_guard<std::mutex> guard(state.mutex);
+
+        peaks = state.recordedPeaks;
+        for (const auto& [key, allocatorData] : state.liveAllocators)
+        {
+            peaks[key] = std::max(peaks[key], allocatorData->statistics.GetPeakUsedSize());
+        }
+
+        // The peaks of this run replace the loaded ones, and entries this run did not use are kept
+        std::map<ProfileKey, Size> loadedPeaks = state.loadedPeaks;
+        peaks.merge(loadedPeaks);
+    }
+
+    std::ofstream file(path, std::ios::trunc);
+    file << profileHeader << '\n';
+    for (const auto& [key, peakUsedSize] : peaks)
+    {
+        file << peakUsedSize << ' ' << key.second << ' ' << key.first << '\n';
+    }
+    file.close();
+    return !file.fail();
+}
+
+void PresizeProfile::Clear()
+{
+    ProfileState&                     state = GetState();
+    const std::lock_guard<std::mutex> guard(state.mutex);
+    state.loadedPeaks.clear();
+    state.recordedPeaks.clear();
+}
+
+Size PresizeProfile::GetPeakUsedSize(const std::string& debugName, const Size slot)
+{
+    ProfileState&                     state = GetState();
+    const std::lock_guard<std::mutex> guard(state.mutex);
+
+    const auto it = state.loadedPeaks.find({debugName, slot});
+    return it != state.loadedPeaks.end() ? it->second : 0;
+}
+
+PresizeProfile::Entry PresizeProfile::Acquire(const std::shared_ptr<AllocatorData>& allocatorData)
+{
+    ProfileState&                     state = GetState();
+    const std::lock_guard<std::mutex> guard(state.mutex);
+
+    ProfileKey key{allocatorData->debugName, 0};
+    while (state.liveAllocators.contains(key))
+    {
+        key.second++;
+    }
+    state.liveAllocators.emplace(key, allocatorData);
+
+    const auto it = state.loadedPeaks.find(key);
+    return {.slot = key.second, .peakUsedSize = it != state.loadedPeaks.end() ? it->second : 0};
+}
+
+void PresizeProfile::Release(const std::shared_ptr<AllocatorData>& allocatorData, const Size slot)
+{
+    ProfileState&                     state = GetState();
+    const std::lock_guard<std::mutex> guard(state.mutex);
+
+    const ProfileKey key{allocatorData->debugName, slot};
+    Size&            recordedPeak = state.recordedPeaks[key];
+    recordedPeak                  = std::max(recordedPeak, allocatorData->statistics.GetPeakUsedSize());
+    state.liveAllocators.erase(key);
+}
+
+} // namespace Memarena
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "Source/Aliases.hpp"
+
+namespace Memarena
+{
+struct AllocatorData;
+
+/**
+ * @brief Remembers the peak used size of each allocator with the Presized policy, so that the next run can create it large
+ * enough for that peak instead of growing block by block during warm-up. A LinearAllocator starts with a block that large,
+ * and a PoolAllocator reserves enough blocks for it.
+ *
+ * Allocators are told apart by their debug name and a slot, which is the lowest one not held by a live allocator of the
+ * same name. Allocators that are alive at the same time get their own entries, while allocators that are created one after
+ * another reuse slot 0 and share the largest peak among them.
+ *
+ * Presized allocators only claim a slot when they are created and hand back their peak when they are destroyed, so growing
+ * costs nothing extra. The peaks of the allocators still alive are read when the profile is saved. A saved profile holds the
+ * peaks of this run, plus the loaded entries that this run did not use.
+ */
+class PresizeProfile
+{
+  public:
+    // The entry a presized allocator holds from its creation to its destruction
+    struct Entry
+    {
+        Size slot         = 0;
+        Size peakUsedSize = 0; // Loaded from the profile, or 0 if it has none
+    };
+
+    // Loads the profile if the file exists, and saves it to the same file at exit. Call it before creating the allocators
+    static bool Enable(const std::string& path);
+
+    // Returns false if the file cannot be read or is not a profile. Replaces the loaded peaks
+    static bool Load(const std::string& path);
+    // Writes the peaks of this run
+    static bool Save(const std::string& path);
+    // Forgets the loaded peaks and the peaks of the destroyed allocators
+    static void Clear();
+
+    // The peak used size loaded for the entry in bytes, or 0 if it has none
+    [[nodiscard]] static Size GetPeakUsedSize(const std::string& debugName, Size slot = 0);
+
+    // Claims the lowest free slot for the allocator's debug name. The allocator must have the SizeTracking policy
+    [[nodiscard]] static Entry Acquire(const std::shared_ptr<AllocatorData>& allocatorData);
+    // Records the allocator's peak used size and frees its slot
+    static void Release(const std::shared_ptr<AllocatorData>& allocatorData, Size slot);
+};
+
+} // namespace Memarena
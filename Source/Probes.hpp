@@ -0,0 +1,26 @@
+#pragma once
+
+/**
+ * USDT probes on the slow paths of the allocators, for bpftrace, perf and SystemTap. They are only compiled in when
+ * MEMARENA_USDT is defined, which requires <sys/sdt.h>, and until a tracer attaches each one is a single nop. The provider
+ * is `memarena`, and the first two arguments of every probe are the allocator and its debug name:
+ *
+ *   block_acquire(allocator, name, blockPtr, size)  A block was taken from the upstream allocator
+ *   block_release(allocator, name, blockPtr, size)  A block was given back to the upstream allocator
+ *   out_of_memory(allocator, name, size)            An allocation failed
+ *   pool_grow(allocator, name, blockCount)          A pool ran out of chunks and added a block
+ *   fallback_spill(allocator, name)                 The primary allocator of a FallbackAllocator failed an allocation
+ *   release(allocator, name)                        Release() freed every allocation at once
+ *
+ * For example: bpftrace -e 'usdt:./app:memarena:block_acquire { @blocks[str(arg1)] = count(); }'
+ */
+
+#if defined(MEMARENA_USDT)
+    #if !__has_include(<sys/sdt.h>)
+        #error "MEMARENA_USDT needs <sys/sdt.h>, which comes with the SystemTap SDT headers"
+    #endif
+    #include <sys/sdt.h>
+    #define MEMARENA_PROBE(name, ...) STAP_PROBEV(memarena, name, __VA_ARGS__)
+#else
+    #define MEMARENA_PROBE(name, ...)
+#endif
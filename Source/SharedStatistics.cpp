@@ -0,0 +1,368 @@
+#include "PCH.hpp"
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "SharedStatistics.hpp"
+
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#include "AllocatorData.hpp"
+#include "MemoryTracker.hpp"
+
+namespace Memarena
+{
+
+namespace
+{
+constexpr std::array<char, 8> sharedStatisticsMagic = {'M', 'E', 'M', 'S', 'T', 'A', 'T', 'S'};
+// A reader gives up after this many attempts that overlapped a publish
+constexpr int maxReadAttempts = 64;
+
+Size GetSharedStatisticsSize(const Size capacity) { return sizeof(SharedStatisticsHeader) + capacity * sizeof(SharedAllocatorStatistics); }
+
+SharedAllocatorStatistics* GetSlots(SharedStatisticsHeader* header) { return std::bit_cast<SharedAllocatorStatistics*>(header + 1); }
+const SharedAllocatorStatistics* GetSlots(const SharedStatisticsHeader* header)
+{
+    return std::bit_cast<const SharedAllocatorStatistics*>(header + 1);
+}
+
+UInt64 GetProcessId()
+{
+#if defined(_WIN32)
+    return GetCurrentProcessId();
+#else
+    return static_cast<UInt64>(getpid());
+#endif
+}
+
+#if defined(_WIN32)
+
+void* CreateSharedMemory(const std::string& name, const Size size)
+{
+    const UInt64 size64 = size;
+    HANDLE       handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(size64 >> 32),
+                                             static_cast<DWORD>(size64), name.c_str());
+    if (handle == nullptr)
+    {
+        return nullptr;
+    }
+    // The view keeps the mapping alive
+    void* mapping = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    CloseHandle(handle);
+    return mapping;
+}
+void DestroySharedMemory(const std::string& /*name*/, void* mapping, Size /*size*/) { UnmapViewOfFile(mapping); }
+
+void* OpenSharedMemory(const std::string& name, Size& size)
+{
+    HANDLE handle = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+    if (handle == nullptr)
+    {
+        return nullptr;
+    }
+    void* mapping = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(handle);
+
+    MEMORY_BASIC_INFORMATION information;
+    if (mapping == nullptr || VirtualQuery(mapping, &information, sizeof(information)) == 0)
+    {
+        return nullptr;
+    }
+    size = information.RegionSize;
+    return mapping;
+}
+void CloseSharedMemory(void* mapping, Size /*size*/) { UnmapViewOfFile(mapping); }
+
+#else
+
+void* CreateSharedMemory(const std::string& name, const Size size)
+{
+    const int fileDescriptor = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (fileDescriptor == -1)
+    {
+        return nullptr;
+    }
+
+    void* mapping = nullptr;
+    if (ftruncate(fileDescriptor, static_cast<off_t>(size)) == 0)
+    {
+        mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    }
+    close(fileDescriptor);
+
+    if (mapping == nullptr || mapping == MAP_FAILED)
+    {
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    return mapping;
+}
+void DestroySharedMemory(const std::string& name, void* mapping, const Size size)
+{
+    munmap(mapping, size);
+    shm_unlink(name.c_str());
+}
+
+void* OpenSharedMemory(const std::string& name, Size& size)
+{
+    const int fileDescriptor = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fileDescriptor == -1)
+    {
+        return nullptr;
+    }
+
+    void*       mapping = nullptr;
+    struct stat status  = {};
+    if (fstat(fileDescriptor, &status) == 0 && static_cast<Size>(status.st_size) >= sizeof(SharedStatisticsHeader))
+    {
+        size    = static_cast<Size>(status.st_size);
+        mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+    }
+    close(fileDescriptor);
+    return mapping == MAP_FAILED ? nullptr : mapping;
+}
+void CloseSharedMemory(void* mapping, const Size size) { munmap(mapping, size); }
+
+#endif
+
+// Only touched with the mutex held, which also keeps publishes from overlapping
+struct PublisherState
+{
+    std::mutex                             mutex;
+    std::condition_variable                wakeUp;
+    std::thread                            thread;
+    bool                                   isStopping  = false;
+    bool                                   isExitSet   = false; // The atexit handler that stops publishing is registered
+    std::string                            name;
+    SharedStatisticsHeader*                header      = nullptr;
+    Size                                   mappingSize = 0;
+    std::vector<SharedAllocatorStatistics> slots; // Reused, so that publishing does not allocate once it has warmed up
+};
+
+PublisherState& GetPublisherState()
+{
+    static PublisherState state;
+    return state;
+}
+
+void Publish(PublisherState& state)
+{
+    SharedStatisticsHeader* header       = state.header;
+    UInt32                  omittedCount = 0;
+
+    state.slots.clear();
+    MemoryTracker::ForEachAllocator([&](const AllocatorData& allocatorData) {
+        if (state.slots.size() == header->capacity)
+        {
+            omittedCount++;
+            return;
+        }
+
+        SharedAllocatorStatistics& slot = state.slots.emplace_back();
+        allocatorData.debugName.copy(slot.debugName.data(), slot.debugName.size() - 1);
+        slot.id                = allocatorData.id.value;
+        slot.parentId          = allocatorData.parentId.value;
+        slot.usedSize          = allocatorData.statistics.GetUsedSize();
+        slot.totalSize         = allocatorData.statistics.GetTotalSize();
+        slot.peakUsedSize      = allocatorData.statistics.GetPeakUsedSize();
+        slot.allocationCount   = allocatorData.statistics.GetAllocationCount();
+        slot.deallocationCount = allocatorData.statistics.GetDeallocationCount();
+    });
+
+    const auto   sinceEpoch  = std::chrono::steady_clock::now().time_since_epoch();
+    const UInt64 publishTime = static_cast<UInt64>(std::chrono::duration_cast<std::chrono::nanoseconds>(sinceEpoch).count());
+
+    // The odd sequence has to be visible before any of the writes that follow it
+    const UInt64 sequence = header->sequence.load(std::memory_order_relaxed);
+    header->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    header->publishTime    = publishTime;
+    header->allocatorCount = static_cast<UInt32>(state.slots.size());
+    header->omittedCount   = omittedCount;
+    std::memcpy(GetSlots(header), state.slots.data(), state.slots.size() * sizeof(SharedAllocatorStatistics));
+
+    header->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void RunPublisher(const std::chrono::milliseconds interval)
+{
+    PublisherState&              state = GetPublisherState();
+    std::unique_lock<std::mutex> lock(state.mutex);
+    while (!state.wakeUp.wait_for(lock, interval, [&state] { return state.isStopping; }))
+    {
+        Publish(state);
+    }
+}
+} // namespace
+
+SharedStatisticsReader::~SharedStatisticsReader() { Close(); }
+
+std::string SharedStatisticsReader::GetDefaultName(const UInt64 processId)
+{
+#if defined(_WIN32)
+    return "Local\\memarena-" + std::to_string(processId);
+#else
+    return "/memarena-" + std::to_string(processId);
+#endif
+}
+
+bool SharedStatisticsReader::Open(const std::string& name)
+{
+    Close();
+
+    Size  mappingSize = 0;
+    void* mapping     = OpenSharedMemory(name, mappingSize);
+    if (mapping == nullptr)
+    {
+        return false;
+    }
+
+    m_Mapping     = mapping;
+    m_MappingSize = mappingSize;
+    m_Header      = static_cast<const SharedStatisticsHeader*>(mapping);
+
+    if (m_Header->magic != sharedStatisticsMagic || m_Header->version != formatVersion ||
+        GetSharedStatisticsSize(m_Header->capacity) > mappingSize)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void SharedStatisticsReader::Close()
+{
+    if (m_Mapping != nullptr)
+    {
+        CloseSharedMemory(m_Mapping, m_MappingSize);
+    }
+    m_Mapping     = nullptr;
+    m_MappingSize = 0;
+    m_Header      = nullptr;
+}
+
+bool SharedStatisticsReader::Read(SharedStatisticsSnapshot& snapshot) const
+{
+    if (m_Header == nullptr)
+    {
+        return false;
+    }
+
+    for (int attempt = 0; attempt < maxReadAttempts; attempt++)
+    {
+        const UInt64 sequence = m_Header->sequence.load(std::memory_order_acquire);
+        if ((sequence & 1) != 0)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // A count torn by a publish is caught by the sequence check, but must not make the copy overrun the slots
+        const UInt32 allocatorCount = std::min(m_Header->allocatorCount, m_Header->capacity);
+        snapshot.processId          = m_Header->processId;
+        snapshot.publishTime        = m_Header->publishTime;
+        snapshot.omittedCount       = m_Header->omittedCount;
+        snapshot.allocators.resize(allocatorCount);
+        std::memcpy(snapshot.allocators.data(), GetSlots(m_Header), allocatorCount * sizeof(SharedAllocatorStatistics));
+
+        // The copies have to be done before the sequence is checked again
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_Header->sequence.load(std::memory_order_relaxed) == sequence)
+        {
+            snapshot.sequence = sequence;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MemoryTracker::StartPublishing(const std::string& name, const std::chrono::milliseconds interval, const Size capacity)
+{
+    PublisherState&                   state = GetPublisherState();
+    const std::lock_guard<std::mutex> guard(state.mutex);
+    if (state.header != nullptr)
+    {
+        return false;
+    }
+
+    const std::string sharedName  = name.empty() ? SharedStatisticsReader::GetDefaultName(GetProcessId()) : name;
+    const Size        mappingSize = GetSharedStatisticsSize(capacity);
+    void*             mapping     = CreateSharedMemory(sharedName, mappingSize);
+    if (mapping == nullptr)
+    {
+        return false;
+    }
+
+    // The header is written before the first publish, so readers never see it change
+    SharedStatisticsHeader* header = new (mapping) SharedStatisticsHeader();
+    header->magic                  = sharedStatisticsMagic;
+    header->version                = SharedStatisticsReader::formatVersion;
+    header->capacity               = static_cast<UInt32>(capacity);
+    header->processId              = GetProcessId();
+
+    state.name        = sharedName;
+    state.header      = header;
+    state.mappingSize = mappingSize;
+    state.isStopping  = false;
+    state.slots.reserve(capacity);
+    Publish(state);
+
+    // A running thread would terminate the process when the state is destroyed, and the memory would outlive it
+    if (!state.isExitSet)
+    {
+        state.isExitSet = std::atexit(StopPublishing) == 0;
+    }
+
+    state.thread = std::thread(RunPublisher, interval);
+    return true;
+}
+
+void MemoryTracker::StopPublishing()
+{
+    PublisherState& state = GetPublisherState();
+    std::thread     thread;
+    {
+        const std::lock_guard<std::mutex> guard(state.mutex);
+        state.isStopping = true;
+        thread           = std::move(state.thread);
+    }
+    state.wakeUp.notify_all();
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+
+    const std::lock_guard<std::mutex> guard(state.mutex);
+    if (state.header != nullptr)
+    {
+        DestroySharedMemory(state.name, state.header, state.mappingSize);
+    }
+    state.header      = nullptr;
+    state.mappingSize = 0;
+    state.name.clear();
+}
+
+void MemoryTracker::PublishStatistics()
+{
+    PublisherState&                   state = GetPublisherState();
+    const std::lock_guard<std::mutex> guard(state.mutex);
+    if (state.header != nullptr)
+    {
+        Publish(state);
+    }
+}
+
+} // namespace Memarena
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "Source/Aliases.hpp"
+
+namespace Memarena
+{
+
+// The counters of one allocator, as they are laid out in the shared memory
+struct SharedAllocatorStatistics
+{
+    std::array<char, 64> debugName{}; // Cut short to fit, and always null terminated
+    UInt32               id                = 0;
+    UInt32               parentId          = 0;
+    UInt64               usedSize          = 0;
+    UInt64               totalSize         = 0;
+    UInt64               peakUsedSize      = 0;
+    UInt64               allocationCount   = 0;
+    UInt64               deallocationCount = 0;
+};
+
+/**
+ * @brief The start of the shared memory. It is followed by `capacity` slots of SharedAllocatorStatistics. Everything after
+ * the sequence is guarded by it: the publisher makes it odd before writing and even again after, so a reader that sees the
+ * same even sequence before and after copying has a consistent snapshot.
+ */
+struct SharedStatisticsHeader
+{
+    std::array<char, 8> magic{};
+    UInt32              version        = 0;
+    UInt32              capacity       = 0;
+    UInt64              processId      = 0;
+    std::atomic<UInt64> sequence       = 0;
+    UInt64              publishTime    = 0; // Nanoseconds on the steady clock, which is shared by all processes
+    UInt32              allocatorCount = 0; // The slots in use
+    UInt32              omittedCount   = 0; // The allocators that did not fit into the slots
+};
+
+// A consistent copy of the shared memory
+struct SharedStatisticsSnapshot
+{
+    UInt64                                 processId    = 0;
+    UInt64                                 sequence     = 0;
+    UInt64                                 publishTime  = 0;
+    UInt32                                 omittedCount = 0;
+    std::vector<SharedAllocatorStatistics> allocators;
+};
+
+/**
+ * @brief Attaches to the statistics that a process publishes with MemoryTracker::StartPublishing. Reading never blocks the
+ * publisher, it retries instead if a publish was in progress.
+ */
+class SharedStatisticsReader
+{
+  public:
+    static constexpr UInt32 formatVersion = 1;
+
+    SharedStatisticsReader() = default;
+    ~SharedStatisticsReader();
+
+    SharedStatisticsReader(const SharedStatisticsReader&) = delete;
+    SharedStatisticsReader(SharedStatisticsReader&&)      = delete;
+    SharedStatisticsReader& operator=(const SharedStatisticsReader&) = delete;
+    SharedStatisticsReader& operator=(SharedStatisticsReader&&) = delete;
+
+    // The name that a process publishes under unless it is given one
+    [[nodiscard]] static std::string GetDefaultName(UInt64 processId);
+
+    // Returns false if nothing is published under `name`, or it is not of this format version
+    bool Open(const std::string& name);
+    void Close();
+
+    // Returns false if no consistent copy could be taken, because the publisher kept writing
+    bool Read(SharedStatisticsSnapshot& snapshot) const;
+
+  private:
+    void*                         m_Mapping     = nullptr;
+    Size                          m_MappingSize = 0;
+    const SharedStatisticsHeader* m_Header      = nullptr;
+};
+
+} // namespace Memarena
@@ -0,0 +1,296 @@
+#include "PCH.hpp"
+
+#include "MemoryTracker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <limits>
+#include <string_view>
+
+#include "AllocatorData.hpp"
+
+namespace Memarena
+{
+
+namespace
+{
+// Closes the file when it goes out of scope
+class SnapshotFile
+{
+  public:
+    explicit SnapshotFile(const std::string& path) : m_File(fopen(path.c_str(), "wb")) {}
+    ~SnapshotFile()
+    {
+        if (m_File != nullptr)
+        {
+            fclose(m_File);
+        }
+    }
+
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile(SnapshotFile&&)      = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(SnapshotFile&&) = delete;
+
+    [[nodiscard]] FILE* Get() const { return m_File; }
+
+    // Flushes and closes the file, and reports whether every write succeeded
+    bool Close()
+    {
+        const bool succeeded = ferror(m_File) == 0;
+        const bool closed    = fclose(m_File) == 0;
+        m_File               = nullptr;
+        return succeeded && closed;
+    }
+
+  private:
+    FILE* m_File;
+};
+
+void WriteEscapedString(FILE* file, const std::string_view string)
+{
+    for (const char character : string)
+    {
+        switch (character)
+        {
+        case '"': fputs("\\\"", file); break;
+        case '\\': fputs("\\\\", file); break;
+        case '\n': fputs("\\n", file); break;
+        case '\t': fputs("\\t", file); break;
+        default:
+            if (static_cast<unsigned char>(character) < 0x20)
+            {
+                fprintf(file, "\\u%04x", static_cast<unsigned int>(character));
+            }
+            else
+            {
+                fputc(character, file);
+            }
+        }
+    }
+}
+
+void WriteString(FILE* file, const std::string_view string)
+{
+    fputc('"', file);
+    WriteEscapedString(file, string);
+    fputc('"', file);
+}
+
+void WriteLatency(FILE* file, const char* name, const LatencyPercentiles& latency)
+{
+    fprintf(file, "\"%s\":{\"count\":%llu,\"p50\":%llu,\"p99\":%llu,\"p999\":%llu,\"max\":%llu}", name, static_cast<ULLInt>(latency.count),
+            static_cast<ULLInt>(latency.p50), static_cast<ULLInt>(latency.p99), static_cast<ULLInt>(latency.p999),
+            static_cast<ULLInt>(latency.max));
+}
+
+void WriteAllocatorNode(FILE* file, const AllocatorTreeNode& node)
+{
+    const AllocatorData&       allocatorData = *node.allocatorData;
+    const AllocatorStatistics& statistics    = allocatorData.statistics;
+
+    fprintf(file, "{\"id\":%u,\"parentId\":%u,\"name\":", allocatorData.id.value, allocatorData.parentId.value);
+    WriteString(file, allocatorData.debugName);
+    fprintf(file, ",\"isBaseAllocator\":%s", allocatorData.isBaseAllocator ? "true" : "false");
+
+    fprintf(file, ",\"usedSize\":%llu,\"totalSize\":%llu,\"peakUsedSize\":%llu,\"slackSize\":%llu",
+            static_cast<ULLInt>(statistics.GetUsedSize()), static_cast<ULLInt>(statistics.GetTotalSize()),
+            static_cast<ULLInt>(statistics.GetPeakUsedSize()), static_cast<ULLInt>(statistics.GetSlackSize()));
+    fprintf(file, ",\"allocationCount\":%u,\"deallocationCount\":%u", statistics.GetAllocationCount(), statistics.GetDeallocationCount());
+    fprintf(file, ",\"subtree\":{\"usedSize\":%llu,\"totalSize\":%llu,\"peakUsedSize\":%llu}", static_cast<ULLInt>(node.usedSize),
+            static_cast<ULLInt>(node.totalSize), static_cast<ULLInt>(node.peakUsedSize));
+
+    const WasteMetrics waste = statistics.GetWasteMetrics();
+    fprintf(file,
+            ",\"waste\":{\"paddingSize\":%llu,\"headerSize\":%llu,\"tailWasteSize\":%llu,\"freeSize\":%llu,\"largestFreeSize\":%llu,"
+            "\"fragmentationScore\":%.4f}",
+            static_cast<ULLInt>(waste.paddingSize), static_cast<ULLInt>(waste.headerSize), static_cast<ULLInt>(waste.tailWasteSize),
+            static_cast<ULLInt>(waste.freeSize), static_cast<ULLInt>(waste.largestFreeSize), waste.GetFragmentationScore());
+
+    fputs(",\"sizeHistogram\":[", file);
+    const std::vector<HistogramBucket> buckets = allocatorData.sizeHistogram.GetBuckets();
+    for (Size i = 0; i < buckets.size(); i++)
+    {
+        fprintf(file, "%s{\"lowerBound\":%llu,\"upperBound\":%llu,\"count\":%llu}", i > 0 ? "," : "",
+                static_cast<ULLInt>(buckets[i].lowerBound), static_cast<ULLInt>(buckets[i].upperBound),
+                static_cast<ULLInt>(buckets[i].count));
+    }
+    fputs("]", file);
+
+    fputs(",\"latencyNanoseconds\":{", file);
+    WriteLatency(file, "allocate", MemoryTracker::GetLatencyPercentiles(allocatorData, LatencyOperation::Allocate));
+    fputc(',', file);
+    WriteLatency(file, "deallocate", MemoryTracker::GetLatencyPercentiles(allocatorData, LatencyOperation::Deallocate));
+    fputc(',', file);
+    WriteLatency(file, "blockRefill", MemoryTracker::GetLatencyPercentiles(allocatorData, LatencyOperation::BlockRefill));
+    fputs("}", file);
+
+    fputs(",\"children\":[", file);
+    for (Size i = 0; i < node.children.size(); i++)
+    {
+        fputs(i > 0 ? ",\n" : "\n", file);
+        WriteAllocatorNode(file, node.children[i]);
+    }
+    fputs("]}", file);
+}
+
+void WriteJson(FILE* file)
+{
+    fprintf(file, "{\"totalAllocatedSize\":%llu,\"allocators\":[", static_cast<ULLInt>(MemoryTracker::GetTotalAllocatedSize()));
+
+    const std::vector<AllocatorTreeNode> tree = MemoryTracker::GetAllocatorTree();
+    for (Size i = 0; i < tree.size(); i++)
+    {
+        fputs(i > 0 ? ",\n" : "\n", file);
+        WriteAllocatorNode(file, tree[i]);
+    }
+
+    fputs("\n]}\n", file);
+}
+
+void WriteChromeTrace(FILE* file)
+{
+    AllocatorVector allocators = MemoryTracker::GetBaseAllocators();
+    AllocatorVector trackedAllocators = MemoryTracker::GetAllocators();
+    allocators.insert(allocators.end(), trackedAllocators.begin(), trackedAllocators.end());
+
+    // The event logs are copied first, so that every track shares the time of the oldest retained event as its origin
+    std::vector<std::vector<AllocationEvent>> eventLogs;
+    UInt64                                    startTimestamp = std::numeric_limits<UInt64>::max();
+    for (const auto& allocatorData : allocators)
+    {
+        const std::vector<AllocationEvent>& events = eventLogs.emplace_back(allocatorData->allocationEvents.GetEvents());
+        if (!events.empty())
+        {
+            startTimestamp = std::min(startTimestamp, events.front().timestamp);
+        }
+    }
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file);
+    fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Memarena\"}}", file);
+
+    for (Size i = 0; i < allocators.size(); i++)
+    {
+        const AllocatorData& allocatorData = *allocators[i];
+        const UInt32         trackId       = allocatorData.id.value;
+
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", trackId);
+        WriteString(file, allocatorData.debugName);
+        fputs("}}", file);
+
+        // Relative to the oldest retained event, as older events have been dropped from the log
+        Int64 liveSize = 0;
+        for (const AllocationEvent& event : eventLogs[i])
+        {
+            const double timestamp = static_cast<double>(event.timestamp - startTimestamp) / 1000.0;
+            liveSize += event.isDeallocation ? -static_cast<Int64>(event.size) : static_cast<Int64>(event.size);
+
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":", event.isDeallocation ? "Deallocate" : "Allocate");
+            WriteString(file, CategoryRegistry::GetName(event.category));
+            fprintf(file, ",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"size\":%u", timestamp, trackId,
+                    static_cast<UInt32>(event.size));
+            if (!event.isDeallocation)
+            {
+                const CallSite callSite = CallSiteRegistry::Get(event.callSite);
+                fputs(",\"callSite\":\"", file);
+                WriteEscapedString(file, callSite.fileName);
+                fprintf(file, ":%u\"", callSite.line);
+            }
+            fputs("}}", file);
+
+            fputs(",\n{\"name\":\"", file);
+            WriteEscapedString(file, allocatorData.debugName);
+            fprintf(file, " #%u\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{\"liveSize\":%lld}}", trackId, timestamp,
+                    static_cast<long long>(liveSize));
+        }
+    }
+
+    fputs("\n]}\n", file);
+}
+void WriteHeapProfileCounts(FILE* file, const HeapProfileEntry& entry)
+{
+    fprintf(file, "%6llu: %8llu [%6llu: %8llu] @", static_cast<ULLInt>(entry.liveCount), static_cast<ULLInt>(entry.liveSize),
+            static_cast<ULLInt>(entry.allocatedCount), static_cast<ULLInt>(entry.allocatedSize));
+}
+
+// pprof reads the memory map to find the binaries that the addresses in the stacks belong to
+void WriteMappedLibraries(FILE* file)
+{
+    fputs("\nMAPPED_LIBRARIES:\n", file);
+
+#if defined(__linux__)
+    FILE* maps = fopen("/proc/self/maps", "rb");
+    if (maps == nullptr)
+    {
+        return;
+    }
+
+    std::array<char, 4096> buffer{};
+    Size                   readSize = 0;
+    while ((readSize = fread(buffer.data(), 1, buffer.size(), maps)) > 0)
+    {
+        fwrite(buffer.data(), 1, readSize, file);
+    }
+    fclose(maps);
+#endif
+}
+} // namespace
+
+bool MemoryTracker::WriteHeapProfile(const std::string& path)
+{
+    SnapshotFile file(path);
+    if (file.Get() == nullptr)
+    {
+        return false;
+    }
+
+    const std::vector<HeapProfileEntry> profile = GetHeapProfile();
+
+    HeapProfileEntry total;
+    for (const HeapProfileEntry& entry : profile)
+    {
+        total.liveCount += entry.liveCount;
+        total.liveSize += entry.liveSize;
+        total.allocatedCount += entry.allocatedCount;
+        total.allocatedSize += entry.allocatedSize;
+    }
+
+    // The header holds the totals, and names the sample interval that pprof uses to scale the samples back up
+    fputs("heap profile: ", file.Get());
+    WriteHeapProfileCounts(file.Get(), total);
+    fprintf(file.Get(), " heap_v2/%llu\n", static_cast<ULLInt>(HeapSampler::GetSampleInterval()));
+
+    for (const HeapProfileEntry& entry : profile)
+    {
+        WriteHeapProfileCounts(file.Get(), entry);
+        for (UInt32 i = 0; i < entry.stackTrace.depth; i++)
+        {
+            fprintf(file.Get(), " 0x%llx", static_cast<ULLInt>(std::bit_cast<UIntPtr>(entry.stackTrace.frames[i])));
+        }
+        fputc('\n', file.Get());
+    }
+
+    WriteMappedLibraries(file.Get());
+
+    return file.Close();
+}
+
+bool MemoryTracker::WriteSnapshot(const std::string& path, const SnapshotFormat format)
+{
+    SnapshotFile file(path);
+    if (file.Get() == nullptr)
+    {
+        return false;
+    }
+
+    switch (format)
+    {
+    case SnapshotFormat::Json: WriteJson(file.Get()); break;
+    case SnapshotFormat::ChromeTrace: WriteChromeTrace(file.Get()); break;
+    }
+
+    return file.Close();
+}
+
+} // namespace Memarena
@@ -0,0 +1,317 @@
+#include "PCH.hpp"
+
+#include "TraceRecorder.hpp"
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
+namespace Memarena
+{
+
+namespace
+{
+struct TraceFileHeader
+{
+    std::array<char, 8> magic{};
+    UInt32              version     = 0;
+    UInt32              recordSize  = 0;
+    UInt64              recordCount = 0;
+};
+
+constexpr std::array<char, 8> traceMagic     = {'M', 'E', 'M', 'T', 'R', 'A', 'C', 'E'};
+constexpr Size                bufferCapacity = 4096;
+// The count is written when the recording stops, so a trace that keeps this one was cut short
+constexpr UInt64 unfinishedRecordCount = std::numeric_limits<UInt64>::max();
+
+// Each call site is its line and the lengths of its names, followed by the names without terminators
+struct TraceCallSiteHeader
+{
+    UInt32 line               = 0;
+    UInt32 fileNameLength     = 0;
+    UInt32 functionNameLength = 0;
+};
+
+struct LivePointer
+{
+    UInt32 id          = 0;
+    UInt32 allocatorId = 0;
+};
+
+// Only touched with the mutex held
+struct RecorderState
+{
+    std::mutex                                   mutex;
+    FILE*                                        file           = nullptr;
+    bool                                         hasWriteFailed = false;
+    std::vector<TraceRecord>                     buffer;
+    UInt64                                       recordCount = 0;
+    std::unordered_map<const void*, LivePointer> livePointers;
+    UInt32                                       nextPointerId = 1;
+    std::chrono::steady_clock::time_point        startTime;
+};
+
+RecorderState& GetState()
+{
+    static RecorderState state;
+    return state;
+}
+
+std::atomic<UInt32> nextThreadId = 1;
+thread_local UInt32 t_ThreadId   = 0;
+
+UInt32 GetThreadId()
+{
+    if (t_ThreadId == 0)
+    {
+        t_ThreadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+    }
+    return t_ThreadId;
+}
+
+void Flush(RecorderState& state)
+{
+    if (!state.buffer.empty() && fwrite(state.buffer.data(), sizeof(TraceRecord), state.buffer.size(), state.file) != state.buffer.size())
+    {
+        state.hasWriteFailed = true;
+    }
+    state.buffer.clear();
+}
+
+void Append(RecorderState& state, TraceRecord record)
+{
+    const auto elapsed = std::chrono::steady_clock::now() - state.startTime;
+    record.timestamp   = static_cast<UInt64>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    record.threadId    = GetThreadId();
+
+    state.buffer.push_back(record);
+    state.recordCount++;
+    if (state.buffer.size() == bufferCapacity)
+    {
+        Flush(state);
+    }
+}
+bool WriteHeader(FILE* file, const UInt64 recordCount)
+{
+    const TraceFileHeader header = {.magic = traceMagic, .version = TraceRecorder::formatVersion, .recordSize = sizeof(TraceRecord),
+                                    .recordCount = recordCount};
+    return fwrite(&header, sizeof(header), 1, file) == 1;
+}
+
+bool WriteBytes(FILE* file, const void* data, const Size size) { return size == 0 || fwrite(data, 1, size, file) == size; }
+bool ReadBytes(FILE* file, void* data, const Size size) { return size == 0 || fread(data, 1, size, file) == size; }
+
+// Writes every registered call site, as the records only hold their ids
+bool WriteCallSites(FILE* file)
+{
+    const auto callSiteCount = static_cast<UInt32>(CallSiteRegistry::GetCallSiteCount());
+    bool       succeeded     = WriteBytes(file, &callSiteCount, sizeof(callSiteCount));
+
+    for (UInt32 id = 0; id < callSiteCount && succeeded; id++)
+    {
+        const CallSite            callSite = CallSiteRegistry::Get(CallSiteId{static_cast<UInt16>(id)});
+        const TraceCallSiteHeader header   = {.line               = callSite.line,
+                                              .fileNameLength     = static_cast<UInt32>(strlen(callSite.fileName)),
+                                              .functionNameLength = static_cast<UInt32>(strlen(callSite.functionName))};
+
+        succeeded = WriteBytes(file, &header, sizeof(header)) && WriteBytes(file, callSite.fileName, header.fileNameLength) &&
+                    WriteBytes(file, callSite.functionName, header.functionNameLength);
+    }
+    return succeeded;
+}
+
+bool ReadCallSites(FILE* file, std::vector<TraceCallSite>& callSites)
+{
+    UInt32 callSiteCount = 0;
+    if (!ReadBytes(file, &callSiteCount, sizeof(callSiteCount)))
+    {
+        return false;
+    }
+
+    callSites.resize(callSiteCount);
+    for (TraceCallSite& callSite : callSites)
+    {
+        TraceCallSiteHeader header;
+        if (!ReadBytes(file, &header, sizeof(header)))
+        {
+            return false;
+        }
+
+        callSite.line = header.line;
+        callSite.fileName.resize(header.fileNameLength);
+        callSite.functionName.resize(header.functionNameLength);
+        if (!ReadBytes(file, callSite.fileName.data(), header.fileNameLength) ||
+            !ReadBytes(file, callSite.functionName.data(), header.functionNameLength))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+bool TraceRecorder::Start(const std::string& path)
+{
+    RecorderState&                    state = GetState();
+    const std::lock_guard<std::mutex> guard(state.mutex);
+
+    if (state.file != nullptr)
+    {
+        return false;
+    }
+
+    state.file = fopen(path.c_str(), "wb");
+    if (state.file == nullptr)
+    {
+        return false;
+    }
+
+    state.hasWriteFailed = !WriteHeader(state.file, unfinishedRecordCount);
+    state.buffer.reserve(bufferCapacity);
+    state.recordCount   = 0;
+    state.nextPointerId = 1;
+    state.startTime     = std::chrono::steady_clock::now();
+
+    m_IsRecording.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+bool TraceRecorder::Stop()
+{
+    RecorderState&                    state = GetState();
+    const std::lock_guard<std::mutex> guard(state.mutex);
+
+    if (state.file == nullptr)
+    {
+        return false;
+    }
+
+    m_IsRecording.store(false, std::memory_order_relaxed);
+
+    Flush(state);
+    if (!WriteCallSites(state.file) || fseek(state.file, 0, SEEK_SET) != 0 || !WriteHeader(state.file, state.recordCount))
+    {
+        state.hasWriteFailed = true;
+    }
+
+    const bool isClosed  = fclose(state.file) == 0;
+    const bool succeeded = !state.hasWriteFailed && isClosed;
+    state.file           = nullptr;
+    state.livePointers.clear();
+
+    return succeeded;
+}
+
+void TraceRecorder::RecordAllocation(const UInt32 allocatorId, const void* ptr, const Size size, const Size alignment,
+                                     const CallSiteId callSite)
+{
+    RecorderState&                    state = GetState();
+    const std::lock_guard<std::mutex> guard(state.mutex);
+
+    if (state.file == nullptr || ptr == nullptr)
+    {
+        return;
+    }
+
+    const UInt32 pointerId  = state.nextPointerId++;
+    state.livePointers[ptr] = {.id = pointerId, .allocatorId = allocatorId};
+
+    Append(state, {.size           = size,
+                   .allocatorId    = allocatorId,
+                   .pointerId      = pointerId,
+                   .alignmentShift = static_cast<UInt8>(std::countr_zero(alignment)),
+                   .operation      = TraceOperation::Allocate,
+                   .callSite       = callSite.value});
+}
+
+void TraceRecorder::RecordDeallocation(const UInt32 allocatorId, const void* ptr)
+{
+    RecorderState&                    state = GetState();
+    const std::lock_guard<std::mutex> guard(state.mutex);
+
+    const auto it = state.livePointers.find(ptr);
+    if (state.file == nullptr || it == state.livePointers.end())
+    {
+        return;
+    }
+
+    Append(state, {.allocatorId = allocatorId, .pointerId = it->second.id, .operation = TraceOperation::Deallocate});
+    state.livePointers.erase(it);
+}
+
+void TraceRecorder::RecordReallocation(const UInt32 allocatorId, const void* oldPtr, const void* newPtr, const Size newSize)
+{
+    RecorderState&                    state = GetState();
+    const std::lock_guard<std::mutex> guard(state.mutex);
+
+    const auto it = state.livePointers.find(oldPtr);
+    if (state.file == nullptr || it == state.livePointers.end())
+    {
+        return;
+    }
+
+    const LivePointer livePointer = it->second;
+    state.livePointers.erase(it);
+    state.livePointers[newPtr] = livePointer;
+
+    Append(state, {.size = newSize, .allocatorId = allocatorId, .pointerId = livePointer.id, .operation = TraceOperation::Reallocate});
+}
+
+void TraceRecorder::RecordRelease(const UInt32 allocatorId)
+{
+    RecorderState&                    state = GetState();
+    const std::lock_guard<std::mutex> guard(state.mutex);
+
+    if (state.file == nullptr)
+    {
+        return;
+    }
+
+    std::erase_if(state.livePointers, [&](const auto& entry) { return entry.second.allocatorId == allocatorId; });
+    Append(state, {.allocatorId = allocatorId, .operation = TraceOperation::Release});
+}
+
+bool TraceRecorder::ReadTrace(const std::string& path, Trace& trace)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    TraceFileHeader header;
+    const bool      hasHeader = fread(&header, sizeof(header), 1, file) == 1;
+    bool            isValid   = hasHeader && header.magic == traceMagic && header.version == formatVersion &&
+                         header.recordSize == sizeof(TraceRecord);
+
+    trace.records.clear();
+    trace.callSites.clear();
+    if (isValid)
+    {
+        std::array<TraceRecord, 1024> chunk{};
+        while (trace.records.size() < header.recordCount)
+        {
+            const Size chunkSize = std::min<UInt64>(chunk.size(), header.recordCount - trace.records.size());
+            const Size readCount = fread(chunk.data(), sizeof(TraceRecord), chunkSize, file);
+            trace.records.insert(trace.records.end(), chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(readCount));
+            if (readCount < chunkSize)
+            {
+                break;
+            }
+        }
+
+        if (header.recordCount != unfinishedRecordCount)
+        {
+            isValid = trace.records.size() == header.recordCount && ReadCallSites(file, trace.callSites);
+        }
+    }
+
+    const bool succeeded = isValid && ferror(file) == 0;
+    fclose(file);
+    return succeeded;
+}
+
+} // namespace Memarena
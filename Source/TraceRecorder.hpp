@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "Source/Aliases.hpp"
+#include "Source/CallSite.hpp"
+
+namespace Memarena
+{
+
+enum class TraceOperation : UInt8
+{
+    Allocate,
+    Deallocate,
+    Reallocate, // Moves the pointer id to a new block of the new size
+    Release,    // Frees every allocation of the allocator at once
+};
+
+/**
+ * @brief One operation of a recorded trace. Pointers are replaced by ids that are numbered in the order of allocation, so
+ * a trace can be replayed against any allocator.
+ */
+struct TraceRecord
+{
+    UInt64         timestamp      = 0; // Nanoseconds since the recording started
+    UInt64         size           = 0; // The requested size, or the new size of a reallocation
+    UInt32         allocatorId    = 0;
+    UInt32         pointerId      = 0; // 0 for releases
+    UInt32         threadId       = 0; // Threads are numbered from 1 in the order they first record
+    UInt8          alignmentShift = 0; // The alignment is 1 << alignmentShift
+    TraceOperation operation      = TraceOperation::Allocate;
+    UInt16         callSite       = 0; // Allocations only. Indexes Trace::callSites
+};
+
+static_assert(sizeof(TraceRecord) == 32, "The trace file format depends on the record layout");
+
+struct TraceCallSite
+{
+    std::string fileName;
+    std::string functionName;
+    UInt32      line = 0;
+};
+
+struct Trace
+{
+    std::vector<TraceRecord>   records;
+    std::vector<TraceCallSite> callSites; // Empty if the recording was never stopped
+};
+
+/**
+ * @brief Writes the operations of the allocators with the TraceRecording policy to a binary file while a recording is
+ * running. The file is a 24 byte header, the TraceRecords, and then the table of call sites, all in the byte order of the
+ * recording machine. Records are buffered and written in batches under a lock, so recording serializes the allocators. It
+ * is meant for capturing a workload, not for running all the time.
+ */
+class TraceRecorder
+{
+  public:
+    static constexpr UInt32 formatVersion = 2;
+
+    // Returns false if a recording is already running or the file cannot be opened
+    static bool Start(const std::string& path);
+    // Returns false if no recording was running or the trace could not be written completely
+    static bool Stop();
+
+    [[nodiscard]] static inline bool IsRecording() noexcept { return m_IsRecording.load(std::memory_order_relaxed); }
+
+    // Operations on pointers that were allocated before the recording started are skipped
+    static void RecordAllocation(UInt32 allocatorId, const void* ptr, Size size, Size alignment, CallSiteId callSite);
+    static void RecordDeallocation(UInt32 allocatorId, const void* ptr);
+    static void RecordReallocation(UInt32 allocatorId, const void* oldPtr, const void* newPtr, Size newSize);
+    static void RecordRelease(UInt32 allocatorId);
+
+    // Returns false if the file is missing, or is not a trace of this format version. The records of a recording that was
+    // never stopped are read up to the end of the file
+    static bool ReadTrace(const std::string& path, Trace& trace);
+
+  private:
+    inline static std::atomic<bool> m_IsRecording = false;
+};
+
+} // namespace Memarena
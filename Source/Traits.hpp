@@ -1,7 +1,10 @@
 #pragma once
 
+#include <concepts>
 #include <type_traits>
 
+#include "Source/Aliases.hpp"
+
 namespace Memarena
 {
 template <class T>
@@ -9,4 +12,13 @@ concept Allocatable = std::negation<std::is_same<T, void>>::value;
 
 template <typename T>
 concept Integral = std::is_integral<T>::value;
+
+template <typename T>
+concept BaseAllocatable = requires(T allocator, Size size, Size alignment, void* ptr)
+{
+    {
+        allocator.AllocateBase(size, alignment)
+        } -> std::same_as<void*>;
+    allocator.DeallocateBase(ptr);
+};
 } // namespace Memarena
\ No newline at end of file
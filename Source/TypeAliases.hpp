@@ -5,8 +5,9 @@
 
 namespace Memarena
 {
-using Padding = UInt8;
-using Offset  = UInt32;
+using Padding     = UInt32;
+using Offset      = UInt32;
+using LargeOffset = UInt64; // Used by allocators with the LargeOffsets policy, for arenas larger than 4 GiB
 
 template <typename T>
 using RawPtr = T*;
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+
+#if defined(_WIN32)
+    #include <malloc.h>
+#endif
+
+#include "Source/Aliases.hpp"
+
+namespace Memarena
+{
+
+// The alignment that every block returned by malloc satisfies
+constexpr Size mallocAlignment = alignof(std::max_align_t);
+
+#if defined(_WIN32)
+// Over-aligned blocks come from _aligned_malloc and must be released with _aligned_free
+constexpr bool AlignedMallocIsFreeCompatible = false;
+#else
+// Over-aligned blocks come from posix_memalign, so free works on every block
+constexpr bool AlignedMallocIsFreeCompatible = true;
+#endif
+
+/**
+ * @brief Allocates a block from the C heap that is aligned to at least `alignment`. Uses plain malloc when its own
+ * alignment is enough.
+ *
+ * @param alignment A power of 2
+ * @return The block, or nullptr if the allocation failed
+ */
+inline void* AlignedMalloc(const Size size, const Size alignment)
+{
+    if (alignment <= mallocAlignment)
+    {
+        return malloc(size);
+    }
+
+#if defined(_WIN32)
+    return _aligned_malloc(size, alignment);
+#else
+    void* ptr = nullptr;
+    return posix_memalign(&ptr, alignment, size) == 0 ? ptr : nullptr;
+#endif
+}
+
+/**
+ * @brief Frees a block returned by AlignedMalloc. `alignment` must be the value that the block was allocated with.
+ */
+inline void AlignedFree(void* ptr, [[maybe_unused]] const Size alignment)
+{
+#if defined(_WIN32)
+    if (alignment > mallocAlignment)
+    {
+        _aligned_free(ptr);
+        return;
+    }
+#endif
+    free(ptr);
+}
+
+} // namespace Memarena
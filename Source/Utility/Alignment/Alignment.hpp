@@ -3,6 +3,7 @@
 #include <cstddef>
 
 #include "Source/Aliases.hpp"
+#include "Source/Assert.hpp"
 #include "Source/TypeAliases.hpp"
 
 namespace Memarena
@@ -10,21 +11,96 @@ namespace Memarena
 
 constexpr Size defaultAlignment = alignof(std::max_align_t);
 
+constexpr bool IsAlignmentValid(const Size alignment) { return (alignment != 0) && ((alignment & (alignment - 1)) == 0); }
+
 class Alignment
 {
   public:
-    Alignment(Size alignment); // NOLINT
+    constexpr Alignment(Size alignment) : value(alignment) // NOLINT
+    {
+        MEMARENA_DEFAULT_ASSERT(IsAlignmentValid(alignment), "Invalid alignment %llu. Alignment must be a power of 2 and not equal to 0!",
+                                static_cast<ULLInt>(alignment))
+    }
 
-    operator UInt8() const noexcept { return value; } // NOLINT
+    constexpr operator Size() const noexcept { return value; } // NOLINT
 
   private:
-    UInt8 value;
+    Size value;
 };
 
-UIntPtr CalculateAlignedAddress(UIntPtr baseAddress, const Alignment& alignment);
-Padding CalculateShortestAlignedPadding(UIntPtr baseAddress, const Alignment& alignment);
-Padding CalculateAlignedPaddingWithHeader(UIntPtr baseAddress, const Alignment& alignment, Size headerSize);
-Padding ExtendPaddingForHeader(Padding padding, const Alignment& alignment, Size headerSize);
-bool    IsAlignmentValid(int alignment);
+/**
+ * @brief An alignment that is known at compile time. The alignment functions have overloads for it, so the masks they
+ * compute fold into constants instead of being derived from a runtime value.
+ *
+ * @tparam Value The alignment in bytes. Must be a power of 2
+ */
+template <Size Value>
+struct StaticAlignment
+{
+    static_assert(IsAlignmentValid(Value), "Alignment must be a power of 2 and not equal to 0!");
+
+    static constexpr Size value = Value;
+
+    constexpr operator Alignment() const noexcept { return Alignment(Value); } // NOLINT
+};
+
+namespace Internal
+{
+constexpr UIntPtr AlignAddress(const UIntPtr baseAddress, const Size alignment)
+{
+    return (baseAddress + (alignment - 1)) & ~(alignment - 1);
+}
+
+constexpr Padding ExtendPadding(const Padding padding, const Size alignment, const Size headerSize)
+{
+    // Space that is still needed for the header, rounded up to a whole number of alignments. Zero if it already fits.
+    const Size deficit = (headerSize > padding ? headerSize : padding) - padding;
+    return static_cast<Padding>(padding + ((deficit + (alignment - 1)) & ~(alignment - 1)));
+}
+} // namespace Internal
+
+constexpr UIntPtr CalculateAlignedAddress(const UIntPtr baseAddress, const Alignment& alignment)
+{
+    return Internal::AlignAddress(baseAddress, alignment);
+}
+
+template <Size Value>
+constexpr UIntPtr CalculateAlignedAddress(const UIntPtr baseAddress, StaticAlignment<Value> /*alignment*/)
+{
+    return Internal::AlignAddress(baseAddress, Value);
+}
+
+constexpr Padding CalculateShortestAlignedPadding(const UIntPtr baseAddress, const Alignment& alignment)
+{
+    return static_cast<Padding>(Internal::AlignAddress(baseAddress, alignment) - baseAddress);
+}
+
+template <Size Value>
+constexpr Padding CalculateShortestAlignedPadding(const UIntPtr baseAddress, StaticAlignment<Value> /*alignment*/)
+{
+    return static_cast<Padding>(Internal::AlignAddress(baseAddress, Value) - baseAddress);
+}
+
+constexpr Padding ExtendPaddingForHeader(const Padding padding, const Alignment& alignment, const Size headerSize)
+{
+    return Internal::ExtendPadding(padding, alignment, headerSize);
+}
+
+template <Size Value>
+constexpr Padding ExtendPaddingForHeader(const Padding padding, StaticAlignment<Value> /*alignment*/, const Size headerSize)
+{
+    return Internal::ExtendPadding(padding, Value, headerSize);
+}
+
+constexpr Padding CalculateAlignedPaddingWithHeader(const UIntPtr baseAddress, const Alignment& alignment, const Size headerSize)
+{
+    return ExtendPaddingForHeader(CalculateShortestAlignedPadding(baseAddress, alignment), alignment, headerSize);
+}
+
+template <Size Value>
+constexpr Padding CalculateAlignedPaddingWithHeader(const UIntPtr baseAddress, StaticAlignment<Value> alignment, const Size headerSize)
+{
+    return ExtendPaddingForHeader(CalculateShortestAlignedPadding(baseAddress, alignment), alignment, headerSize);
+}
 
 } // namespace Memarena
@@ -0,0 +1,40 @@
+#include "PCH.hpp"
+
+#include "CycleClock.hpp"
+
+#include <chrono>
+
+namespace Memarena
+{
+
+namespace
+{
+double MeasureCyclesPerNanosecond()
+{
+#if defined(MEMARENA_HAS_CYCLE_COUNTER)
+    using namespace std::chrono_literals;
+
+    const auto   startTime   = std::chrono::steady_clock::now();
+    const UInt64 startCycles = ReadCycleCounter();
+    while (std::chrono::steady_clock::now() - startTime < 5ms)
+    {
+    }
+    const UInt64 cycles  = ReadCycleCounter() - startCycles;
+    const auto   elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime);
+
+    return static_cast<double>(cycles) / static_cast<double>(elapsed.count());
+#elif defined(_WIN32)
+    return static_cast<double>(std::chrono::steady_clock::period::den) / std::chrono::steady_clock::period::num / 1e9;
+#else
+    return 1.0;
+#endif
+}
+} // namespace
+
+UInt64 CyclesToNanoseconds(const UInt64 cycles)
+{
+    static const double cyclesPerNanosecond = MeasureCyclesPerNanosecond();
+    return static_cast<UInt64>(static_cast<double>(cycles) / cyclesPerNanosecond);
+}
+
+} // namespace Memarena
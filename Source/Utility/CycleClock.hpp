@@ -0,0 +1,51 @@
+#pragma once
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #define MEMARENA_HAS_CYCLE_COUNTER
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define MEMARENA_HAS_CYCLE_COUNTER
+#elif defined(__aarch64__)
+    #define MEMARENA_HAS_CYCLE_COUNTER
+#elif defined(_WIN32)
+    #include <chrono>
+#else
+    #include <time.h>
+#endif
+
+#include "Source/Aliases.hpp"
+
+namespace Memarena
+{
+
+/**
+ * @brief Reads a monotonic tick counter that is cheap enough to call around every allocation. This is the time stamp
+ * counter on x86 and the virtual counter on ARM64. Other platforms fall back to a monotonic clock in nanoseconds.
+ */
+inline UInt64 ReadCycleCounter() noexcept
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    UInt64 value = 0;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#elif defined(_WIN32)
+    return static_cast<UInt64>(std::chrono::steady_clock::now().time_since_epoch().count());
+#else
+    timespec time{};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<UInt64>(time.tv_sec) * 1000000000 + static_cast<UInt64>(time.tv_nsec);
+#endif
+}
+
+/**
+ * @brief Converts a difference of ReadCycleCounter values to nanoseconds. The counter frequency is measured against the
+ * steady clock on the first call, which takes a few milliseconds.
+ */
+UInt64 CyclesToNanoseconds(UInt64 cycles);
+
+} // namespace Memarena
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <algorithm>
+#include <string_view>
+
+#include "Source/Aliases.hpp"
+
+namespace Memarena
+{
+
+/**
+ * @brief A string literal that can be used as a template argument, e.g. `Category<"Rendering">`.
+ *
+ * @tparam N The size of the literal, including the null terminator
+ */
+template <Size N>
+struct FixedString
+{
+    constexpr FixedString(const char (&string)[N]) { std::copy_n(string, N, value); } // NOLINT
+
+    [[nodiscard]] constexpr std::string_view View() const { return {value, N - 1}; }
+
+    char value[N]{};
+};
+
+} // namespace Memarena
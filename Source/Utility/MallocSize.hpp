@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdlib>
+
+#if defined(__linux__)
+    #include <malloc.h>
+    #define MEMARENA_MALLOC_SIZE_AVAILABLE
+#elif defined(__APPLE__)
+    #include <malloc/malloc.h>
+    #define MEMARENA_MALLOC_SIZE_AVAILABLE
+#elif defined(_WIN32)
+    #include <malloc.h>
+    #define MEMARENA_MALLOC_SIZE_AVAILABLE
+#endif
+
+#include "Source/Aliases.hpp"
+
+namespace Memarena
+{
+
+#ifdef MEMARENA_MALLOC_SIZE_AVAILABLE
+constexpr bool MallocSizeIsAvailable = true;
+#else
+constexpr bool MallocSizeIsAvailable = false;
+#endif
+
+/**
+ * @brief Returns the number of usable bytes in a block returned by malloc. This can be larger than the size that was
+ * requested, since malloc rounds allocations up to its own size classes.
+ *
+ * @param ptr A pointer returned by malloc, or nullptr
+ */
+inline Size GetMallocSize(void* ptr)
+{
+#if defined(__linux__)
+    return malloc_usable_size(ptr);
+#elif defined(__APPLE__)
+    return malloc_size(ptr);
+#elif defined(_WIN32)
+    return ptr == nullptr ? 0 : _msize(ptr);
+#else
+    return 0;
+#endif
+}
+
+} // namespace Memarena
@@ -0,0 +1,44 @@
+#include "PCH.hpp"
+
+#include "StackTrace.hpp"
+
+#if defined(_WIN32)
+    #include <windows.h>
+#elif __has_include(<execinfo.h>)
+    #include <execinfo.h>
+    #define MEMARENA_HAS_EXECINFO
+#endif
+
+namespace Memarena
+{
+
+Size StackTraceHash::operator()(const StackTrace& stackTrace) const noexcept
+{
+    UInt64 hash = stackTrace.depth;
+    for (UInt32 i = 0; i < stackTrace.depth; i++)
+    {
+        hash = (hash ^ std::bit_cast<UIntPtr>(stackTrace.frames[i])) * 0x100000001B3ULL;
+    }
+    return static_cast<Size>(hash);
+}
+
+StackTrace CaptureStackTrace([[maybe_unused]] const Size skipFrames)
+{
+    StackTrace stackTrace;
+
+#if defined(_WIN32)
+    stackTrace.depth = CaptureStackBackTrace(static_cast<DWORD>(skipFrames + 1), maxStackTraceDepth, stackTrace.frames.data(), nullptr);
+#elif defined(MEMARENA_HAS_EXECINFO)
+    // One more slot for this function, which is then dropped along with the skipped frames
+    std::array<void*, maxStackTraceDepth + 1> frames{};
+    const int depth = backtrace(frames.data(), static_cast<int>(frames.size()));
+
+    const Size skipped = std::min<Size>(skipFrames + 1, static_cast<Size>(std::max(depth, 0)));
+    stackTrace.depth   = static_cast<UInt32>(std::min<Size>(depth - skipped, maxStackTraceDepth));
+    std::copy_n(frames.begin() + skipped, stackTrace.depth, stackTrace.frames.begin());
+#endif
+
+    return stackTrace;
+}
+
+} // namespace Memarena
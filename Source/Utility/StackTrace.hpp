@@ -0,0 +1,37 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+#include "Source/Aliases.hpp"
+
+namespace Memarena
+{
+
+constexpr Size maxStackTraceDepth = 32;
+
+// The return addresses of a call stack, innermost frame first
+struct StackTrace
+{
+    std::array<void*, maxStackTraceDepth> frames{};
+    UInt32                                depth = 0;
+
+    friend bool operator==(const StackTrace& a, const StackTrace& b)
+    {
+        return a.depth == b.depth && std::equal(a.frames.begin(), a.frames.begin() + a.depth, b.frames.begin());
+    }
+};
+
+struct StackTraceHash
+{
+    Size operator()(const StackTrace& stackTrace) const noexcept;
+};
+
+/**
+ * @brief Walks the stack of the calling thread with `backtrace` on POSIX and `CaptureStackBackTrace` on Windows. The
+ * innermost `skipFrames` frames are left out, not counting this function itself. Returns an empty trace on platforms
+ * without either.
+ */
+StackTrace CaptureStackTrace(Size skipFrames);
+
+} // namespace Memarena
@@ -1,16 +1,206 @@
+#include "PCH.hpp"
 
-// #include <bit>
-// #include <memoryapi.h>
-// #include <minwindef.h>
+#if defined(_WIN32)
+    #include <memoryapi.h>
+    #include <sysinfoapi.h>
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
 
-// #include "VirtualMemory.hpp"
+#include "VirtualMemory.hpp"
 
-// namespace Memarena
-// {
-// // TODO: Write asserts
+namespace Memarena
+{
 
-// NO_DISCARD void* ReserveVirtualMemory(Size size) { return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS); }
-// void CommitVirtualMemory(UIntPtr address, Size size) { VirtualAlloc(std::bit_cast<void*>(address), size, MEM_COMMIT, PAGE_READWRITE); }
-// void FreeVirtualMemory(UIntPtr address, Size size) { VirtualFree(std::bit_cast<void*>(address), size, MEM_RELEASE); }
+#if defined(_WIN32)
 
-// } // namespace Memarena
+NO_DISCARD void* ReserveVirtualMemory(Size size) { return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS); }
+void CommitVirtualMemory(UIntPtr address, Size size) { VirtualAlloc(std::bit_cast<void*>(address), size, MEM_COMMIT, PAGE_READWRITE); }
+void FreeVirtualMemory(UIntPtr address, Size /*size*/) { VirtualFree(std::bit_cast<void*>(address), 0, MEM_RELEASE); }
+
+NO_DISCARD void* MapMemory(Size size, bool /*populate*/, bool /*hugePages*/)
+{
+    return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+void             UnmapMemory(void* ptr, Size /*size*/) { VirtualFree(ptr, 0, MEM_RELEASE); }
+
+NO_DISCARD void* MapAlignedMemory(Size size, Size alignment, bool populate, bool hugePages)
+{
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    if (alignment <= systemInfo.dwAllocationGranularity)
+    {
+        return MapMemory(size, populate, hugePages);
+    }
+
+    // A reservation cannot be partially released, so find an aligned address inside an oversized reservation, release it
+    // and map at that address. Another thread can take the range in between, in which case we try again
+    constexpr int maxAttempts = 8;
+    for (int attempt = 0; attempt < maxAttempts; attempt++)
+    {
+        void* reservedPtr = VirtualAlloc(nullptr, size + alignment, MEM_RESERVE, PAGE_NOACCESS);
+        if (reservedPtr == nullptr)
+        {
+            return nullptr;
+        }
+
+        const UIntPtr alignedAddress = (std::bit_cast<UIntPtr>(reservedPtr) + alignment - 1) & ~(alignment - 1);
+        VirtualFree(reservedPtr, 0, MEM_RELEASE);
+
+        void* ptr = VirtualAlloc(std::bit_cast<void*>(alignedAddress), size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (ptr != nullptr)
+        {
+            return ptr;
+        }
+    }
+
+    return nullptr;
+}
+
+NO_DISCARD void* RemapMemory(void* /*ptr*/, Size /*oldSize*/, Size /*newSize*/) { return nullptr; }
+void             AdviseHugePages(void* /*ptr*/, Size /*size*/) {}
+
+Size GetPageSize()
+{
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return systemInfo.dwPageSize;
+}
+
+#else
+
+namespace
+{
+void PopulateMemory(void* ptr, Size size)
+{
+    #ifdef MADV_POPULATE_WRITE
+    if (madvise(ptr, size, MADV_POPULATE_WRITE) == 0)
+    {
+        return;
+    }
+    #endif
+
+    // Fall back to touching every page
+    volatile Byte* bytes    = static_cast<Byte*>(ptr);
+    const Size     pageSize = GetPageSize();
+    for (Size offset = 0; offset < size; offset += pageSize)
+    {
+        bytes[offset] = 0;
+    }
+}
+} // namespace
+
+NO_DISCARD void* ReserveVirtualMemory(Size size)
+{
+    void* ptr = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+}
+void CommitVirtualMemory(UIntPtr address, Size size) { mprotect(std::bit_cast<void*>(address), size, PROT_READ | PROT_WRITE); }
+void FreeVirtualMemory(UIntPtr address, Size size) { munmap(std::bit_cast<void*>(address), size); }
+
+NO_DISCARD void* MapMemory(Size size, bool populate, bool hugePages)
+{
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    #ifdef MAP_POPULATE
+    // Populating before the huge page hint would fault in small pages, so in that case we populate after advising
+    if (populate && !hugePages)
+    {
+        flags |= MAP_POPULATE;
+    }
+    #endif
+
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (ptr == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    if (hugePages)
+    {
+        AdviseHugePages(ptr, size);
+
+        if (populate)
+        {
+            PopulateMemory(ptr, size);
+        }
+    }
+
+    return ptr;
+}
+
+void UnmapMemory(void* ptr, Size size) { munmap(ptr, size); }
+
+NO_DISCARD void* MapAlignedMemory(Size size, Size alignment, bool populate, bool hugePages)
+{
+    if (alignment <= GetPageSize())
+    {
+        return MapMemory(size, populate, hugePages);
+    }
+
+    // Map enough to contain an aligned range of the requested size, then unmap the misaligned head and the unused tail.
+    // Populating is deferred until after trimming, so that the excess is never faulted in
+    void* mappedPtr = MapMemory(size + alignment);
+    RETURN_VAL_IF_NULLPTR(mappedPtr, nullptr);
+
+    const UIntPtr mappedAddress  = std::bit_cast<UIntPtr>(mappedPtr);
+    const UIntPtr alignedAddress = (mappedAddress + alignment - 1) & ~(alignment - 1);
+    const Size    headSize       = alignedAddress - mappedAddress;
+    const Size    tailSize       = alignment - headSize;
+
+    if (headSize > 0)
+    {
+        munmap(mappedPtr, headSize);
+    }
+    if (tailSize > 0)
+    {
+        munmap(std::bit_cast<void*>(alignedAddress + size), tailSize);
+    }
+
+    void* ptr = std::bit_cast<void*>(alignedAddress);
+
+    if (hugePages)
+    {
+        AdviseHugePages(ptr, size);
+    }
+    if (populate)
+    {
+        PopulateMemory(ptr, size);
+    }
+
+    return ptr;
+}
+
+NO_DISCARD void* RemapMemory(void* ptr, Size oldSize, Size newSize)
+{
+    #if defined(__linux__)
+    void* newPtr = mremap(ptr, oldSize, newSize, MREMAP_MAYMOVE);
+    return newPtr == MAP_FAILED ? nullptr : newPtr;
+    #else
+    return nullptr;
+    #endif
+}
+
+void AdviseHugePages(void* ptr, Size size)
+{
+    #ifdef MADV_HUGEPAGE
+    madvise(ptr, size, MADV_HUGEPAGE);
+    #endif
+}
+
+Size GetPageSize()
+{
+    static const Size pageSize = static_cast<Size>(sysconf(_SC_PAGESIZE));
+    return pageSize;
+}
+
+#endif
+
+Size RoundUpToPageSize(Size size)
+{
+    const Size pageSize = GetPageSize();
+    return (size + pageSize - 1) & ~(pageSize - 1);
+}
+
+} // namespace Memarena
@@ -1,12 +1,46 @@
+#pragma once
 
-// #pragma once
+#include "Source/Aliases.hpp"
+#include "Source/Macros.hpp"
 
-// #include "Source/Aliases.hpp"
-// #include "Source/Macros.hpp"
+namespace Memarena
+{
 
-// namespace Memarena
-// {
-// NO_DISCARD void* ReserveVirtualMemory(Size size);
-// void             CommitVirtualMemory(UIntPtr address, Size size);
-// void             FreeVirtualMemory(UIntPtr address, Size size);
-// } // namespace Memarena
\ No newline at end of file
+NO_DISCARD void* ReserveVirtualMemory(Size size);
+void             CommitVirtualMemory(UIntPtr address, Size size);
+void             FreeVirtualMemory(UIntPtr address, Size size);
+
+/**
+ * @brief Maps readable and writable memory directly from the OS, bypassing malloc.
+ *
+ * @param size The size of the mapping. Should be a multiple of the page size
+ * @param populate Pre-fault the pages of the mapping, so that the first touch does not page fault
+ * @param hugePages Hint the kernel to back the mapping with transparent huge pages
+ * @return A page aligned pointer, or nullptr if the mapping failed
+ */
+NO_DISCARD void* MapMemory(Size size, bool populate = false, bool hugePages = false);
+void             UnmapMemory(void* ptr, Size size);
+
+/**
+ * @brief Same as MapMemory, but the mapping starts at a multiple of `alignment`. Alignments above the page size are
+ * handled by over-mapping and trimming the excess, so the result can still be released with UnmapMemory(ptr, size).
+ *
+ * @param alignment A power of 2
+ */
+NO_DISCARD void* MapAlignedMemory(Size size, Size alignment, bool populate = false, bool hugePages = false);
+
+/**
+ * @brief Grows or shrinks a mapping returned by MapMemory. The pages are moved by the kernel, so no data is copied.
+ *
+ * @return The new address of the mapping, or nullptr if remapping failed or is not supported. The old mapping is still
+ * valid in that case.
+ */
+NO_DISCARD void* RemapMemory(void* ptr, Size oldSize, Size newSize);
+
+// Hint the kernel to back a mapping with transparent huge pages. Does nothing where unsupported
+void AdviseHugePages(void* ptr, Size size);
+
+Size GetPageSize();
+Size RoundUpToPageSize(Size size);
+
+} // namespace Memarena
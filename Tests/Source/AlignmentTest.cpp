@@ -6,6 +6,7 @@
 #include "MemoryTestObjects.hpp"
 
 using namespace Memarena;
+using namespace Memarena::SizeLiterals;
 
 TEST(AlignmentTest, CalculateAlignedAddress)
 {
@@ -29,4 +30,46 @@ TEST(AlignmentTest, IsAlignmentValid)
     EXPECT_EQ(IsAlignmentValid(3), false);
     EXPECT_EQ(IsAlignmentValid(4), true);
     EXPECT_EQ(IsAlignmentValid(-1), false);
-}
\ No newline at end of file
+}
+TEST(AlignmentTest, ExtendPaddingForHeader)
+{
+    EXPECT_EQ(ExtendPaddingForHeader(0, 8, 8), 8);
+    EXPECT_EQ(ExtendPaddingForHeader(3, 8, 8), 11);
+    EXPECT_EQ(ExtendPaddingForHeader(8, 8, 8), 8);
+    EXPECT_EQ(ExtendPaddingForHeader(12, 4, 8), 12);
+    EXPECT_EQ(ExtendPaddingForHeader(2, 4, 9), 10);
+    EXPECT_EQ(ExtendPaddingForHeader(0, 16, 0), 0);
+}
+
+TEST(AlignmentTest, CalculateAlignedPaddingWithHeader)
+{
+    EXPECT_EQ(CalculateAlignedPaddingWithHeader(40, 4, 0), 0);
+    EXPECT_EQ(CalculateAlignedPaddingWithHeader(41, 4, 0), 3);
+    EXPECT_EQ(CalculateAlignedPaddingWithHeader(41, 4, 3), 3);
+    EXPECT_EQ(CalculateAlignedPaddingWithHeader(41, 4, 4), 7);
+    EXPECT_EQ(CalculateAlignedPaddingWithHeader(40, 8, 16), 16);
+    EXPECT_EQ(CalculateAlignedPaddingWithHeader(45, 16, 8), 19);
+}
+
+TEST(AlignmentTest, StaticAlignment)
+{
+    static_assert(CalculateAlignedAddress(41, StaticAlignment<4>{}) == 44);
+    static_assert(CalculateShortestAlignedPadding(45, StaticAlignment<16>{}) == 3);
+    static_assert(CalculateAlignedPaddingWithHeader(41, StaticAlignment<4>{}, 4) == 7);
+    static_assert(ExtendPaddingForHeader(2, StaticAlignment<4>{}, 9) == 10);
+
+    for (UIntPtr address = 0; address < 64; address++)
+    {
+        EXPECT_EQ(CalculateAlignedAddress(address, StaticAlignment<8>{}), CalculateAlignedAddress(address, 8));
+        EXPECT_EQ(CalculateAlignedPaddingWithHeader(address, StaticAlignment<8>{}, 12), CalculateAlignedPaddingWithHeader(address, 8, 12));
+    }
+}
+
+TEST(AlignmentTest, LargeAlignment)
+{
+    EXPECT_EQ(CalculateAlignedAddress(4097, 4_KiB), 8_KiB);
+    EXPECT_EQ(CalculateAlignedAddress(1, 2_MiB), 2_MiB);
+    EXPECT_EQ(CalculateShortestAlignedPadding(1, 4_KiB), 4_KiB - 1);
+    EXPECT_EQ(CalculateAlignedPaddingWithHeader(4_KiB - 4, 4_KiB, 8), 4_KiB + 4);
+    EXPECT_EQ(ExtendPaddingForHeader(0, 2_MiB, 16), 2_MiB);
+}
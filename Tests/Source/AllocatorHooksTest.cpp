@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <Memarena/Memarena.hpp>
+
+using namespace Memarena;
+using namespace Memarena::SizeLiterals;
+
+namespace
+{
+struct CountingHooks
+{
+    static inline Size allocationCount   = 0;
+    static inline Size allocatedSize     = 0;
+    static inline Size deallocationCount = 0;
+    static inline Size deallocatedSize   = 0;
+    static inline Size blockCount        = 0; // Blocks acquired and not yet released
+    static inline Size blockSize         = 0;
+
+    static void Reset() { allocationCount = allocatedSize = deallocationCount = deallocatedSize = blockCount = blockSize = 0; }
+
+    static void OnAllocate(void* /*ptr*/, const Size size, const Size /*alignment*/)
+    {
+        allocationCount++;
+        allocatedSize += size;
+    }
+    static void OnDeallocate(void* /*ptr*/, const Size size)
+    {
+        deallocationCount++;
+        deallocatedSize += size;
+    }
+    static void OnBlockAcquire(void* /*blockPtr*/, const Size size)
+    {
+        blockCount++;
+        blockSize += size;
+    }
+    static void OnBlockRelease(void* /*blockPtr*/, const Size size)
+    {
+        blockCount--;
+        blockSize -= size;
+    }
+};
+
+struct BlockHooks
+{
+    static void OnBlockAcquire(void* /*blockPtr*/, Size /*size*/) {}
+};
+} // namespace
+
+class AllocatorHooksTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override { MemoryTracker::Reset(); }
+    void TearDown() override {}
+};
+
+TEST_F(AllocatorHooksTest, Callbacks)
+{
+    static_assert(StackAllocatorSettings{}.hooks->onAllocate == nullptr);
+    static_assert(MakeHooks<BlockHooks>()->onBlockAcquire != nullptr && MakeHooks<BlockHooks>()->onAllocate == nullptr);
+
+    constexpr const AllocatorHooks*   hooks          = MakeHooks<CountingHooks>();
+    constexpr StackAllocatorSettings  stackSettings  = {.policy = StackAllocatorPolicy::Release, .hooks = hooks};
+    constexpr PoolAllocatorSettings   poolSettings   = {.policy = PoolAllocatorPolicy::Growable, .hooks = hooks};
+    constexpr LinearAllocatorSettings linearSettings = {.policy = LinearAllocatorPolicy::Growable, .hooks = hooks};
+    constexpr MallocatorSettings      mallocSettings = {.policy = MallocatorPolicy::Release, .hooks = hooks};
+
+    CountingHooks::Reset();
+    {
+        StackAllocator<stackSettings> stackAllocator{1_KiB};
+        EXPECT_EQ(CountingHooks::blockSize, 1_KiB);
+
+        int* num = stackAllocator.NewRaw<int>(1);
+        stackAllocator.Delete(num);
+        EXPECT_EQ(CountingHooks::allocationCount, 1);
+        EXPECT_EQ(CountingHooks::allocatedSize, sizeof(int));
+        EXPECT_EQ(CountingHooks::deallocatedSize, sizeof(int));
+    }
+    EXPECT_EQ(CountingHooks::blockCount, 0);
+
+    CountingHooks::Reset();
+    {
+        PoolAllocator<poolSettings> poolAllocator{16, 2};
+        std::vector<void*>          ptrs;
+        for (int i = 0; i < 3; i++)
+        {
+            ptrs.push_back(poolAllocator.Allocate());
+        }
+        EXPECT_EQ(CountingHooks::blockCount, 2);
+        EXPECT_EQ(CountingHooks::allocatedSize, 48);
+
+        for (void* ptr : ptrs)
+        {
+            poolAllocator.Deallocate(ptr);
+        }
+        EXPECT_EQ(CountingHooks::deallocationCount, 3);
+        EXPECT_EQ(CountingHooks::deallocatedSize, 48);
+    }
+    EXPECT_EQ(CountingHooks::blockCount, 0);
+
+    CountingHooks::Reset();
+    {
+        LinearAllocator<linearSettings> linearAllocator{64};
+        for (int i = 0; i < 3; i++)
+        {
+            EXPECT_NE(linearAllocator.Allocate(48), nullptr);
+        }
+        EXPECT_EQ(CountingHooks::blockCount, 3);
+        EXPECT_EQ(CountingHooks::allocatedSize, 144);
+
+        // Releasing keeps the first block
+        linearAllocator.Release();
+        EXPECT_EQ(CountingHooks::blockCount, 1);
+        EXPECT_EQ(CountingHooks::blockSize, 64);
+    }
+    EXPECT_EQ(CountingHooks::blockCount, 0);
+
+    CountingHooks::Reset();
+    {
+        Mallocator<mallocSettings> mallocator;
+        void*                      ptr = mallocator.Allocate(32);
+        ptr                            = mallocator.Reallocate(ptr, 64);
+        mallocator.Deallocate(ptr);
+        EXPECT_EQ(CountingHooks::allocationCount, 2);
+        EXPECT_EQ(CountingHooks::allocatedSize, 96);
+        EXPECT_EQ(CountingHooks::deallocationCount, 2);
+        EXPECT_EQ(CountingHooks::deallocatedSize, 96);
+        EXPECT_EQ(CountingHooks::blockCount, 0);
+    }
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <Memarena/Memarena.hpp>
+
+using namespace Memarena;
+using namespace Memarena::SizeLiterals;
+
+class DynamicTrackingTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override { MemoryTracker::Reset(); }
+    void TearDown() override {}
+};
+
+TEST_F(DynamicTrackingTest, Switch)
+{
+    constexpr PoolAllocatorSettings settings = {
+        .policy = PoolAllocatorPolicy::AllocationTracking | PoolAllocatorPolicy::SizeTracking | PoolAllocatorPolicy::DynamicTracking};
+
+    constexpr Size          objectSize = 16;
+    PoolAllocator<settings> poolAllocator{objectSize, 4};
+    void*                   first = poolAllocator.Allocate();
+    EXPECT_TRUE(poolAllocator.IsTrackingEnabled());
+    EXPECT_EQ(poolAllocator.GetAllocationCount(), 1);
+    EXPECT_EQ(poolAllocator.GetUsedSize(), objectSize);
+
+    poolAllocator.SetTrackingEnabled(false);
+    void* second = poolAllocator.Allocate();
+    poolAllocator.Deallocate(second);
+    EXPECT_EQ(poolAllocator.GetAllocationCount(), 1);
+    EXPECT_EQ(poolAllocator.GetDeallocationCount(), 0);
+    EXPECT_EQ(poolAllocator.GetUsedSize(), objectSize);
+
+    // The global switch reaches the allocators that exist, and the ones created after it
+    poolAllocator.SetTrackingEnabled(true);
+    MemoryTracker::SetTrackingEnabled(false);
+    EXPECT_FALSE(poolAllocator.IsTrackingEnabled());
+
+    PoolAllocator<settings> otherAllocator{objectSize, 4};
+    void*                   other = otherAllocator.Allocate();
+    EXPECT_FALSE(otherAllocator.IsTrackingEnabled());
+    EXPECT_EQ(otherAllocator.GetAllocationCount(), 0);
+
+    MemoryTracker::SetTrackingEnabled(true);
+    poolAllocator.Deallocate(first);
+    EXPECT_EQ(poolAllocator.GetDeallocationCount(), 1);
+    EXPECT_EQ(poolAllocator.GetUsedSize(), 0);
+    otherAllocator.Deallocate(other);
+    EXPECT_EQ(otherAllocator.GetDeallocationCount(), 1);
+}
+
+TEST_F(DynamicTrackingTest, UsedSizeAfterSwitchingOn)
+{
+    constexpr PoolAllocatorSettings poolSettings = {.policy = PoolAllocatorPolicy::SizeTracking | PoolAllocatorPolicy::DynamicTracking};
+
+    // Freeing an object that was allocated while tracking was off recounts the used size instead of going below zero
+    constexpr Size              objectSize = 16;
+    PoolAllocator<poolSettings> poolAllocator{objectSize, 4};
+    poolAllocator.SetTrackingEnabled(false);
+    void* first  = poolAllocator.Allocate();
+    void* second = poolAllocator.Allocate();
+    EXPECT_EQ(poolAllocator.GetUsedSize(), 0);
+
+    poolAllocator.SetTrackingEnabled(true);
+    poolAllocator.Deallocate(first);
+    EXPECT_EQ(poolAllocator.GetUsedSize(), objectSize);
+    void* third = poolAllocator.Allocate();
+    EXPECT_EQ(poolAllocator.GetUsedSize(), objectSize * 2);
+    poolAllocator.Deallocate(second);
+    poolAllocator.Deallocate(third);
+    EXPECT_EQ(poolAllocator.GetUsedSize(), 0);
+
+    // Growing and releasing leave the used size alone while tracking is off
+    constexpr LinearAllocatorSettings linearSettings = {
+        .policy = LinearAllocatorPolicy::SizeTracking | LinearAllocatorPolicy::Growable | LinearAllocatorPolicy::DynamicTracking};
+
+    LinearAllocator<linearSettings> linearAllocator{256};
+    EXPECT_NE(linearAllocator.Allocate(128), nullptr);
+    linearAllocator.SetTrackingEnabled(false);
+    EXPECT_NE(linearAllocator.Allocate(192), nullptr);
+    EXPECT_EQ(linearAllocator.GetUsedSize(), 128);
+    linearAllocator.Release();
+    EXPECT_EQ(linearAllocator.GetUsedSize(), 128);
+    EXPECT_NE(linearAllocator.Allocate(64), nullptr);
+
+    linearAllocator.SetTrackingEnabled(true);
+    EXPECT_NE(linearAllocator.Allocate(32), nullptr);
+    EXPECT_EQ(linearAllocator.GetUsedSize(), 64 + 32);
+
+    // A stack matches one that was tracked all along
+    constexpr StackAllocatorSettings stackSettings = {.policy = StackAllocatorPolicy::Default | StackAllocatorPolicy::DynamicTracking};
+
+    StackAllocator<stackSettings> stackAllocator{1_KB};
+    StackAllocator<stackSettings> trackedStackAllocator{1_KB};
+    stackAllocator.SetTrackingEnabled(false);
+    int* stackFirst        = stackAllocator.NewRaw<int>(1);
+    int* trackedStackFirst = trackedStackAllocator.NewRaw<int>(1);
+
+    stackAllocator.SetTrackingEnabled(true);
+    int* stackSecond        = stackAllocator.NewRaw<int>(2);
+    int* trackedStackSecond = trackedStackAllocator.NewRaw<int>(2);
+    EXPECT_EQ(stackAllocator.GetUsedSize(), trackedStackAllocator.GetUsedSize());
+    stackAllocator.Delete(stackSecond);
+    trackedStackAllocator.Delete(trackedStackSecond);
+    stackAllocator.Delete(stackFirst);
+    trackedStackAllocator.Delete(trackedStackFirst);
+    EXPECT_EQ(stackAllocator.GetUsedSize(), 0);
+}
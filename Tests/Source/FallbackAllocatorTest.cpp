@@ -111,6 +111,21 @@ TEST_F(FallbackAllocatorTest, StackPool)
                          std::make_shared<PoolAllocator<>>(sizeof(UInt64), 1));
 }
 
+TEST_F(FallbackAllocatorTest, AllocateSpill)
+{
+    constexpr StackAllocatorSettings settings = {.breakOnFailureIsEnabled = false, .failureLoggingIsEnabled = false};
+
+    auto stackAllocator = std::make_shared<StackAllocator<settings>>(alignof(UInt64) + sizeof(UInt64) + stackAllocatorPadding);
+    FallbackAllocator fallbackAllocator{stackAllocator, std::make_shared<Mallocator<>>()};
+
+    void* ptr  = fallbackAllocator.Allocate(sizeof(UInt64), alignof(UInt64));
+    void* ptr2 = fallbackAllocator.Allocate(sizeof(UInt64), alignof(UInt64));
+    EXPECT_TRUE(stackAllocator->Owns(ptr));
+    EXPECT_FALSE(stackAllocator->Owns(ptr2));
+    fallbackAllocator.Deallocate(ptr2);
+    fallbackAllocator.Deallocate(ptr);
+}
+
 // TEST_F(FallbackAllocatorTest, PoolStack)
 // {
 //     auto                                              stackAllocator = std::make_shared<StackAllocator<>>(1_KB);
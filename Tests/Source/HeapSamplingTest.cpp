@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <Memarena/Memarena.hpp>
+
+using namespace Memarena;
+using namespace Memarena::SizeLiterals;
+
+namespace
+{
+std::string ReadFile(const std::filesystem::path& path)
+{
+    std::ifstream     file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+} // namespace
+
+class HeapSamplingTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override { MemoryTracker::Reset(); }
+    void TearDown() override { HeapSampler::SetSampleInterval(HeapSampler::defaultSampleInterval); }
+};
+
+TEST_F(HeapSamplingTest, HeapSampling)
+{
+    constexpr PoolAllocatorSettings settings = {.policy = PoolAllocatorPolicy::Debug | PoolAllocatorPolicy::HeapSampling};
+    PoolAllocator<settings>         poolAllocator{64, 2000};
+
+    // About one sample per 1 KiB, so the 125 KiB below should be sampled around 125 times
+    HeapSampler::SetSampleInterval(1024);
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 2000; i++)
+    {
+        ptrs.push_back(poolAllocator.Allocate());
+    }
+
+    std::vector<HeapProfileEntry> profile = poolAllocator.GetHeapProfile();
+    ASSERT_FALSE(profile.empty());
+    EXPECT_GT(profile[0].stackTrace.depth, 0);
+
+    Size liveCount = 0;
+    for (const HeapProfileEntry& entry : profile)
+    {
+        liveCount += entry.liveCount;
+        EXPECT_EQ(entry.liveSize, entry.liveCount * 64);
+    }
+    EXPECT_GT(liveCount, 50);
+    EXPECT_LT(liveCount, 250);
+
+    const std::filesystem::path profilePath = std::filesystem::temp_directory_path() / "MemarenaHeapProfile.heap";
+    ASSERT_TRUE(MemoryTracker::WriteHeapProfile(profilePath.string()));
+    const std::string heapProfile = ReadFile(profilePath);
+    EXPECT_EQ(heapProfile.rfind("heap profile: ", 0), 0);
+    EXPECT_NE(heapProfile.find("@ heap_v2/1024\n"), std::string::npos);
+    EXPECT_NE(heapProfile.find("MAPPED_LIBRARIES:"), std::string::npos);
+    std::filesystem::remove(profilePath);
+
+    HeapSampler::SetSampleInterval(0);
+    for (void* ptr : ptrs)
+    {
+        poolAllocator.Deallocate(ptr);
+    }
+    void* unsampledPtr = poolAllocator.Allocate();
+
+    // The freed samples still count towards the allocated totals
+    Size allocatedCount = 0;
+    for (const HeapProfileEntry& entry : poolAllocator.GetHeapProfile())
+    {
+        EXPECT_EQ(entry.liveCount, 0);
+        allocatedCount += entry.allocatedCount;
+    }
+    EXPECT_EQ(allocatedCount, liveCount);
+
+    poolAllocator.Deallocate(unsampledPtr);
+}
+
+TEST_F(HeapSamplingTest, ZeroIntervalDisablesSampling)
+{
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Release | MallocatorPolicy::HeapSampling};
+    Mallocator<settings>         mallocator;
+
+    HeapSampler::SetSampleInterval(0);
+    EXPECT_EQ(HeapSampler::GetSampleInterval(), 0);
+
+    // Far more bytes than the check for a new interval waits for
+    for (int i = 0; i < 1000; i++)
+    {
+        void* ptr = mallocator.Allocate(4_KiB);
+        mallocator.Deallocate(ptr);
+    }
+    EXPECT_TRUE(mallocator.GetHeapProfile().empty());
+
+    // The calling thread picks up a new interval right away
+    HeapSampler::SetSampleInterval(1);
+    void* ptr = mallocator.Allocate(64);
+    ASSERT_EQ(mallocator.GetHeapProfile().size(), 1);
+    EXPECT_EQ(mallocator.GetHeapProfile()[0].liveCount, 1);
+    mallocator.Deallocate(ptr);
+}
+
+TEST_F(HeapSamplingTest, Reallocate)
+{
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Release | MallocatorPolicy::HeapSampling};
+    Mallocator<settings>         mallocator;
+
+    // Samples every allocation
+    HeapSampler::SetSampleInterval(1);
+    void* ptr = mallocator.Allocate(64);
+    ptr       = mallocator.Reallocate(ptr, 4_KiB);
+
+    // The old sample counts as freed, and the new block is sampled as a new allocation
+    Size liveCount      = 0;
+    Size liveSize       = 0;
+    Size allocatedCount = 0;
+    Size allocatedSize  = 0;
+    for (const HeapProfileEntry& entry : mallocator.GetHeapProfile())
+    {
+        liveCount += entry.liveCount;
+        liveSize += entry.liveSize;
+        allocatedCount += entry.allocatedCount;
+        allocatedSize += entry.allocatedSize;
+    }
+    EXPECT_EQ(liveCount, 1);
+    EXPECT_EQ(liveSize, 4_KiB);
+    EXPECT_EQ(allocatedCount, 2);
+    EXPECT_EQ(allocatedSize, 64 + 4_KiB);
+
+    mallocator.Deallocate(ptr);
+    for (const HeapProfileEntry& entry : mallocator.GetHeapProfile())
+    {
+        EXPECT_EQ(entry.liveCount, 0);
+    }
+}
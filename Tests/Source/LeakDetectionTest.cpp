@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <Memarena/Memarena.hpp>
+
+using namespace Memarena;
+using namespace Memarena::SizeLiterals;
+
+class LeakDetectionTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override { MemoryTracker::Reset(); }
+    void TearDown() override {}
+};
+
+TEST_F(LeakDetectionTest, LeakReport)
+{
+    constexpr PoolAllocatorSettings settings = {.policy = PoolAllocatorPolicy::Debug | PoolAllocatorPolicy::LeakDetection};
+    PoolAllocator<settings>         poolAllocator{sizeof(UInt64), 100};
+
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 3; i++)
+    {
+        ptrs.push_back(poolAllocator.Allocate(Category<"Testing/Leaks">{}));
+    }
+    void* otherPtr = poolAllocator.Allocate();
+    poolAllocator.Deallocate(ptrs[0]);
+
+    const std::vector<LeakReportEntry> report = poolAllocator.GetLeakReport();
+    ASSERT_EQ(report.size(), 2);
+    EXPECT_EQ(report[0].allocationCount, 2);
+    EXPECT_EQ(report[0].size, 2 * sizeof(UInt64));
+    EXPECT_EQ(CategoryRegistry::GetName(report[0].category), "Testing/Leaks");
+    EXPECT_EQ(report[1].allocationCount, 1);
+    EXPECT_NE(CallSiteRegistry::Get(report[0].callSite).line, CallSiteRegistry::Get(report[1].callSite).line);
+
+    EXPECT_EQ(MemoryTracker::GetLeakReport().size(), 2);
+
+    poolAllocator.Deallocate(ptrs[1]);
+    poolAllocator.Deallocate(ptrs[2]);
+    poolAllocator.Deallocate(otherPtr);
+    EXPECT_TRUE(poolAllocator.GetLeakReport().empty());
+}
+
+TEST_F(LeakDetectionTest, LeakReportManyAllocations)
+{
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Release | MallocatorPolicy::LeakDetection};
+    Mallocator<settings>         mallocator;
+
+    // Enough allocations to grow the table a few times, and to shift entries back on removal
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 5000; i++)
+    {
+        ptrs.push_back(mallocator.Allocate(16));
+    }
+    for (Size i = 0; i < ptrs.size(); i += 2)
+    {
+        mallocator.Deallocate(ptrs[i]);
+    }
+
+    ptrs[1] = mallocator.Reallocate(ptrs[1], 1000);
+
+    std::vector<LeakReportEntry> report = mallocator.GetLeakReport();
+    ASSERT_EQ(report.size(), 2);
+    EXPECT_EQ(report[0].allocationCount, 2499);
+    EXPECT_EQ(report[0].size, 2499 * 16);
+    EXPECT_EQ(report[1].allocationCount, 1);
+    EXPECT_EQ(report[1].size, 1000);
+
+    for (Size i = 1; i < ptrs.size(); i += 2)
+    {
+        mallocator.Deallocate(ptrs[i]);
+    }
+    EXPECT_TRUE(mallocator.GetLeakReport().empty());
+}
+
+TEST_F(LeakDetectionTest, Reallocate)
+{
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Release | MallocatorPolicy::LeakDetection};
+    Mallocator<settings>         mallocator;
+
+    void* ptr = mallocator.Allocate(16, defaultAlignment, Category<"Testing/Leaks">{});
+    const std::vector<LeakReportEntry> allocationReport = mallocator.GetLeakReport();
+    ASSERT_EQ(allocationReport.size(), 1);
+
+    // The entry moves to the new block, under the size, category and call site of the reallocation
+    ptr = mallocator.Reallocate(ptr, 4_KiB, defaultAlignment, Category<"Testing/Reallocations">{});
+    const std::vector<LeakReportEntry> report = mallocator.GetLeakReport();
+    ASSERT_EQ(report.size(), 1);
+    EXPECT_EQ(report[0].allocationCount, 1);
+    EXPECT_EQ(report[0].size, 4_KiB);
+    EXPECT_EQ(CategoryRegistry::GetName(report[0].category), "Testing/Reallocations");
+    EXPECT_NE(CallSiteRegistry::Get(report[0].callSite).line, CallSiteRegistry::Get(allocationReport[0].callSite).line);
+
+    mallocator.Deallocate(ptr);
+    EXPECT_TRUE(mallocator.GetLeakReport().empty());
+}
+
+TEST_F(LeakDetectionTest, ReallocateHeaderFree)
+{
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Release | MallocatorPolicy::LeakDetection |
+                                                       MallocatorPolicy::HeaderFree};
+    Mallocator<settings>         mallocator;
+
+    void* ptr = mallocator.Allocate(16);
+    for (Size size = 32; size <= 64_KiB; size *= 2)
+    {
+        ptr = mallocator.Reallocate(ptr, size);
+        const std::vector<LeakReportEntry> report = mallocator.GetLeakReport();
+        ASSERT_EQ(report.size(), 1);
+        EXPECT_EQ(report[0].allocationCount, 1);
+        EXPECT_EQ(report[0].size, size);
+    }
+
+    mallocator.Deallocate(ptr);
+    EXPECT_TRUE(mallocator.GetLeakReport().empty());
+}
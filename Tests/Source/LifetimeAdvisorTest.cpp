@@ -0,0 +1,272 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <filesystem>
+#include <vector>
+
+#include <Memarena/Memarena.hpp>
+
+#include "Source/LifetimeAdvisor.hpp"
+
+using namespace Memarena;
+using namespace Memarena::SizeLiterals;
+
+namespace
+{
+// Builds the records of a single call site of a single allocator, with pointer ids numbered in allocation order
+struct TraceBuilder
+{
+    std::vector<TraceRecord> records;
+    UInt32                   nextPointerId = 1;
+
+    UInt32 Allocate(const UInt64 size)
+    {
+        records.push_back({.size = size, .allocatorId = 1, .pointerId = nextPointerId, .alignmentShift = 3});
+        return nextPointerId++;
+    }
+    void Deallocate(const UInt32 pointerId)
+    {
+        records.push_back({.allocatorId = 1, .pointerId = pointerId, .operation = TraceOperation::Deallocate});
+    }
+    void Reallocate(const UInt32 pointerId, const UInt64 size)
+    {
+        records.push_back(
+            {.size = size, .allocatorId = 1, .pointerId = pointerId, .alignmentShift = 3, .operation = TraceOperation::Reallocate});
+    }
+    void Release() { records.push_back({.allocatorId = 1, .operation = TraceOperation::Release}); }
+};
+} // namespace
+
+class LifetimeAdvisorTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override { MemoryTracker::Reset(); }
+    void TearDown() override {}
+};
+
+TEST_F(LifetimeAdvisorTest, LifetimeAdvice)
+{
+    constexpr MallocatorSettings      mallocatorSettings = {.policy = MallocatorPolicy::Release | MallocatorPolicy::TraceRecording};
+    constexpr LinearAllocatorSettings linearSettings = {.policy = LinearAllocatorPolicy::Release | LinearAllocatorPolicy::TraceRecording};
+    Mallocator<mallocatorSettings>    mallocator;
+    LinearAllocator<linearSettings>   linearAllocator{1_KiB};
+
+    const std::filesystem::path tracePath = std::filesystem::temp_directory_path() / "MemarenaLifetimeTrace.bin";
+    ASSERT_TRUE(TraceRecorder::Start(tracePath.string()));
+
+    std::vector<void*> longLivedPtrs;
+    for (Size round = 0; round < 8; round++)
+    {
+        // Each line is a call site
+        std::array<void*, 3> scopedPtrs{};
+        for (Size i = 0; i < scopedPtrs.size(); i++)
+        {
+            scopedPtrs[i] = mallocator.Allocate(16 << i);
+        }
+        for (Size i = scopedPtrs.size(); i > 0; i--)
+        {
+            mallocator.Deallocate(scopedPtrs[i - 1]);
+        }
+
+        std::array<void*, 2> churnPtrs{};
+        for (void*& ptr : churnPtrs)
+        {
+            ptr = mallocator.Allocate(48);
+        }
+        for (void* ptr : churnPtrs)
+        {
+            mallocator.Deallocate(ptr);
+        }
+
+        for (Size i = 0; i < 10; i++)
+        {
+            EXPECT_NE(linearAllocator.Allocate(20 + i, 8), nullptr);
+        }
+        linearAllocator.Release();
+
+        longLivedPtrs.push_back(mallocator.Allocate(256));
+    }
+
+    ASSERT_TRUE(TraceRecorder::Stop());
+    for (void* ptr : longLivedPtrs)
+    {
+        mallocator.Deallocate(ptr);
+    }
+
+    Trace trace;
+    ASSERT_TRUE(TraceRecorder::ReadTrace(tracePath.string(), trace));
+    std::filesystem::remove(tracePath);
+
+    const std::vector<AllocationSiteAdvice> advice = AnalyzeLifetimes(trace.records);
+    ASSERT_EQ(advice.size(), 4);
+
+    EXPECT_EQ(advice[0].pattern, LifetimePattern::BulkFreed);
+    EXPECT_EQ(advice[0].recommendedAllocator, AllocatorKind::Linear);
+    EXPECT_EQ(advice[0].allocatorId, linearAllocator.GetId().value);
+    EXPECT_EQ(advice[0].releasedCount, 80);
+    EXPECT_EQ(advice[0].peakLiveSize, 245);
+    EXPECT_EQ(advice[0].totalSize, 245 + 10 * 7);
+
+    EXPECT_EQ(advice[1].pattern, LifetimePattern::StrictlyLifo);
+    EXPECT_EQ(advice[1].recommendedAllocator, AllocatorKind::Stack);
+    EXPECT_EQ(advice[1].deallocationCount, 24);
+    EXPECT_EQ(advice[1].minSize, 16);
+    EXPECT_EQ(advice[1].maxSize, 64);
+    EXPECT_GE(advice[1].totalSize, 16 + 32 + 64);
+
+    EXPECT_EQ(advice[2].pattern, LifetimePattern::SameSizeChurn);
+    EXPECT_EQ(advice[2].recommendedAllocator, AllocatorKind::Pool);
+    EXPECT_EQ(advice[2].objectSize, 48);
+    EXPECT_EQ(advice[2].objectsPerBlock, 2);
+
+    EXPECT_EQ(advice[3].pattern, LifetimePattern::LongLived);
+    EXPECT_EQ(advice[3].recommendedAllocator, AllocatorKind::Mallocator);
+    EXPECT_EQ(advice[3].liveCount, 8);
+
+    for (const AllocationSiteAdvice& siteAdvice : advice)
+    {
+        ASSERT_LT(siteAdvice.callSite, trace.callSites.size());
+        EXPECT_TRUE(trace.callSites[siteAdvice.callSite].fileName.ends_with("LifetimeAdvisorTest.cpp"));
+    }
+}
+
+TEST_F(LifetimeAdvisorTest, StrictlyLifo)
+{
+    TraceBuilder builder;
+    for (int round = 0; round < 4; round++)
+    {
+        const std::array<UInt32, 3> ptrs = {builder.Allocate(16), builder.Allocate(32), builder.Allocate(64)};
+        for (Size i = ptrs.size(); i > 0; i--)
+        {
+            builder.Deallocate(ptrs[i - 1]);
+        }
+    }
+
+    const std::vector<AllocationSiteAdvice> advice = AnalyzeLifetimes(builder.records);
+    ASSERT_EQ(advice.size(), 1);
+    EXPECT_EQ(advice[0].pattern, LifetimePattern::StrictlyLifo);
+    EXPECT_EQ(advice[0].recommendedAllocator, AllocatorKind::Stack);
+    EXPECT_EQ(advice[0].peakLiveCount, 3);
+    EXPECT_GE(advice[0].totalSize, 16 + 32 + 64);
+}
+
+TEST_F(LifetimeAdvisorTest, SameSizeChurn)
+{
+    // The frees are also LIFO, but a pool is preferred as it needs no headers
+    TraceBuilder builder;
+    for (int round = 0; round < 4; round++)
+    {
+        const UInt32 first  = builder.Allocate(40);
+        const UInt32 second = builder.Allocate(40);
+        builder.Deallocate(second);
+        builder.Deallocate(first);
+    }
+
+    const std::vector<AllocationSiteAdvice> advice = AnalyzeLifetimes(builder.records);
+    ASSERT_EQ(advice.size(), 1);
+    EXPECT_EQ(advice[0].pattern, LifetimePattern::SameSizeChurn);
+    EXPECT_EQ(advice[0].recommendedAllocator, AllocatorKind::Pool);
+    EXPECT_EQ(advice[0].objectSize, 40);
+    EXPECT_EQ(advice[0].objectsPerBlock, 2);
+}
+
+TEST_F(LifetimeAdvisorTest, BulkFreedByRelease)
+{
+    TraceBuilder builder;
+    for (int round = 0; round < 4; round++)
+    {
+        for (UInt64 size = 10; size < 20; size++)
+        {
+            builder.Allocate(size);
+        }
+        builder.Release();
+    }
+
+    const std::vector<AllocationSiteAdvice> advice = AnalyzeLifetimes(builder.records);
+    ASSERT_EQ(advice.size(), 1);
+    EXPECT_EQ(advice[0].pattern, LifetimePattern::BulkFreed);
+    EXPECT_EQ(advice[0].recommendedAllocator, AllocatorKind::Linear);
+    EXPECT_EQ(advice[0].releasedCount, 40);
+    EXPECT_EQ(advice[0].deallocationCount, 0);
+}
+
+TEST_F(LifetimeAdvisorTest, BulkFreedInBatches)
+{
+    // Freed one at a time, in allocation order, until nothing of the site is live
+    TraceBuilder builder;
+    for (int round = 0; round < 4; round++)
+    {
+        std::vector<UInt32> ptrs;
+        for (UInt64 size = 10; size < 15; size++)
+        {
+            ptrs.push_back(builder.Allocate(size));
+        }
+        for (const UInt32 ptr : ptrs)
+        {
+            builder.Deallocate(ptr);
+        }
+    }
+
+    const std::vector<AllocationSiteAdvice> advice = AnalyzeLifetimes(builder.records);
+    ASSERT_EQ(advice.size(), 1);
+    EXPECT_EQ(advice[0].pattern, LifetimePattern::BulkFreed);
+    EXPECT_EQ(advice[0].recommendedAllocator, AllocatorKind::Linear);
+    EXPECT_EQ(advice[0].deallocationCount, 20);
+}
+
+TEST_F(LifetimeAdvisorTest, LongLived)
+{
+    TraceBuilder builder;
+    const UInt32 first = builder.Allocate(16);
+    builder.Allocate(32);
+    builder.Allocate(48);
+    builder.Deallocate(first);
+
+    const std::vector<AllocationSiteAdvice> advice = AnalyzeLifetimes(builder.records);
+    ASSERT_EQ(advice.size(), 1);
+    EXPECT_EQ(advice[0].pattern, LifetimePattern::LongLived);
+    EXPECT_EQ(advice[0].recommendedAllocator, AllocatorKind::Mallocator);
+    EXPECT_EQ(advice[0].liveCount, 2);
+}
+
+TEST_F(LifetimeAdvisorTest, Mixed)
+{
+    // Each allocation outlives the next one, so the frees are neither LIFO nor in batches, and the sizes differ
+    TraceBuilder builder;
+    UInt32       previous = builder.Allocate(16);
+    for (UInt64 size = 17; size < 40; size++)
+    {
+        const UInt32 current = builder.Allocate(size);
+        builder.Deallocate(previous);
+        previous = current;
+    }
+    builder.Deallocate(previous);
+
+    const std::vector<AllocationSiteAdvice> advice = AnalyzeLifetimes(builder.records);
+    ASSERT_EQ(advice.size(), 1);
+    EXPECT_EQ(advice[0].pattern, LifetimePattern::Mixed);
+    EXPECT_EQ(advice[0].recommendedAllocator, AllocatorKind::Mallocator);
+    EXPECT_STREQ(GetLifetimePatternName(advice[0].pattern), "mixed");
+}
+
+TEST_F(LifetimeAdvisorTest, ReallocationBreaksSameSizeChurn)
+{
+    // Same-size churn, except that one allocation is resized in place of being freed and allocated again
+    TraceBuilder builder;
+    for (int round = 0; round < 4; round++)
+    {
+        const UInt32 first  = builder.Allocate(40);
+        const UInt32 second = builder.Allocate(40);
+        if (round == 0)
+        {
+            builder.Reallocate(second, 40);
+        }
+        builder.Deallocate(first);
+        builder.Deallocate(second);
+    }
+
+    const std::vector<AllocationSiteAdvice> advice = AnalyzeLifetimes(builder.records);
+    ASSERT_EQ(advice.size(), 1);
+    EXPECT_EQ(advice[0].reallocationCount, 1);
+    EXPECT_NE(advice[0].pattern, LifetimePattern::SameSizeChurn);
+}
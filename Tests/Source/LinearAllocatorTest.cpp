@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <filesystem>
 #include <memory>
 #include <memory_resource>
 #include <thread>
@@ -12,6 +13,7 @@
 #include "Source/Allocators/LinearAllocator/LinearAllocator.hpp"
 #include "Source/MemoryTracker.hpp"
 #include "Source/Policies/Policies.hpp"
+#include "Source/Utility/VirtualMemory.hpp"
 
 using namespace Memarena;
 using namespace Memarena::SizeLiterals;
@@ -177,6 +179,86 @@ TEST_F(LinearAllocatorTest, Growable)
     EXPECT_EQ(linearAllocator2.GetTotalSize(), blockSize * 10);
 }
 
+TEST_F(LinearAllocatorTest, Presized)
+{
+    constexpr LinearAllocatorSettings settings = {.policy = LinearAllocatorPolicy::Default | LinearAllocatorPolicy::Growable |
+                                                           LinearAllocatorPolicy::Presized};
+
+    const std::filesystem::path profilePath = std::filesystem::temp_directory_path() / "MemarenaLinearPresize.txt";
+    PresizeProfile::Clear();
+
+    {
+        LinearAllocator<settings> linearAllocator{256, "PresizedLinearAllocator"};
+        for (Size i = 0; i < 10; i++)
+        {
+            EXPECT_NE(linearAllocator.Allocate(200), nullptr);
+        }
+        EXPECT_EQ(linearAllocator.GetTotalSize(), 256 * 10);
+    }
+    ASSERT_TRUE(PresizeProfile::Save(profilePath.string()));
+
+    // The retired blocks count as full, so the peak is 9 blocks and the last allocation
+    PresizeProfile::Clear();
+    ASSERT_TRUE(PresizeProfile::Load(profilePath.string()));
+    EXPECT_EQ(PresizeProfile::GetPeakUsedSize("PresizedLinearAllocator"), 256 * 9 + 200);
+
+    // The next run starts with a block that holds everything
+    {
+        LinearAllocator<settings> linearAllocator{256, "PresizedLinearAllocator"};
+        EXPECT_EQ(linearAllocator.GetTotalSize(), 256 * 9 + 200);
+        for (Size i = 0; i < 10; i++)
+        {
+            EXPECT_NE(linearAllocator.Allocate(200), nullptr);
+        }
+        EXPECT_EQ(linearAllocator.GetTotalSize(), 256 * 9 + 200);
+    }
+    ASSERT_TRUE(PresizeProfile::Save(profilePath.string()));
+
+    // Without growing the peak is what was allocated, with the padding that aligns each allocation after the first, so the
+    // profile does not keep growing from run to run
+    PresizeProfile::Clear();
+    ASSERT_TRUE(PresizeProfile::Load(profilePath.string()));
+    std::filesystem::remove(profilePath);
+    const Size alignedSize = CalculateAlignedAddress(200, defaultAlignment);
+    EXPECT_EQ(PresizeProfile::GetPeakUsedSize("PresizedLinearAllocator"), alignedSize * 9 + 200);
+
+    PresizeProfile::Clear();
+}
+
+TEST_F(LinearAllocatorTest, PresizedSharedName)
+{
+    constexpr LinearAllocatorSettings settings = {.policy = LinearAllocatorPolicy::Default | LinearAllocatorPolicy::Growable |
+                                                           LinearAllocatorPolicy::Presized};
+
+    const std::filesystem::path profilePath = std::filesystem::temp_directory_path() / "MemarenaLinearPresizeShared.txt";
+    PresizeProfile::Clear();
+
+    {
+        // Live allocators with the default name get their own entries
+        LinearAllocator<settings> smallAllocator{1_KB};
+        LinearAllocator<settings> largeAllocator{1_KB};
+        EXPECT_NE(smallAllocator.Allocate(100), nullptr);
+        EXPECT_NE(largeAllocator.Allocate(800), nullptr);
+
+        // A slot is free again once its allocator is gone
+        {
+            LinearAllocator<settings> linearAllocator{1_KB};
+        }
+        LinearAllocator<settings> scratchAllocator{1_KB};
+        EXPECT_NE(scratchAllocator.Allocate(300), nullptr);
+        ASSERT_TRUE(PresizeProfile::Save(profilePath.string()));
+    }
+
+    PresizeProfile::Clear();
+    ASSERT_TRUE(PresizeProfile::Load(profilePath.string()));
+    std::filesystem::remove(profilePath);
+    EXPECT_EQ(PresizeProfile::GetPeakUsedSize("LinearAllocator", 0), 100);
+    EXPECT_EQ(PresizeProfile::GetPeakUsedSize("LinearAllocator", 1), 800);
+    EXPECT_EQ(PresizeProfile::GetPeakUsedSize("LinearAllocator", 2), 300);
+
+    PresizeProfile::Clear();
+}
+
 TEST_F(LinearAllocatorTest, Templated)
 {
     LinearAllocatorTemplated<TestObject> linearAllocatorTemplated{10_KB};
@@ -225,22 +307,22 @@ TEST_F(LinearAllocatorTest, MemoryTracker)
     const AllocatorVector allocators = MemoryTracker::GetAllocators();
     EXPECT_EQ(allocators.size(), 1);
 
-    int* num = static_cast<int*>(linearAllocator.Allocate<int>("Testing/LinearAllocator"));
+    int* num = static_cast<int*>(linearAllocator.Allocate<int>(Category<"Testing/LinearAllocator">{}));
 
     if (allocators.size() > 0)
     {
-        EXPECT_EQ(allocators[0]->totalSize, 1_MB);
-        EXPECT_EQ(allocators[0]->usedSize, sizeof(int));
-        EXPECT_EQ(allocators[0]->allocationCount, 1);
-        EXPECT_EQ(allocators[0]->deallocationCount, 0);
-        EXPECT_EQ(allocators[0]->allocations[0].category, std::string("Testing/LinearAllocator"));
-        EXPECT_EQ(allocators[0]->allocations[0].size, sizeof(int));
+        EXPECT_EQ(allocators[0]->statistics.GetTotalSize(), 1_MB);
+        EXPECT_EQ(allocators[0]->statistics.GetUsedSize(), sizeof(int));
+        EXPECT_EQ(allocators[0]->statistics.GetAllocationCount(), 1);
+        EXPECT_EQ(allocators[0]->statistics.GetDeallocationCount(), 0);
+        EXPECT_EQ(CategoryRegistry::GetName(allocators[0]->allocationEvents.GetEvents()[0].category), "Testing/LinearAllocator");
+        EXPECT_EQ(allocators[0]->allocationEvents.GetEvents()[0].size, sizeof(int));
     }
 }
 
 ALLOCATOR_DEBUG_TEST(DefaultBaseAllocator, {
-    int* num = static_cast<int*>(linearAllocator.Allocate<int>("Testing/LinearAllocator"));
-    EXPECT_EQ(Allocator::GetDefaultAllocator()->GetTotalSize(), 1_MB);
+    int* num = static_cast<int*>(linearAllocator.Allocate<int>(Category<"Testing/LinearAllocator">{}));
+    EXPECT_GE(Allocator::GetDefaultAllocator()->GetTotalSize(), 1_MB);
 })
 
 TEST_F(LinearAllocatorTest, CustomBaseAllocator)
@@ -252,10 +334,129 @@ TEST_F(LinearAllocatorTest, CustomBaseAllocator)
     constexpr LinearAllocatorSettings settings = {.policy = LinearAllocatorPolicy::Debug};
     LinearAllocator<settings>         linearAllocator{1_MB, "TestAllocator", baseAllocator};
 
-    int* num = static_cast<int*>(linearAllocator.Allocate<int>("Testing/LinearAllocator"));
+    int* num = static_cast<int*>(linearAllocator.Allocate<int>(Category<"Testing/LinearAllocator">{}));
     EXPECT_EQ(baseAllocator->GetTotalSize(), 1_MB);
 }
 
+TEST_F(LinearAllocatorTest, LargeOffsets)
+{
+    constexpr MallocatorSettings      mallocatorSettings = {.policy = MallocatorPolicy::Default | MallocatorPolicy::DirectMap};
+    constexpr LinearAllocatorSettings settings           = {.policy = LinearAllocatorPolicy::Default | LinearAllocatorPolicy::LargeOffsets};
+
+    using BaseAllocator = Mallocator<mallocatorSettings>;
+
+    void* probe = MapMemory(5_GiB);
+    if (probe == nullptr)
+    {
+        GTEST_SKIP() << "Could not map 5 GiB of address space";
+    }
+    UnmapMemory(probe, 5_GiB);
+
+    BaseAllocator                            baseAllocator{"Mallocator", 1_MiB};
+    LinearAllocator<settings, BaseAllocator> linearAllocator{5_GiB, "TestAllocator", baseAllocator};
+
+    void* filler = linearAllocator.Allocate(4_GiB + 1_MiB);
+    ASSERT_NE(filler, nullptr);
+
+    int* num = linearAllocator.NewRaw<int>(5);
+    EXPECT_EQ(*num, 5);
+    EXPECT_GT(std::bit_cast<UIntPtr>(num) - std::bit_cast<UIntPtr>(filler), std::numeric_limits<Offset>::max());
+    EXPECT_GT(linearAllocator.GetUsedSize(), 4_GiB);
+}
+
+TEST_F(LinearAllocatorTest, TemplatedBaseAllocator)
+{
+    constexpr MallocatorSettings      mallocatorSettings = {.policy = MallocatorPolicy::Default};
+    constexpr LinearAllocatorSettings settings           = {.policy = LinearAllocatorPolicy::Default | LinearAllocatorPolicy::Growable};
+
+    using BaseAllocator = Mallocator<mallocatorSettings>;
+
+    BaseAllocator                            baseAllocator{"Mallocator"};
+    LinearAllocator<settings, BaseAllocator> linearAllocator{1_KiB, "TestAllocator", baseAllocator};
+
+    for (int i = 0; i < 100; i++)
+    {
+        int* num = linearAllocator.NewRaw<int>(i);
+        EXPECT_EQ(*num, i);
+    }
+    EXPECT_EQ(baseAllocator.GetTotalSize(), linearAllocator.GetTotalSize());
+
+    linearAllocator.Release();
+    EXPECT_EQ(baseAllocator.GetTotalSize(), 1_KiB);
+}
+
+TEST_F(LinearAllocatorTest, StackBaseAllocator)
+{
+    constexpr StackAllocatorSettings  stackSettings = {.policy = StackAllocatorPolicy::Debug};
+    constexpr LinearAllocatorSettings settings      = {.policy = LinearAllocatorPolicy::Default | LinearAllocatorPolicy::Growable};
+
+    using BaseAllocator = StackAllocator<stackSettings>;
+
+    BaseAllocator stackAllocator{1_KiB, "StackAllocator"};
+    {
+        LinearAllocator<settings, BaseAllocator> linearAllocator{64, "LinearAllocator", stackAllocator};
+        for (int i = 0; i < 3; i++)
+        {
+            EXPECT_NE(linearAllocator.Allocate(48), nullptr);
+        }
+        EXPECT_GT(stackAllocator.GetUsedSize(), 0);
+    }
+    // The blocks have to be returned in the reverse order of their allocation
+    EXPECT_EQ(stackAllocator.GetUsedSize(), 0);
+}
+
+TEST_F(LinearAllocatorTest, StackBaseAllocatorOutOfMemory)
+{
+    constexpr StackAllocatorSettings stackSettings = {
+        .policy = StackAllocatorPolicy::Debug, .breakOnFailureIsEnabled = false, .failureLoggingIsEnabled = false};
+    constexpr LinearAllocatorSettings settings = {.policy = LinearAllocatorPolicy::Default | LinearAllocatorPolicy::Growable,
+                                                  .breakOnFailureIsEnabled = false,
+                                                  .failureLoggingIsEnabled = false};
+
+    using BaseAllocator = StackAllocator<stackSettings>;
+
+    BaseAllocator stackAllocator{256, "StackAllocator"};
+    {
+        LinearAllocator<settings, BaseAllocator> linearAllocator{64, "LinearAllocator", stackAllocator};
+        int                                      allocationCount = 0;
+        while (linearAllocator.Allocate(48) != nullptr)
+        {
+            allocationCount++;
+        }
+        // One allocation per block, for the blocks the stack had room for
+        EXPECT_GT(allocationCount, 0);
+        EXPECT_LT(allocationCount, 256 / 64);
+
+        // The rest of the current block can still be used
+        EXPECT_NE(linearAllocator.Allocate(8), nullptr);
+    }
+    EXPECT_EQ(stackAllocator.GetUsedSize(), 0);
+
+    // Not even the first block fits
+    BaseAllocator smallStackAllocator{32, "SmallStackAllocator"};
+    {
+        LinearAllocator<settings, BaseAllocator> linearAllocator{64, "LinearAllocator", smallStackAllocator};
+        EXPECT_EQ(linearAllocator.Allocate(8), nullptr);
+        EXPECT_EQ(linearAllocator.Allocate(8), nullptr);
+    }
+    EXPECT_EQ(smallStackAllocator.GetUsedSize(), 0);
+}
+
+TEST_F(LinearAllocatorTest, LargeAlignment)
+{
+    constexpr LinearAllocatorSettings settings = {.policy = LinearAllocatorPolicy::Default, .blockAlignment = 2_MiB};
+    LinearAllocator<settings>         linearAllocator{4_MiB};
+
+    // The block is aligned to 2 MiB, so the first allocation needs no padding
+    void* first = linearAllocator.Allocate(64, 2_MiB);
+    EXPECT_EQ(std::bit_cast<UIntPtr>(first) % 2_MiB, 0);
+    EXPECT_EQ(linearAllocator.GetUsedSize(), 64);
+
+    void* second = linearAllocator.Allocate(64, 4_KiB);
+    EXPECT_EQ(std::bit_cast<UIntPtr>(second) % 4_KiB, 0);
+    EXPECT_EQ(linearAllocator.GetUsedSize(), 4_KiB + 64);
+}
+
 ALLOCATOR_DEBUG_TEST(GetUsedSizeNew, {
     const int numObjects = 10;
     for (size_t i = 0; i < numObjects; i++)
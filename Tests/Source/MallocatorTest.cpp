@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <array>
+#include <cstring>
+#include <limits>
 #include <memory>
 #include <memory_resource>
+#include <numeric>
 #include <thread>
 
 #include <Memarena/Memarena.hpp>
@@ -392,19 +396,19 @@ TEST_F(MallocatorTest, MemoryTracker)
     constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Debug};
     Mallocator<settings>         mallocator2{};
 
-    int* num = static_cast<int*>(mallocator2.Allocate<int>("Testing/Mallocator"));
+    int* num = static_cast<int*>(mallocator2.Allocate<int>(Category<"Testing/Mallocator">{}));
 
     const AllocatorVector allocators = MemoryTracker::GetBaseAllocators();
 
     EXPECT_EQ(allocators.size(), 1);
     if (allocators.size() > 0)
     {
-        EXPECT_EQ(allocators[0]->totalSize, sizeof(int));
-        EXPECT_EQ(allocators[0]->usedSize, sizeof(int));
-        EXPECT_EQ(allocators[0]->allocationCount, 1);
-        EXPECT_EQ(allocators[0]->deallocationCount, 0);
-        EXPECT_EQ(allocators[0]->allocations[0].category, std::string("Testing/Mallocator"));
-        EXPECT_EQ(allocators[0]->allocations[0].size, sizeof(int));
+        EXPECT_EQ(allocators[0]->statistics.GetTotalSize(), sizeof(int));
+        EXPECT_EQ(allocators[0]->statistics.GetUsedSize(), sizeof(int));
+        EXPECT_EQ(allocators[0]->statistics.GetAllocationCount(), 1);
+        EXPECT_EQ(allocators[0]->statistics.GetDeallocationCount(), 0);
+        EXPECT_EQ(CategoryRegistry::GetName(allocators[0]->allocationEvents.GetEvents()[0].category), "Testing/Mallocator");
+        EXPECT_EQ(allocators[0]->allocationEvents.GetEvents()[0].size, sizeof(int));
     }
     EXPECT_EQ(MemoryTracker::GetTotalAllocatedSize(), sizeof(int));
 }
@@ -427,6 +431,244 @@ TEST_F(MallocatorTest, DoubleFreeRaw)
     EXPECT_EQ(ptr, nullptr);
 }
 
+TEST_F(MallocatorTest, Reallocate)
+{
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Default};
+    Mallocator<settings>         mallocator{};
+
+    int* arr = static_cast<int*>(mallocator.AllocateArray<int>(10));
+    std::iota(arr, arr + 10, 0);
+
+    arr = static_cast<int*>(mallocator.Reallocate(arr, 1000 * sizeof(int)));
+    EXPECT_EQ(mallocator.GetUsedSize(), 1000 * sizeof(int));
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_EQ(arr[i], i);
+    }
+
+    void* ptr = arr;
+    mallocator.Deallocate(ptr);
+    EXPECT_EQ(mallocator.GetUsedSize(), 0);
+}
+
+TEST_F(MallocatorTest, ReallocateFailureKeepsLiveEntries)
+{
+    constexpr MallocatorSettings settings = {
+        .policy = MallocatorPolicy::Default | MallocatorPolicy::LeakDetection | MallocatorPolicy::HeapSampling,
+        .breakOnFailureIsEnabled = false,
+        .failureLoggingIsEnabled = false};
+    Mallocator<settings> mallocator{};
+
+    // Samples every allocation
+    HeapSampler::SetSampleInterval(1);
+    void* ptr = mallocator.Allocate(64);
+    HeapSampler::SetSampleInterval(HeapSampler::defaultSampleInterval);
+
+    // The old block is still live after a failed reallocation, so its entries have to be put back
+    EXPECT_EQ(mallocator.Reallocate(ptr, std::numeric_limits<Size>::max() / 2), nullptr);
+
+    const std::vector<LeakReportEntry> report = mallocator.GetLeakReport();
+    ASSERT_EQ(report.size(), 1);
+    EXPECT_EQ(report[0].size, 64);
+    const std::vector<HeapProfileEntry> profile = mallocator.GetHeapProfile();
+    ASSERT_EQ(profile.size(), 1);
+    EXPECT_EQ(profile[0].liveCount, 1);
+
+    mallocator.Deallocate(ptr);
+    EXPECT_TRUE(mallocator.GetLeakReport().empty());
+    EXPECT_EQ(mallocator.GetHeapProfile()[0].liveCount, 0);
+}
+
+TEST_F(MallocatorTest, DirectMap)
+{
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Default | MallocatorPolicy::DirectMap};
+    Mallocator<settings>         mallocator{"Mallocator", 64_KiB};
+
+    const Size count = 1_MiB / sizeof(int);
+    int*       arr   = static_cast<int*>(mallocator.AllocateArray<int>(count));
+    ASSERT_NE(arr, nullptr);
+    std::iota(arr, arr + count, 0);
+    EXPECT_EQ(mallocator.GetUsedSize(), 1_MiB);
+
+    MallocArrayPtr<TestObject> objects = mallocator.NewArray<TestObject>(10000, 1, 2.1F, 'a', false, 10.6F);
+    EXPECT_EQ(objects[9999], TestObject(1, 2.1F, 'a', false, 10.6F));
+    mallocator.DeleteArray(objects);
+
+    void* ptr = arr;
+    mallocator.Deallocate(ptr);
+    EXPECT_EQ(mallocator.GetUsedSize(), 0);
+}
+
+TEST_F(MallocatorTest, DirectMapReallocate)
+{
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Default | MallocatorPolicy::DirectMap |
+                                                       MallocatorPolicy::PopulateDirectMap | MallocatorPolicy::HugePageDirectMap};
+    Mallocator<settings>         mallocator{"Mallocator", 64_KiB};
+
+    // Start below the threshold, grow into a mapping, grow the mapping and then shrink back below the threshold
+    const std::array<Size, 4> counts = {1000, 1_MiB / sizeof(int), 16_MiB / sizeof(int), 100};
+
+    int* arr = static_cast<int*>(mallocator.AllocateArray<int>(counts[0]));
+    std::iota(arr, arr + counts[0], 0);
+
+    for (Size i = 1; i < counts.size(); i++)
+    {
+        arr = static_cast<int*>(mallocator.Reallocate(arr, counts[i] * sizeof(int)));
+        ASSERT_NE(arr, nullptr);
+        EXPECT_EQ(mallocator.GetUsedSize(), counts[i] * sizeof(int));
+
+        const Size preserved = std::min(counts[i - 1], counts[i]);
+        for (Size j = 0; j < preserved; j++)
+        {
+            ASSERT_EQ(arr[j], j % counts[0]);
+        }
+        // Refill so the next step checks the whole preserved range
+        for (Size j = 0; j < counts[i]; j++)
+        {
+            arr[j] = static_cast<int>(j % counts[0]);
+        }
+    }
+
+    void* ptr = arr;
+    mallocator.Deallocate(ptr);
+    EXPECT_EQ(mallocator.GetUsedSize(), 0);
+}
+
+TEST_F(MallocatorTest, LargeAlignment)
+{
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Default};
+    Mallocator<settings>         mallocator{};
+
+    for (const Size alignment : {Size{32}, Size{256}, 4_KiB, 2_MiB})
+    {
+        void* ptr = mallocator.Allocate(100, alignment);
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_EQ(std::bit_cast<UIntPtr>(ptr) % alignment, 0);
+        std::memset(ptr, 1, 100);
+
+        // Growing moves the block, which has to stay aligned
+        ptr = mallocator.Reallocate(ptr, 10_KiB);
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_EQ(std::bit_cast<UIntPtr>(ptr) % alignment, 0);
+        EXPECT_EQ(static_cast<Byte*>(ptr)[99], 1);
+
+        mallocator.Deallocate(ptr);
+    }
+
+    EXPECT_EQ(mallocator.GetUsedSize(), 0);
+}
+
+TEST_F(MallocatorTest, DirectMapLargeAlignment)
+{
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Default | MallocatorPolicy::DirectMap};
+    Mallocator<settings>         mallocator{"Mallocator", 1_MiB};
+
+    for (const Size alignment : {4_KiB, 2_MiB})
+    {
+        void* ptr = mallocator.Allocate(4_MiB, alignment);
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_EQ(std::bit_cast<UIntPtr>(ptr) % alignment, 0);
+        std::memset(ptr, 1, 4_MiB);
+
+        ptr = mallocator.Reallocate(ptr, 8_MiB);
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_EQ(std::bit_cast<UIntPtr>(ptr) % alignment, 0);
+        EXPECT_EQ(static_cast<Byte*>(ptr)[4_MiB - 1], 1);
+
+        mallocator.Deallocate(ptr);
+    }
+
+    EXPECT_EQ(mallocator.GetUsedSize(), 0);
+}
+
+#ifdef MEMARENA_MALLOC_SIZE_AVAILABLE
+
+TEST_F(MallocatorTest, HeaderFreeAllocate)
+{
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Default | MallocatorPolicy::HeaderFree};
+    Mallocator<settings>         mallocator{};
+
+    void* ptr = mallocator.Allocate(100);
+
+    // Without a header the pointer is the one returned by malloc, so it keeps malloc's alignment
+    EXPECT_EQ(std::bit_cast<UIntPtr>(ptr) % alignof(std::max_align_t), 0);
+    EXPECT_EQ(mallocator.GetUsedSize(), GetMallocSize(ptr));
+    EXPECT_GE(mallocator.GetUsedSize(), 100);
+    EXPECT_EQ(mallocator.GetSlackSize(), mallocator.GetUsedSize() - 100);
+
+    const Size slackSize = mallocator.GetSlackSize();
+    EXPECT_EQ(mallocator.DeallocateArray(ptr), slackSize + 100);
+    EXPECT_EQ(mallocator.GetUsedSize(), 0);
+    // The slack size is summed over every allocation, so freeing does not lower it
+    EXPECT_EQ(mallocator.GetSlackSize(), slackSize);
+}
+
+TEST_F(MallocatorTest, HeaderFreeNewDelete)
+{
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Debug | MallocatorPolicy::HeaderFree};
+    Mallocator<settings>         mallocator{};
+
+    MallocPtr<TestObject> object    = mallocator.New<TestObject>(1, 2.1F, 'a', false, 10.6F);
+    TestObject*           objectRaw = mallocator.NewRaw<TestObject>(1, 2.1F, 'a', false, 10.6F);
+    int*                  arrayRaw  = mallocator.NewArrayRaw<int>(10, 5);
+
+    EXPECT_EQ(*object, TestObject(1, 2.1F, 'a', false, 10.6F));
+    EXPECT_EQ(*objectRaw, TestObject(1, 2.1F, 'a', false, 10.6F));
+    EXPECT_GE(mallocator.GetUsedSize(), 2 * sizeof(TestObject) + 10 * sizeof(int));
+
+    mallocator.DeleteArray(arrayRaw);
+    mallocator.Delete(objectRaw);
+    mallocator.Delete(object);
+
+    EXPECT_EQ(mallocator.GetUsedSize(), 0);
+    EXPECT_EQ(mallocator.GetTotalSize(), 0);
+}
+
+TEST_F(MallocatorTest, HeaderFreeReallocate)
+{
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Default | MallocatorPolicy::HeaderFree};
+    Mallocator<settings>         mallocator{};
+
+    int* arr = static_cast<int*>(mallocator.AllocateArray<int>(10));
+    std::iota(arr, arr + 10, 0);
+
+    arr = static_cast<int*>(mallocator.Reallocate(arr, 1000 * sizeof(int)));
+    EXPECT_EQ(mallocator.GetUsedSize(), GetMallocSize(arr));
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_EQ(arr[i], i);
+    }
+
+    void* ptr = arr;
+    mallocator.Deallocate(ptr);
+    EXPECT_EQ(mallocator.GetUsedSize(), 0);
+}
+
+TEST_F(MallocatorTest, HeaderFreeLargeAlignment)
+{
+    if constexpr (!AlignedMallocIsFreeCompatible)
+    {
+        GTEST_SKIP() << "Over-aligned blocks need a header on this platform";
+    }
+
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Default | MallocatorPolicy::HeaderFree};
+    Mallocator<settings>         mallocator{};
+
+    void* ptr = mallocator.Allocate(100, 4_KiB);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(std::bit_cast<UIntPtr>(ptr) % 4_KiB, 0);
+    EXPECT_EQ(mallocator.GetUsedSize(), GetMallocSize(ptr));
+
+    ptr = mallocator.Reallocate(ptr, 10_KiB, 4_KiB);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(std::bit_cast<UIntPtr>(ptr) % 4_KiB, 0);
+
+    mallocator.Deallocate(ptr);
+    EXPECT_EQ(mallocator.GetUsedSize(), 0);
+}
+
+#endif
+
 #ifdef MEMARENA_ENABLE_ASSERTS
 
 class MallocatorDeathTest : public ::testing::Test
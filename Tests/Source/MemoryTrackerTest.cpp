@@ -1,5 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
 #include <Memarena/Memarena.hpp>
 
 #include "MemoryTestObjects.hpp"
@@ -8,6 +15,17 @@ using namespace Memarena::SizeLiterals;
 
 using namespace Memarena;
 
+namespace
+{
+std::string ReadFile(const std::filesystem::path& path)
+{
+    std::ifstream     file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+} // namespace
+
 class MemoryTrackerTest : public ::testing::Test
 {
   protected:
@@ -21,13 +39,483 @@ TEST_F(MemoryTrackerTest, StackAllocator)
 
     StackAllocator<settings> stackAllocator{10_MB};
 
-    int* num = static_cast<int*>(stackAllocator.Allocate<int>("Testing/StackAllocator"));
+    int* num = static_cast<int*>(stackAllocator.Allocate<int>(Category<"Testing/StackAllocator">{}));
 
     const AllocatorVector allocators = MemoryTracker::GetAllocators();
 
     EXPECT_EQ(allocators.size(), 1);
-    EXPECT_EQ(allocators[0]->totalSize, 10_MB);
-    EXPECT_EQ(allocators[0]->allocationCount, 1);
-    EXPECT_EQ(allocators[0]->allocations[0].category, std::string("Testing/StackAllocator"));
-    EXPECT_EQ(allocators[0]->allocations[0].size, sizeof(int));
-}
\ No newline at end of file
+    EXPECT_EQ(allocators[0]->statistics.GetTotalSize(), 10_MB);
+    EXPECT_EQ(allocators[0]->statistics.GetAllocationCount(), 1);
+    EXPECT_EQ(CategoryRegistry::GetName(allocators[0]->allocationEvents.GetEvents()[0].category), "Testing/StackAllocator");
+    EXPECT_EQ(allocators[0]->allocationEvents.GetEvents()[0].size, sizeof(int));
+}
+TEST_F(MemoryTrackerTest, UntrackedAllocator)
+{
+    constexpr StackAllocatorSettings settings = {.policy = StackAllocatorPolicy::Release};
+
+    {
+        StackAllocator<settings> stackAllocator{10_MB, "Untracked"};
+        StackAllocator<settings> otherAllocator{1_MB, "OtherUntracked"};
+        int*                     num = stackAllocator.NewRaw<int>(5);
+
+        EXPECT_EQ(*num, 5);
+        EXPECT_EQ(MemoryTracker::GetAllocators().size(), 0);
+        // Untracked allocators share their statistics, but not their name and size
+        EXPECT_EQ(stackAllocator.GetTotalSize(), 10_MB);
+        EXPECT_EQ(otherAllocator.GetTotalSize(), 1_MB);
+        EXPECT_EQ(stackAllocator.GetDebugName(), "Untracked");
+        EXPECT_EQ(otherAllocator.GetDebugName(), "OtherUntracked");
+    }
+
+    EXPECT_EQ(MemoryTracker::GetAllocators().size(), 0);
+}
+
+TEST_F(MemoryTrackerTest, Categories)
+{
+    const CategoryId rendering = Category<"Testing/Rendering">{};
+    const CategoryId audio     = Category<"Testing/Audio">{};
+
+    EXPECT_NE(rendering, audio);
+    EXPECT_NE(rendering, noCategory);
+    EXPECT_EQ(CategoryRegistry::GetName(rendering), "Testing/Rendering");
+    EXPECT_EQ(CategoryRegistry::GetName(noCategory), "");
+
+    // Names registered at runtime are interned into the same table as the tags
+    EXPECT_EQ(CategoryRegistry::Register("Testing/Rendering"), rendering);
+    EXPECT_EQ(CategoryRegistry::GetName(CategoryRegistry::Register("Testing/Physics")), "Testing/Physics");
+}
+
+TEST_F(MemoryTrackerTest, AllocationEventLogWrapsAround)
+{
+    AllocationEventLog log{8};
+    EXPECT_TRUE(log.GetEvents().empty());
+
+    for (Size i = 0; i < 20; i++)
+    {
+        log.Record(i, unknownCallSite, noCategory);
+    }
+
+    const std::vector<AllocationEvent> events = log.GetEvents();
+    EXPECT_EQ(log.GetRecordedCount(), 20);
+    ASSERT_EQ(events.size(), 8);
+    for (Size i = 0; i < events.size(); i++)
+    {
+        EXPECT_EQ(events[i].size, 12 + i);
+    }
+    EXPECT_LE(events.front().timestamp, events.back().timestamp);
+}
+
+TEST_F(MemoryTrackerTest, AllocationEventLogMultithreaded)
+{
+    AllocationEventLog log{1024};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([&log]() {
+            for (int i = 0; i < 256; i++)
+            {
+                log.Record(8, unknownCallSite, noCategory);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    const std::vector<AllocationEvent> events = log.GetEvents();
+    EXPECT_EQ(events.size(), 1024);
+    EXPECT_TRUE(std::ranges::all_of(events, [](const AllocationEvent& event) { return event.size == 8; }));
+}
+
+TEST_F(MemoryTrackerTest, AllocationEventLogReadWhileRecording)
+{
+    AllocationEventLog log{64};
+
+    std::atomic<bool>        isRecording = true;
+    std::vector<std::thread> threads;
+    for (UInt16 t = 1; t <= 4; t++)
+    {
+        threads.emplace_back([&log, &isRecording, t]() {
+            while (isRecording.load(std::memory_order_relaxed))
+            {
+                log.Record(t, CallSiteId{t}, CategoryId{t});
+            }
+        });
+    }
+
+    // Slots that are claimed but not written yet, or torn by another writer, must be skipped
+    for (int i = 0; i < 1000; i++)
+    {
+        for (const AllocationEvent& event : log.GetEvents())
+        {
+            EXPECT_NE(event.timestamp, 0);
+            EXPECT_EQ(event.size, event.callSite.value);
+            EXPECT_EQ(event.size, event.category.value);
+        }
+    }
+
+    isRecording = false;
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+TEST_F(MemoryTrackerTest, CallSites)
+{
+    constexpr StackAllocatorSettings settings = {.policy = StackAllocatorPolicy::Default | StackAllocatorPolicy::AllocationTracking};
+    StackAllocator<settings>         stackAllocator{10_KB};
+
+    const SourceLocation location = SourceLocation::current();
+    for (int i = 0; i < 2; i++)
+    {
+        void* ptr = stackAllocator.Allocate(8, defaultAlignment, noCategory, location);
+        stackAllocator.Deallocate(ptr);
+    }
+
+    const std::vector<AllocationEvent> events = stackAllocator.GetAllocations();
+    ASSERT_EQ(events.size(), 2);
+    EXPECT_EQ(events[0].callSite, events[1].callSite);
+    EXPECT_NE(events[0].callSite, unknownCallSite);
+
+    const CallSite callSite = CallSiteRegistry::Get(events[0].callSite);
+    EXPECT_EQ(callSite.line, location.line());
+    EXPECT_STREQ(callSite.fileName, location.file_name());
+}
+
+TEST_F(MemoryTrackerTest, StatisticsPeakUsedSize)
+{
+    AllocatorStatistics statistics;
+
+    statistics.IncreaseUsedSize(100);
+    statistics.IncreaseUsedSize(50);
+    statistics.DecreaseUsedSize(120);
+    statistics.IncreaseUsedSize(40);
+
+    EXPECT_EQ(statistics.GetUsedSize(), 70);
+    EXPECT_EQ(statistics.GetPeakUsedSize(), 150);
+
+    statistics.SetUsedSize(400);
+    statistics.SetUsedSize(10);
+    EXPECT_EQ(statistics.GetUsedSize(), 10);
+    EXPECT_EQ(statistics.GetPeakUsedSize(), 400);
+}
+
+TEST_F(MemoryTrackerTest, StatisticsPeakUsedSizeAcrossShards)
+{
+    AllocatorStatistics statistics;
+
+    // Each thread writes to its own shard, and the peak is derived from their high and low waters
+    for (Size t = 0; t < 4; t++)
+    {
+        std::thread([&statistics, t]() {
+            statistics.IncreaseUsedSize(100 + t * 10);
+            statistics.DecreaseUsedSize(100 + t * 10);
+        }).join();
+    }
+
+    EXPECT_EQ(statistics.GetUsedSize(), 0);
+    EXPECT_EQ(statistics.GetPeakUsedSize(), 130);
+}
+
+TEST_F(MemoryTrackerTest, StatisticsMultithreaded)
+{
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Default | MallocatorPolicy::Multithreaded |
+                                                       MallocatorPolicy::AllocationTracking};
+    Mallocator<settings>         mallocator{};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++)
+    {
+        threads.emplace_back([&mallocator]() {
+            for (int i = 0; i < 1000; i++)
+            {
+                int* num = mallocator.NewRaw<int>(i);
+                mallocator.Delete(num);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(mallocator.GetAllocationCount(), 8000);
+    EXPECT_EQ(mallocator.GetDeallocationCount(), 8000);
+    EXPECT_EQ(mallocator.GetUsedSize(), 0);
+    EXPECT_EQ(mallocator.GetTotalSize(), 0);
+    EXPECT_GE(mallocator.GetPeakUsedSize(), sizeof(int));
+}
+
+TEST_F(MemoryTrackerTest, TotalAllocatedSize)
+{
+    constexpr MallocatorSettings settings = {.policy = MallocatorPolicy::Debug};
+    Mallocator<settings>         mallocator{};
+    EXPECT_EQ(MemoryTracker::GetTotalAllocatedSize(), 0);
+
+    int* num = mallocator.NewRaw<int>(5);
+    EXPECT_EQ(MemoryTracker::GetTotalAllocatedSize(), mallocator.GetTotalSize());
+    EXPECT_GE(MemoryTracker::GetTotalAllocatedSize(), sizeof(int));
+
+    mallocator.Delete(num);
+    EXPECT_EQ(MemoryTracker::GetTotalAllocatedSize(), 0);
+}
+
+TEST_F(MemoryTrackerTest, ConcurrentRegistration)
+{
+    std::atomic<bool> done = false;
+    std::thread       poller([&done]() {
+        while (!done)
+        {
+            Size allocatorCount = 0;
+            MemoryTracker::ForEachAllocator([&allocatorCount](const AllocatorData& allocatorData) {
+                EXPECT_EQ(allocatorData.debugName, "StackAllocator");
+                allocatorCount++;
+            });
+            EXPECT_LE(allocatorCount, 4);
+            EXPECT_LE(MemoryTracker::GetAllocators().size(), 4);
+        }
+    });
+
+    for (int i = 0; i < 200; i++)
+    {
+        std::vector<std::unique_ptr<StackAllocator<>>> stackAllocators;
+        for (int j = 0; j < 4; j++)
+        {
+            stackAllocators.push_back(std::make_unique<StackAllocator<>>(1_KB));
+        }
+    }
+
+    done = true;
+    poller.join();
+
+    EXPECT_TRUE(MemoryTracker::GetAllocators().empty());
+}
+
+TEST_F(MemoryTrackerTest, AllocatorTree)
+{
+    constexpr MallocatorSettings      mallocatorSettings = {.policy = MallocatorPolicy::Debug};
+    constexpr StackAllocatorSettings  stackSettings      = {.policy = StackAllocatorPolicy::Debug};
+    constexpr LinearAllocatorSettings linearSettings     = {.policy = LinearAllocatorPolicy::Debug};
+    using TreeMallocator                                 = Mallocator<mallocatorSettings>;
+
+    auto                                            mallocator = std::make_shared<TreeMallocator>("TreeMallocator");
+    StackAllocator<stackSettings>                   stackAllocator{1_KB, "TreeStackAllocator", mallocator};
+    LinearAllocator<linearSettings, TreeMallocator> linearAllocator{2_KB, "TreeLinearAllocator", *mallocator};
+
+    int* num    = stackAllocator.NewRaw<int>(5);
+    int* values = linearAllocator.NewArrayRaw<int>(10);
+
+    EXPECT_EQ(stackAllocator.GetParentId(), mallocator->GetId());
+
+    const std::vector<AllocatorTreeNode> tree = MemoryTracker::GetAllocatorTree();
+    ASSERT_EQ(tree.size(), 1);
+
+    const AllocatorTreeNode& root = tree[0];
+    EXPECT_EQ(root.allocatorData->debugName, "TreeMallocator");
+    ASSERT_EQ(root.children.size(), 2);
+    EXPECT_EQ(root.children[0].allocatorData->debugName, "TreeStackAllocator");
+    EXPECT_EQ(root.children[1].allocatorData->debugName, "TreeLinearAllocator");
+    EXPECT_EQ(root.children[0].allocatorData->parentId, mallocator->GetId());
+
+    EXPECT_EQ(root.totalSize, 3_KB);
+    EXPECT_EQ(root.usedSize, stackAllocator.GetUsedSize() + linearAllocator.GetUsedSize());
+    EXPECT_EQ(root.children[1].usedSize, linearAllocator.GetUsedSize());
+    EXPECT_EQ(root.peakUsedSize, 3_KB);
+
+    stackAllocator.Delete(num);
+    EXPECT_NE(values, nullptr);
+}
+
+TEST_F(MemoryTrackerTest, HistogramBuckets)
+{
+    static_assert(SizeHistogram::GetBucketIndex(3) == 3);
+    static_assert(SizeHistogram::GetBucketIndex(4) == 4);
+    static_assert(SizeHistogram::GetBucketIndex(7) == 7);
+    static_assert(SizeHistogram::GetBucketIndex(8) == 8);
+    static_assert(SizeHistogram::GetBucketIndex(9) == 8);
+    static_assert(SizeHistogram::GetBucketIndex(10) == 9);
+
+    for (Size size = 0; size < 100000; size++)
+    {
+        const Size index = SizeHistogram::GetBucketIndex(size);
+        ASSERT_LE(SizeHistogram::GetBucketLowerBound(index), size);
+        ASSERT_GE(SizeHistogram::GetBucketUpperBound(index), size);
+    }
+
+    SizeHistogram histogram;
+    EXPECT_TRUE(histogram.GetBuckets().empty());
+
+    histogram.Record(24);
+    histogram.Record(25);
+    histogram.Record(4096);
+
+    const std::vector<HistogramBucket> buckets = histogram.GetBuckets();
+    ASSERT_EQ(buckets.size(), 2);
+    EXPECT_EQ(buckets[0].lowerBound, 24);
+    EXPECT_EQ(buckets[0].upperBound, 27);
+    EXPECT_EQ(buckets[0].count, 2);
+    EXPECT_EQ(buckets[1].lowerBound, 4096);
+    EXPECT_EQ(buckets[1].upperBound, 5119);
+    EXPECT_EQ(histogram.GetTotalCount(), 3);
+}
+
+TEST_F(MemoryTrackerTest, SizeHistogram)
+{
+    constexpr StackAllocatorSettings settings = {.policy = StackAllocatorPolicy::Release | StackAllocatorPolicy::SizeHistogram};
+    StackAllocator<settings>         stackAllocator{10_KB};
+
+    for (Size size : {8, 8, 100, 1000})
+    {
+        EXPECT_NE(stackAllocator.Allocate(size), nullptr);
+    }
+
+    const std::vector<HistogramBucket> buckets = stackAllocator.GetSizeHistogram();
+    ASSERT_EQ(buckets.size(), 3);
+    EXPECT_EQ(buckets[0].lowerBound, 8);
+    EXPECT_EQ(buckets[0].count, 2);
+    EXPECT_EQ(buckets[1].lowerBound, 96);
+    EXPECT_EQ(buckets[2].lowerBound, 896);
+
+    const std::vector<HistogramBucket> trackerBuckets = MemoryTracker::GetSizeHistogram();
+    ASSERT_EQ(trackerBuckets.size(), 3);
+    EXPECT_EQ(trackerBuckets[0].count, 2);
+}
+
+TEST_F(MemoryTrackerTest, LatencyTracking)
+{
+    constexpr PoolAllocatorSettings settings = {.policy = PoolAllocatorPolicy::Debug | PoolAllocatorPolicy::Growable |
+                                                          PoolAllocatorPolicy::LatencyTracking};
+    PoolAllocator<settings>         poolAllocator{sizeof(UInt64), 10};
+
+    std::vector<UInt64*> ptrs;
+    for (int i = 0; i < 100; i++)
+    {
+        ptrs.push_back(poolAllocator.NewRaw<UInt64>(i));
+    }
+    for (UInt64* ptr : ptrs)
+    {
+        poolAllocator.Delete(ptr);
+    }
+
+    const LatencyPercentiles allocate = poolAllocator.GetLatencyPercentiles(LatencyOperation::Allocate);
+    EXPECT_EQ(allocate.count, 100);
+    EXPECT_LE(allocate.p50, allocate.p99);
+    EXPECT_LE(allocate.p99, allocate.p999);
+    EXPECT_LE(allocate.p999, allocate.max);
+
+    EXPECT_EQ(poolAllocator.GetLatencyPercentiles(LatencyOperation::Deallocate).count, 100);
+    // The first block is allocated by the constructor
+    EXPECT_EQ(poolAllocator.GetLatencyPercentiles(LatencyOperation::BlockRefill).count, 10);
+
+    EXPECT_EQ(MemoryTracker::GetLatencyPercentiles(LatencyOperation::Allocate).count, 100);
+}
+
+TEST_F(MemoryTrackerTest, WasteMetrics)
+{
+    constexpr StackAllocatorSettings stackSettings = {.policy = StackAllocatorPolicy::Debug | StackAllocatorPolicy::WasteTracking};
+    StackAllocator<stackSettings>    stackAllocator{10_KB};
+
+    void* ptr1 = stackAllocator.Allocate(10, 8);
+    void* ptr2 = stackAllocator.Allocate(100, 64);
+
+    // Everything the stack hands out beyond the requested sizes is padding, headers and bound guards
+    const WasteMetrics stackMetrics = stackAllocator.GetWasteMetrics();
+    EXPECT_GT(stackMetrics.paddingSize, 0);
+    EXPECT_GT(stackMetrics.headerSize, 0);
+    EXPECT_EQ(stackMetrics.paddingSize + stackMetrics.headerSize + 110, stackAllocator.GetUsedSize());
+    EXPECT_EQ(stackMetrics.freeSize, 10_KB - stackAllocator.GetUsedSize());
+    EXPECT_EQ(stackMetrics.GetFragmentationScore(), 1.0);
+
+    constexpr LinearAllocatorSettings linearSettings = {.policy = LinearAllocatorPolicy::Debug | LinearAllocatorPolicy::Growable |
+                                                                  LinearAllocatorPolicy::WasteTracking};
+    LinearAllocator<linearSettings>   linearAllocator{100};
+
+    EXPECT_NE(linearAllocator.Allocate(60, 4), nullptr);
+    EXPECT_NE(linearAllocator.Allocate(60, 4), nullptr);
+    EXPECT_EQ(linearAllocator.GetWasteMetrics().tailWasteSize, 40);
+    EXPECT_EQ(linearAllocator.GetWasteMetrics().freeSize, 40);
+
+    const WasteMetrics totalMetrics = MemoryTracker::GetWasteMetrics();
+    EXPECT_EQ(totalMetrics.headerSize, stackMetrics.headerSize);
+    EXPECT_EQ(totalMetrics.tailWasteSize, 40);
+    EXPECT_EQ(totalMetrics.freeSize, stackMetrics.freeSize + 40);
+    EXPECT_EQ(totalMetrics.largestFreeSize, stackMetrics.freeSize);
+
+    stackAllocator.Deallocate(ptr2);
+    stackAllocator.Deallocate(ptr1);
+    EXPECT_EQ(stackAllocator.GetWasteMetrics().paddingSize, 0);
+    EXPECT_EQ(stackAllocator.GetWasteMetrics().headerSize, 0);
+
+    linearAllocator.Release();
+    EXPECT_EQ(linearAllocator.GetWasteMetrics().tailWasteSize, 0);
+    EXPECT_EQ(linearAllocator.GetWasteMetrics().freeSize, 100);
+}
+
+TEST_F(MemoryTrackerTest, PoolFragmentation)
+{
+    constexpr PoolAllocatorSettings settings = {.policy = PoolAllocatorPolicy::Debug | PoolAllocatorPolicy::WasteTracking};
+    PoolAllocator<settings>         poolAllocator{sizeof(UInt64), 10};
+
+    poolAllocator.UpdateFragmentationMetrics();
+    EXPECT_EQ(poolAllocator.GetWasteMetrics().freeSize, 10 * sizeof(UInt64));
+    EXPECT_EQ(poolAllocator.GetWasteMetrics().GetFragmentationScore(), 1.0);
+
+    std::vector<UInt64*> ptrs;
+    for (int i = 0; i < 10; i++)
+    {
+        ptrs.push_back(poolAllocator.NewRaw<UInt64>(i));
+    }
+    // Free every other object, so no two free chunks are next to each other
+    for (int i = 0; i < 10; i += 2)
+    {
+        poolAllocator.Delete(ptrs[i]);
+    }
+
+    poolAllocator.UpdateFragmentationMetrics();
+    const WasteMetrics metrics = poolAllocator.GetWasteMetrics();
+    EXPECT_EQ(metrics.freeSize, 5 * sizeof(UInt64));
+    EXPECT_EQ(metrics.largestFreeSize, sizeof(UInt64));
+    EXPECT_DOUBLE_EQ(metrics.GetFragmentationScore(), 0.2);
+}
+
+TEST_F(MemoryTrackerTest, WriteSnapshot)
+{
+    constexpr MallocatorSettings     mallocatorSettings = {.policy = MallocatorPolicy::Debug};
+    constexpr StackAllocatorSettings stackSettings      = {.policy = StackAllocatorPolicy::Debug};
+
+    auto                          mallocator = std::make_shared<Mallocator<mallocatorSettings>>("SnapshotMallocator");
+    StackAllocator<stackSettings> stackAllocator{1_KB, "Snapshot \"Stack\"", mallocator};
+
+    void* ptr = stackAllocator.Allocate<int>(Category<"Testing/Snapshot">{});
+    stackAllocator.Deallocate(ptr);
+    int* other = stackAllocator.NewRaw<int>(6);
+
+    const std::filesystem::path jsonPath  = std::filesystem::temp_directory_path() / "MemarenaSnapshot.json";
+    const std::filesystem::path tracePath = std::filesystem::temp_directory_path() / "MemarenaSnapshotTrace.json";
+    ASSERT_TRUE(MemoryTracker::WriteSnapshot(jsonPath.string(), SnapshotFormat::Json));
+    ASSERT_TRUE(MemoryTracker::WriteSnapshot(tracePath.string(), SnapshotFormat::ChromeTrace));
+
+    const std::string json = ReadFile(jsonPath);
+    EXPECT_NE(json.find("\"name\":\"SnapshotMallocator\""), std::string::npos);
+    EXPECT_NE(json.find("\"children\":[\n{\"id\":" + std::to_string(stackAllocator.GetId().value)), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"Snapshot \\\"Stack\\\"\""), std::string::npos);
+    EXPECT_NE(json.find("\"fragmentationScore\":"), std::string::npos);
+
+    const std::string trace = ReadFile(tracePath);
+    EXPECT_NE(trace.find("\"traceEvents\":["), std::string::npos);
+    EXPECT_NE(trace.find("\"ph\":\"i\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"Deallocate\""), std::string::npos);
+    EXPECT_NE(trace.find("\"cat\":\"Testing/Snapshot\""), std::string::npos);
+    EXPECT_NE(trace.find("\"ph\":\"C\""), std::string::npos);
+
+    EXPECT_FALSE(MemoryTracker::WriteSnapshot((std::filesystem::temp_directory_path() / "Missing" / "Snapshot.json").string(),
+                                              SnapshotFormat::Json));
+
+    std::filesystem::remove(jsonPath);
+    std::filesystem::remove(tracePath);
+    stackAllocator.Delete(other);
+}
+
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <filesystem>
 #include <iostream>
 #include <memory>
 #include <memory_resource>
@@ -297,22 +300,72 @@ TEST_F(PoolAllocatorTest, MemoryTracker)
 
     PoolAllocator<settings> poolAllocator{sizeof(Int64), 1000};
 
-    Int64* num = static_cast<Int64*>(poolAllocator.Allocate("Testing/PoolAllocator"));
+    Int64* num = static_cast<Int64*>(poolAllocator.Allocate(Category<"Testing/PoolAllocator">{}));
 
     const AllocatorVector allocators = MemoryTracker::GetAllocators();
 
     EXPECT_EQ(allocators.size(), 1);
     if (allocators.size() > 0)
     {
-        EXPECT_EQ(allocators[0]->totalSize, sizeof(Int64) * 1000);
-        EXPECT_EQ(allocators[0]->usedSize, sizeof(Int64));
-        EXPECT_EQ(allocators[0]->allocationCount, 1);
-        EXPECT_EQ(allocators[0]->deallocationCount, 0);
-        EXPECT_EQ(allocators[0]->allocations[0].category, std::string("Testing/PoolAllocator"));
-        EXPECT_EQ(allocators[0]->allocations[0].size, sizeof(Int64));
+        EXPECT_EQ(allocators[0]->statistics.GetTotalSize(), sizeof(Int64) * 1000);
+        EXPECT_EQ(allocators[0]->statistics.GetUsedSize(), sizeof(Int64));
+        EXPECT_EQ(allocators[0]->statistics.GetAllocationCount(), 1);
+        EXPECT_EQ(allocators[0]->statistics.GetDeallocationCount(), 0);
+        EXPECT_EQ(CategoryRegistry::GetName(allocators[0]->allocationEvents.GetEvents()[0].category), "Testing/PoolAllocator");
+        EXPECT_EQ(allocators[0]->allocationEvents.GetEvents()[0].size, sizeof(Int64));
     }
 }
 
+TEST_F(PoolAllocatorTest, Presized)
+{
+    constexpr PoolAllocatorSettings settings = {.policy = PoolAllocatorPolicy::Default | PoolAllocatorPolicy::Growable |
+                                                         PoolAllocatorPolicy::Presized};
+
+    const std::filesystem::path profilePath = std::filesystem::temp_directory_path() / "MemarenaPoolPresize.txt";
+    PresizeProfile::Clear();
+
+    {
+        PoolAllocator<settings> poolAllocator{sizeof(Int64), 4, "PresizedPoolAllocator"};
+        std::vector<void*>      ptrs;
+        for (Size i = 0; i < 10; i++)
+        {
+            ptrs.push_back(poolAllocator.Allocate());
+        }
+        EXPECT_EQ(poolAllocator.GetTotalSize(), sizeof(Int64) * 12);
+        for (void*& ptr : ptrs)
+        {
+            poolAllocator.Deallocate(ptr);
+        }
+    }
+    ASSERT_TRUE(PresizeProfile::Save(profilePath.string()));
+
+    // The peak was ten objects, so the next run reserves three blocks up front
+    PresizeProfile::Clear();
+    ASSERT_TRUE(PresizeProfile::Load(profilePath.string()));
+    std::filesystem::remove(profilePath);
+
+    PoolAllocator<settings> poolAllocator{sizeof(Int64), 4, "PresizedPoolAllocator"};
+    EXPECT_EQ(poolAllocator.GetTotalSize(), sizeof(Int64) * 12);
+    EXPECT_EQ(poolAllocator.GetUsedSize(), 0);
+    EXPECT_EQ(poolAllocator.GetPeakUsedSize(), 0);
+
+    std::vector<void*> ptrs;
+    for (Size i = 0; i < 12; i++)
+    {
+        ptrs.push_back(poolAllocator.Allocate());
+    }
+    EXPECT_EQ(poolAllocator.GetTotalSize(), sizeof(Int64) * 12);
+    EXPECT_EQ(poolAllocator.GetUsedSize(), sizeof(Int64) * 12);
+    std::ranges::sort(ptrs);
+    EXPECT_EQ(std::ranges::adjacent_find(ptrs), ptrs.end());
+
+    for (void*& ptr : ptrs)
+    {
+        poolAllocator.Deallocate(ptr);
+    }
+    PresizeProfile::Clear();
+}
+
 ALLOCATOR_DEBUG_TEST(GetUsedSizeNew, {
     const int numObjects = 10;
     for (size_t i = 0; i < numObjects; i++)
@@ -355,6 +408,123 @@ TEST_F(PoolAllocatorTest, DoubleFreePrevention)
     EXPECT_EQ(ptr3, nullptr);
 }
 
+TEST_F(PoolAllocatorTest, TemplatedBaseAllocator)
+{
+    constexpr MallocatorSettings      mallocatorSettings = {.policy = MallocatorPolicy::Default};
+    constexpr LinearAllocatorSettings linearSettings     = {.policy = LinearAllocatorPolicy::Default | LinearAllocatorPolicy::Growable};
+    constexpr PoolAllocatorSettings   settings           = {.policy = PoolAllocatorPolicy::Default | PoolAllocatorPolicy::Growable};
+
+    using BaseAllocator   = Mallocator<mallocatorSettings>;
+    using MiddleAllocator = LinearAllocator<linearSettings, BaseAllocator>;
+
+    BaseAllocator                            mallocator{"Mallocator"};
+    MiddleAllocator                          linearAllocator{1_KiB, "LinearAllocator", mallocator};
+    PoolAllocator<settings, MiddleAllocator> poolAllocator{sizeof(TestObject), 10, "PoolAllocator", linearAllocator};
+
+    std::vector<PoolPtr<TestObject>> objects;
+    for (int i = 0; i < 100; i++)
+    {
+        objects.push_back(poolAllocator.New<TestObject>(i, 1.5F, 'a', false, 2.5F));
+    }
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ(*objects[i], TestObject(i, 1.5F, 'a', false, 2.5F));
+    }
+
+    EXPECT_EQ(poolAllocator.GetTotalSize(), 10 * 10 * sizeof(TestObject));
+    EXPECT_GE(linearAllocator.GetUsedSize(), poolAllocator.GetTotalSize());
+    EXPECT_EQ(mallocator.GetTotalSize(), linearAllocator.GetTotalSize());
+
+    for (auto& object : objects)
+    {
+        poolAllocator.Delete(object);
+    }
+    EXPECT_EQ(poolAllocator.GetUsedSize(), 0);
+}
+
+TEST_F(PoolAllocatorTest, StackBaseAllocator)
+{
+    constexpr StackAllocatorSettings stackSettings = {.policy = StackAllocatorPolicy::Debug};
+    constexpr PoolAllocatorSettings  settings      = {.policy = PoolAllocatorPolicy::Default | PoolAllocatorPolicy::Growable};
+
+    using BaseAllocator = StackAllocator<stackSettings>;
+
+    BaseAllocator stackAllocator{1_KiB, "StackAllocator"};
+    {
+        PoolAllocator<settings, BaseAllocator> poolAllocator{16, 4, "PoolAllocator", stackAllocator};
+        for (int i = 0; i < 10; i++)
+        {
+            EXPECT_NE(poolAllocator.Allocate(), nullptr);
+        }
+        EXPECT_GT(stackAllocator.GetUsedSize(), 0);
+    }
+    // The blocks have to be returned in the reverse order of their allocation
+    EXPECT_EQ(stackAllocator.GetUsedSize(), 0);
+}
+
+TEST_F(PoolAllocatorTest, StackBaseAllocatorOutOfMemory)
+{
+    constexpr StackAllocatorSettings stackSettings = {
+        .policy = StackAllocatorPolicy::Debug, .breakOnFailureIsEnabled = false, .failureLoggingIsEnabled = false};
+    constexpr PoolAllocatorSettings settings = {.policy                  = PoolAllocatorPolicy::Default | PoolAllocatorPolicy::Growable,
+                                                .breakOnFailureIsEnabled = false,
+                                                .failureLoggingIsEnabled = false};
+
+    using BaseAllocator = StackAllocator<stackSettings>;
+
+    BaseAllocator stackAllocator{256, "StackAllocator"};
+    {
+        PoolAllocator<settings, BaseAllocator> poolAllocator{16, 4, "PoolAllocator", stackAllocator};
+        std::vector<void*>                     objects;
+        while (void* object = poolAllocator.Allocate())
+        {
+            objects.push_back(object);
+        }
+        // Only the blocks the stack had room for are used
+        EXPECT_GT(objects.size(), 0);
+        EXPECT_LT(objects.size(), 256 / 16);
+        EXPECT_EQ(objects.size() % 4, 0);
+        using Object = std::array<char, 16>;
+        EXPECT_EQ(poolAllocator.NewArray<Object>(2).GetPtr(), nullptr);
+
+        // The pool keeps working with the blocks it has
+        void* lastObject = objects.back();
+        poolAllocator.Deallocate(objects.back());
+        EXPECT_EQ(poolAllocator.Allocate(), lastObject);
+    }
+    EXPECT_EQ(stackAllocator.GetUsedSize(), 0);
+
+    // Not even the first block fits
+    BaseAllocator smallStackAllocator{32, "SmallStackAllocator"};
+    {
+        PoolAllocator<settings, BaseAllocator> poolAllocator{16, 4, "PoolAllocator", smallStackAllocator};
+        EXPECT_EQ(poolAllocator.Allocate(), nullptr);
+        EXPECT_EQ(poolAllocator.Allocate(), nullptr);
+    }
+    EXPECT_EQ(smallStackAllocator.GetUsedSize(), 0);
+}
+
+TEST_F(PoolAllocatorTest, LargeAlignment)
+{
+    constexpr PoolAllocatorSettings settings = {.policy = PoolAllocatorPolicy::Default | PoolAllocatorPolicy::Growable,
+                                                .blockAlignment = 4_KiB};
+    PoolAllocator<settings>         poolAllocator{4_KiB, 4};
+
+    // Page sized objects in a page aligned block are all page aligned
+    std::vector<void*> pages;
+    for (int i = 0; i < 10; i++)
+    {
+        pages.push_back(poolAllocator.Allocate());
+        EXPECT_EQ(std::bit_cast<UIntPtr>(pages.back()) % 4_KiB, 0);
+    }
+
+    for (void*& page : pages)
+    {
+        poolAllocator.Deallocate(page);
+    }
+    EXPECT_EQ(poolAllocator.GetUsedSize(), 0);
+}
+
 #ifdef MEMARENA_ENABLE_ASSERTS
 
 class PoolAllocatorDeathTest : public ::testing::Test
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+
+#include <Memarena/Memarena.hpp>
+
+#include "Source/SharedStatistics.hpp"
+
+using namespace Memarena;
+using namespace Memarena::SizeLiterals;
+
+class SharedStatisticsTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override { MemoryTracker::Reset(); }
+    void TearDown() override {}
+};
+
+TEST_F(SharedStatisticsTest, PublishStatistics)
+{
+    constexpr StackAllocatorSettings settings = {.policy = StackAllocatorPolicy::Debug};
+    const std::string                name     = "/MemarenaTestStatistics";
+
+    StackAllocator<settings> stackAllocator{1_KB, "PublishedStack"};
+    int*                     first = stackAllocator.NewRaw<int>(1);
+
+    // The interval is long enough that only the explicit publishes happen during the test
+    ASSERT_TRUE(MemoryTracker::StartPublishing(name, std::chrono::hours(1), 1));
+    EXPECT_FALSE(MemoryTracker::StartPublishing(name));
+
+    SharedStatisticsReader   reader;
+    SharedStatisticsSnapshot snapshot;
+    ASSERT_TRUE(reader.Open(name));
+    ASSERT_TRUE(reader.Read(snapshot));
+    ASSERT_EQ(snapshot.allocators.size(), 1);
+    EXPECT_EQ(std::string(snapshot.allocators[0].debugName.data()), "PublishedStack");
+    EXPECT_EQ(snapshot.allocators[0].id, stackAllocator.GetId().value);
+    EXPECT_EQ(snapshot.allocators[0].totalSize, 1_KB);
+    EXPECT_EQ(snapshot.allocators[0].allocationCount, 1);
+
+    // Allocators beyond the capacity are counted, but not published
+    StackAllocator<settings> otherAllocator{1_KB, "OtherStack"};
+    int*                     second = stackAllocator.NewRaw<int>(2);
+    MemoryTracker::PublishStatistics();
+
+    const UInt64 sequence = snapshot.sequence;
+    ASSERT_TRUE(reader.Read(snapshot));
+    EXPECT_GT(snapshot.sequence, sequence);
+    EXPECT_EQ(snapshot.sequence % 2, 0);
+    EXPECT_EQ(snapshot.omittedCount, 1);
+    ASSERT_EQ(snapshot.allocators.size(), 1);
+    EXPECT_EQ(snapshot.allocators[0].allocationCount, 2);
+    EXPECT_EQ(snapshot.allocators[0].usedSize, stackAllocator.GetUsedSize());
+
+    MemoryTracker::StopPublishing();
+    EXPECT_FALSE(SharedStatisticsReader().Open(name));
+    EXPECT_TRUE(reader.Read(snapshot));
+
+    stackAllocator.Delete(second);
+    stackAllocator.Delete(first);
+}
@@ -10,6 +10,7 @@
 #include "Source/AllocatorData.hpp"
 #include "Source/Allocators/StackAllocator/StackAllocator.hpp"
 #include "Source/Policies/Policies.hpp"
+#include "Source/Utility/VirtualMemory.hpp"
 
 using namespace Memarena;
 using namespace Memarena::SizeLiterals;
@@ -455,27 +456,27 @@ TEST_F(StackAllocatorTest, MemoryTracker)
     constexpr StackAllocatorSettings settings = {.policy = StackAllocatorPolicy::Debug};
     StackAllocator<settings>         stackAllocator{1_MB};
 
-    int* num = static_cast<int*>(stackAllocator.Allocate<int>("Testing/StackAllocator"));
+    int* num = static_cast<int*>(stackAllocator.Allocate<int>(Category<"Testing/StackAllocator">{}));
 
     const AllocatorVector allocators = MemoryTracker::GetAllocators();
 
-    const Size size = sizeof(int) + sizeof(Internal::StackHeader) + sizeof(BoundGuardFront) + sizeof(BoundGuardBack);
+    const Size size = sizeof(int) + sizeof(Internal::StackHeader<>) + sizeof(BoundGuardFront<>) + sizeof(BoundGuardBack<>);
 
     EXPECT_EQ(allocators.size(), 1);
     if (allocators.size() > 0)
     {
-        EXPECT_EQ(allocators[0]->totalSize, 1_MB);
-        EXPECT_EQ(allocators[0]->usedSize, size);
-        EXPECT_EQ(allocators[0]->allocationCount, 1);
-        EXPECT_EQ(allocators[0]->deallocationCount, 0);
-        EXPECT_EQ(allocators[0]->allocations[0].category, std::string("Testing/StackAllocator"));
-        EXPECT_EQ(allocators[0]->allocations[0].size, sizeof(int));
+        EXPECT_EQ(allocators[0]->statistics.GetTotalSize(), 1_MB);
+        EXPECT_EQ(allocators[0]->statistics.GetUsedSize(), size);
+        EXPECT_EQ(allocators[0]->statistics.GetAllocationCount(), 1);
+        EXPECT_EQ(allocators[0]->statistics.GetDeallocationCount(), 0);
+        EXPECT_EQ(CategoryRegistry::GetName(allocators[0]->allocationEvents.GetEvents()[0].category), "Testing/StackAllocator");
+        EXPECT_EQ(allocators[0]->allocationEvents.GetEvents()[0].size, sizeof(int));
     }
 }
 
 ALLOCATOR_DEBUG_TEST(DefaultBaseAllocator, {
-    int* num = static_cast<int*>(stackAllocator.Allocate<int>("Testing/StackAllocator"));
-    EXPECT_EQ(Allocator::GetDefaultAllocator()->GetTotalSize(), 1_MB);
+    int* num = static_cast<int*>(stackAllocator.Allocate<int>(Category<"Testing/StackAllocator">{}));
+    EXPECT_GE(Allocator::GetDefaultAllocator()->GetTotalSize(), 1_MB);
 })
 
 TEST_F(StackAllocatorTest, CustomBaseAllocator)
@@ -486,10 +487,80 @@ TEST_F(StackAllocatorTest, CustomBaseAllocator)
     constexpr StackAllocatorSettings settings = {.policy = StackAllocatorPolicy::Default};
     StackAllocator<settings>         stackAllocator{1_MB, "TestAllocator", baseAllocator};
 
-    int* num = static_cast<int*>(stackAllocator.Allocate<int>("Testing/StackAllocator"));
+    int* num = static_cast<int*>(stackAllocator.Allocate<int>(Category<"Testing/StackAllocator">{}));
     EXPECT_EQ(baseAllocator->GetTotalSize(), 1_MB);
 }
 
+TEST_F(StackAllocatorTest, LargeOffsets)
+{
+    constexpr MallocatorSettings     mallocatorSettings = {.policy = MallocatorPolicy::Default | MallocatorPolicy::DirectMap};
+    constexpr StackAllocatorSettings settings           = {.policy = StackAllocatorPolicy::Default | StackAllocatorPolicy::LargeOffsets};
+
+    using BaseAllocator = Mallocator<mallocatorSettings>;
+
+    static_assert(sizeof(StackAllocator<settings, BaseAllocator>::OffsetType) == sizeof(UInt64));
+
+    // The mapping is never touched outside of the pages we write to, but the OS may still refuse to reserve it
+    void* probe = MapMemory(5_GiB);
+    if (probe == nullptr)
+    {
+        GTEST_SKIP() << "Could not map 5 GiB of address space";
+    }
+    UnmapMemory(probe, 5_GiB);
+
+    BaseAllocator                           baseAllocator{"Mallocator", 1_MiB};
+    StackAllocator<settings, BaseAllocator> stackAllocator{5_GiB, "TestAllocator", baseAllocator};
+
+    void* filler = stackAllocator.Allocate(4_GiB + 1_MiB);
+    ASSERT_NE(filler, nullptr);
+
+    auto object = stackAllocator.New<TestObject>(1, 1.5F, 'a', false, 2.5F);
+    EXPECT_EQ(*object, TestObject(1, 1.5F, 'a', false, 2.5F));
+    EXPECT_GT(object.GetHeader().startOffset, std::numeric_limits<Offset>::max());
+    EXPECT_GT(stackAllocator.GetUsedSize(), 4_GiB);
+
+    stackAllocator.Delete(object);
+    stackAllocator.Deallocate(filler);
+    EXPECT_EQ(stackAllocator.GetUsedSize(), 0);
+}
+
+TEST_F(StackAllocatorTest, TemplatedBaseAllocator)
+{
+    constexpr MallocatorSettings   mallocatorSettings = {.policy = MallocatorPolicy::Default};
+    Mallocator<mallocatorSettings> baseAllocator{"Mallocator"};
+
+    constexpr StackAllocatorSettings                         settings = {.policy = StackAllocatorPolicy::Default};
+    StackAllocator<settings, Mallocator<mallocatorSettings>> stackAllocator{1_MB, "TestAllocator", baseAllocator};
+
+    StackPtr<TestObject> object = stackAllocator.New<TestObject>(1, 1.5F, 'a', false, 2.5F);
+    EXPECT_EQ(*object, TestObject(1, 1.5F, 'a', false, 2.5F));
+    EXPECT_EQ(baseAllocator.GetTotalSize(), 1_MB);
+    stackAllocator.Delete(object);
+}
+
+TEST_F(StackAllocatorTest, LargeAlignment)
+{
+    struct alignas(4_KiB) Page
+    {
+        Byte data[4_KiB];
+    };
+
+    constexpr StackAllocatorSettings settings = {.policy = StackAllocatorPolicy::Default, .blockAlignment = 4_KiB};
+    StackAllocator<settings>         stackAllocator{1_MB};
+
+    // The block is page aligned, so the first page needs no padding
+    StackPtr<Page> page = stackAllocator.New<Page>();
+    EXPECT_EQ(std::bit_cast<UIntPtr>(page.GetPtr()) % 4_KiB, 0);
+    EXPECT_EQ(stackAllocator.GetUsedSize(), sizeof(Page));
+
+    void* ptr = stackAllocator.Allocate(100, 2_MiB / 4);
+    EXPECT_EQ(std::bit_cast<UIntPtr>(ptr) % (2_MiB / 4), 0);
+
+    stackAllocator.Deallocate(ptr);
+    stackAllocator.Delete(page);
+    EXPECT_EQ(stackAllocator.GetUsedSize(), 0);
+}
+
 TEST_F(StackAllocatorTest, DoubleFreePreventionDisabled)
 {
     constexpr StackAllocatorSettings settings = {.policy = StackAllocatorPolicy::Default & ~StackAllocatorPolicy::DoubleFreePrevention};
@@ -522,6 +593,30 @@ TEST_F(StackAllocatorTest, DoubleFreePrevention)
     EXPECT_EQ(ptr3, nullptr);
 }
 
+TEST_F(StackAllocatorTest, BoundsCheckOutOfMemory)
+{
+    constexpr StackAllocatorSettings settings = {.policy = StackAllocatorPolicy::BoundsCheck | StackAllocatorPolicy::SizeTracking,
+                                                 .breakOnFailureIsEnabled = false,
+                                                 .failureLoggingIsEnabled = false};
+    constexpr Size totalSize = 256;
+
+    StackAllocator<settings> stackAllocator{totalSize};
+
+    // The used size of an allocation includes its header and both guards
+    void*      ptr      = stackAllocator.Allocate(8);
+    const Size overhead = stackAllocator.GetUsedSize() - 8;
+    stackAllocator.Deallocate(ptr);
+
+    // The user's bytes would fit, but the back guard would be written past the end
+    EXPECT_EQ(stackAllocator.Allocate(totalSize - overhead + 1), nullptr);
+    EXPECT_EQ(stackAllocator.GetUsedSize(), 0);
+
+    ptr = stackAllocator.Allocate(totalSize - overhead);
+    EXPECT_NE(ptr, nullptr);
+    EXPECT_EQ(stackAllocator.GetUsedSize(), totalSize);
+    stackAllocator.Deallocate(ptr);
+}
+
 #ifdef MEMARENA_ENABLE_ASSERTS
 
 class StackAllocatorDeathTest : public ::testing::Test
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <vector>
+
+#include <Memarena/Memarena.hpp>
+
+using namespace Memarena;
+using namespace Memarena::SizeLiterals;
+
+class TraceRecorderTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override { MemoryTracker::Reset(); }
+    void TearDown() override {}
+};
+
+TEST_F(TraceRecorderTest, TraceRecording)
+{
+    constexpr PoolAllocatorSettings   poolSettings   = {.policy = PoolAllocatorPolicy::Release | PoolAllocatorPolicy::TraceRecording};
+    constexpr LinearAllocatorSettings linearSettings = {.policy = LinearAllocatorPolicy::Release | LinearAllocatorPolicy::TraceRecording};
+    PoolAllocator<poolSettings>       poolAllocator{64, 10};
+    LinearAllocator<linearSettings>   linearAllocator{1_KiB};
+
+    // Operations outside of the recording are not written
+    void* earlyPtr = poolAllocator.Allocate();
+
+    const std::filesystem::path tracePath = std::filesystem::temp_directory_path() / "MemarenaTrace.bin";
+    ASSERT_TRUE(TraceRecorder::Start(tracePath.string()));
+    EXPECT_FALSE(TraceRecorder::Start(tracePath.string()));
+
+    void* ptr = poolAllocator.Allocate();
+    EXPECT_NE(linearAllocator.Allocate(100, 32), nullptr);
+    poolAllocator.Deallocate(ptr);
+    poolAllocator.Deallocate(earlyPtr);
+    linearAllocator.Release();
+
+    ASSERT_TRUE(TraceRecorder::Stop());
+    EXPECT_FALSE(TraceRecorder::Stop());
+
+    void* latePtr = poolAllocator.Allocate();
+    poolAllocator.Deallocate(latePtr);
+
+    Trace trace;
+    ASSERT_TRUE(TraceRecorder::ReadTrace(tracePath.string(), trace));
+    std::filesystem::remove(tracePath);
+    const std::vector<TraceRecord>& records = trace.records;
+    ASSERT_EQ(records.size(), 4);
+
+    EXPECT_EQ(records[0].operation, TraceOperation::Allocate);
+    EXPECT_EQ(records[0].allocatorId, poolAllocator.GetId().value);
+    EXPECT_EQ(records[0].pointerId, 1);
+    EXPECT_EQ(records[0].size, 64);
+
+    EXPECT_EQ(records[1].operation, TraceOperation::Allocate);
+    EXPECT_EQ(records[1].allocatorId, linearAllocator.GetId().value);
+    EXPECT_EQ(records[1].pointerId, 2);
+    EXPECT_EQ(records[1].size, 100);
+    EXPECT_EQ(records[1].alignmentShift, 5);
+    EXPECT_NE(records[1].callSite, records[0].callSite);
+    ASSERT_LT(records[1].callSite, trace.callSites.size());
+    EXPECT_TRUE(trace.callSites[records[1].callSite].fileName.ends_with("TraceRecorderTest.cpp"));
+
+    EXPECT_EQ(records[2].operation, TraceOperation::Deallocate);
+    EXPECT_EQ(records[2].pointerId, 1);
+
+    EXPECT_EQ(records[3].operation, TraceOperation::Release);
+    EXPECT_EQ(records[3].allocatorId, linearAllocator.GetId().value);
+
+    for (Size i = 1; i < records.size(); i++)
+    {
+        EXPECT_GE(records[i].timestamp, records[i - 1].timestamp);
+        EXPECT_EQ(records[i].threadId, records[0].threadId);
+    }
+    EXPECT_FALSE(TraceRecorder::ReadTrace(tracePath.string(), trace));
+}
+
+TEST_F(TraceRecorderTest, ReadUnfinishedTrace)
+{
+    constexpr PoolAllocatorSettings settings = {.policy = PoolAllocatorPolicy::Release | PoolAllocatorPolicy::TraceRecording};
+    PoolAllocator<settings>         poolAllocator{64, 10};
+
+    const std::filesystem::path tracePath = std::filesystem::temp_directory_path() / "MemarenaUnfinishedTrace.bin";
+    ASSERT_TRUE(TraceRecorder::Start(tracePath.string()));
+
+    // More records than are buffered, so that a batch reaches the file while the recording is still running
+    constexpr Size recordCount = 5000;
+    for (Size i = 0; i < recordCount / 2; i++)
+    {
+        void* ptr = poolAllocator.Allocate();
+        poolAllocator.Deallocate(ptr);
+    }
+
+    // The header still has no record count, so the records are read up to the end of the file, without call sites
+    Trace trace;
+    ASSERT_TRUE(TraceRecorder::ReadTrace(tracePath.string(), trace));
+    EXPECT_TRUE(trace.callSites.empty());
+    ASSERT_FALSE(trace.records.empty());
+    EXPECT_LT(trace.records.size(), recordCount);
+    for (Size i = 0; i < trace.records.size(); i++)
+    {
+        EXPECT_EQ(trace.records[i].operation, i % 2 == 0 ? TraceOperation::Allocate : TraceOperation::Deallocate);
+        EXPECT_EQ(trace.records[i].pointerId, i / 2 + 1);
+    }
+
+    ASSERT_TRUE(TraceRecorder::Stop());
+    ASSERT_TRUE(TraceRecorder::ReadTrace(tracePath.string(), trace));
+    std::filesystem::remove(tracePath);
+    EXPECT_EQ(trace.records.size(), recordCount);
+    EXPECT_FALSE(trace.callSites.empty());
+}
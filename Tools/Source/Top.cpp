@@ -0,0 +1,178 @@
+// Attaches to the statistics that a process publishes with MemoryTracker::StartPublishing, and shows the used, total and
+// peak sizes and the allocation rate of each of its allocators, refreshed every interval. The rates are measured between
+// two consecutive publishes, so they are only shown from the second refresh on.
+//
+// Usage: memarena-top <pid|name> [--interval <ms>] [--count <refreshes>]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Source/SharedStatistics.hpp"
+
+using namespace Memarena;
+
+namespace
+{
+struct Options
+{
+    std::string               name;
+    std::chrono::milliseconds interval = std::chrono::milliseconds(1000);
+    Size                      count    = 0; // Refresh until the publisher goes away if 0
+};
+
+bool ParseOptions(const int argc, char** argv, Options& options)
+{
+    if (argc < 2)
+    {
+        return false;
+    }
+
+    // A name has to be given as it was published, a bare number is taken as a process id
+    const std::string target = argv[1];
+    const bool        isPid  = std::all_of(target.begin(), target.end(), [](const char c) { return c >= '0' && c <= '9'; });
+    options.name             = isPid ? SharedStatisticsReader::GetDefaultName(std::strtoull(target.c_str(), nullptr, 10)) : target;
+
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        const UInt64 value = std::strtoull(argv[i + 1], nullptr, 10);
+        if (std::strcmp(argv[i], "--interval") == 0 && value > 0)
+        {
+            options.interval = std::chrono::milliseconds(value);
+        }
+        else if (std::strcmp(argv[i], "--count") == 0)
+        {
+            options.count = value;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return argc % 2 == 0;
+}
+
+std::string FormatSize(const UInt64 size)
+{
+    constexpr const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+
+    double scaledSize = static_cast<double>(size);
+    Size   unit       = 0;
+    while (scaledSize >= 1024.0 && unit + 1 < std::size(units))
+    {
+        scaledSize /= 1024.0;
+        unit++;
+    }
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), unit == 0 ? "%.0f %s" : "%.1f %s", scaledSize, units[unit]);
+    return buffer;
+}
+
+void PrintSnapshot(const SharedStatisticsSnapshot& snapshot, const SharedStatisticsSnapshot& previous, const bool hasPrevious)
+{
+    std::unordered_map<UInt32, const SharedAllocatorStatistics*> previousAllocators;
+    for (const SharedAllocatorStatistics& allocator : previous.allocators)
+    {
+        previousAllocators[allocator.id] = &allocator;
+    }
+
+    const double elapsedSeconds = static_cast<double>(snapshot.publishTime - previous.publishTime) / 1e9;
+
+    std::vector<const SharedAllocatorStatistics*> allocators;
+    UInt64                                        usedSize  = 0;
+    UInt64                                        totalSize = 0;
+    for (const SharedAllocatorStatistics& allocator : snapshot.allocators)
+    {
+        allocators.push_back(&allocator);
+        usedSize += allocator.usedSize;
+        totalSize += allocator.totalSize;
+    }
+    std::ranges::sort(allocators, [](const SharedAllocatorStatistics* a, const SharedAllocatorStatistics* b) {
+        return a->usedSize != b->usedSize ? a->usedSize > b->usedSize : a->id < b->id;
+    });
+
+    // Clears the terminal and moves the cursor home
+    std::printf("\033[H\033[2J");
+    std::printf("memarena-top - process %llu - %zu allocators", static_cast<ULLInt>(snapshot.processId), allocators.size());
+    if (snapshot.omittedCount != 0)
+    {
+        std::printf(" (%u more did not fit)", snapshot.omittedCount);
+    }
+    std::printf("\nSums of the used and total sizes count the blocks of child allocators twice\n\n");
+    std::printf("%6s %6s %-32s %12s %12s %12s %12s %10s\n", "ID", "PARENT", "NAME", "USED", "TOTAL", "PEAK", "ALLOCS/S", "LIVE");
+
+    for (const SharedAllocatorStatistics* allocator : allocators)
+    {
+        std::string rate = "-";
+        if (const auto it = previousAllocators.find(allocator->id); hasPrevious && elapsedSeconds > 0 && it != previousAllocators.end())
+        {
+            const UInt64 allocationCount = allocator->allocationCount - std::min(allocator->allocationCount, it->second->allocationCount);
+            rate                         = std::to_string(static_cast<UInt64>(static_cast<double>(allocationCount) / elapsedSeconds));
+        }
+
+        const UInt64 liveCount = allocator->allocationCount - std::min(allocator->allocationCount, allocator->deallocationCount);
+        std::printf("%6u %6u %-32.32s %12s %12s %12s %12s %10llu\n", allocator->id, allocator->parentId, allocator->debugName.data(),
+                    FormatSize(allocator->usedSize).c_str(), FormatSize(allocator->totalSize).c_str(),
+                    FormatSize(allocator->peakUsedSize).c_str(), rate.c_str(), static_cast<ULLInt>(liveCount));
+    }
+
+    std::printf("\n%6s %6s %-32s %12s %12s\n", "", "", "all", FormatSize(usedSize).c_str(), FormatSize(totalSize).c_str());
+    std::fflush(stdout);
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::fprintf(stderr, "Usage: memarena-top <pid|name> [--interval <ms>] [--count <refreshes>]\n");
+        return 1;
+    }
+
+    SharedStatisticsReader reader;
+    if (!reader.Open(options.name))
+    {
+        std::fprintf(stderr, "Nothing is published as %s\n", options.name.c_str());
+        return 1;
+    }
+
+    SharedStatisticsSnapshot snapshot;
+    SharedStatisticsSnapshot previous;
+    bool                     hasPrevious = false;
+    for (Size refresh = 0; options.count == 0 || refresh < options.count; refresh++)
+    {
+        if (refresh != 0)
+        {
+            std::this_thread::sleep_for(options.interval);
+        }
+
+        if (!reader.Read(snapshot))
+        {
+            continue;
+        }
+        // Only move the rates on once there is a new publish to measure against
+        if (!hasPrevious || snapshot.sequence != previous.sequence)
+        {
+            PrintSnapshot(snapshot, previous, hasPrevious);
+            previous    = snapshot;
+            hasPrevious = true;
+        }
+
+        // The publisher removes the memory when it stops, which leaves the mapping with the last statistics
+        SharedStatisticsReader probe;
+        if (!probe.Open(options.name))
+        {
+            std::printf("\nProcess %llu stopped publishing\n", static_cast<ULLInt>(snapshot.processId));
+            return 0;
+        }
+    }
+    return 0;
+}